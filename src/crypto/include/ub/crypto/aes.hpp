@@ -5,7 +5,12 @@
 #include <cstddef>
 
 namespace ub::crypto {
-    /** Raw (ECB) AES encryption context */
+    /**
+     * Raw (ECB) AES encryption context. Hardware AES instructions are used when the running processor has them (AES-NI
+     * on x86, ARMv8 cryptography extensions on AArch64 when built with `UB_CRYPTO_AES_ARM64=1`). Otherwise encryption
+     * is bitsliced and runs in constant time without table lookups, several blocks are encrypted in parallel at the
+     * cost of a single one.
+     */
     class aes {
     public:
         /** Create new AES context */
@@ -27,22 +32,36 @@ namespace ub::crypto {
         bool init(const uint8_t *key, size_t length);
 
         /** Encrypt a single data block in-place */
-        void encrypt(uint8_t *block);
+        void encrypt(uint8_t *block) { encryptBlocks(block, 1); }
+
+        /** Encrypt `count` consecutive data blocks in-place, up to `PARALLEL` blocks are processed at once */
+        void encryptBlocks(uint8_t *blocks, size_t count);
 
         /** Length of a single AES block */
         constexpr static uint32_t BLOCK = 16;
 
-    private:
-        constexpr static size_t WORD = 4;
+        /** Number of blocks processed in parallel by bitsliced `encryptBlocks()` and buffered in CTR mode */
+        constexpr static uint32_t PARALLEL = 4;
+
+        /** Maximum number of AES rounds */
         constexpr static size_t MAX_ROUNDS = 14;
-        static const uint8_t sBox[UINT8_MAX + 1];
 
-        uint8_t Rk[(aes::MAX_ROUNDS + 1) * aes::BLOCK];     //! AES expanded round key
-        uint8_t Nr;                                         //! Number of AES rounds
+        /**
+         * Round keys, representation depends on the backend selected at initialization: aligned 128-bit round keys
+         * in FIPS-197 byte order for hardware AES, compressed bitsliced form depending on native word size otherwise.
+         */
+        union alignas(16) round_keys_t {
+            uint8_t  u8[(MAX_ROUNDS + 1) * BLOCK];
+            uint32_t u32[(MAX_ROUNDS + 1) * BLOCK / sizeof(uint32_t)];
+            uint64_t u64[(MAX_ROUNDS + 1) * BLOCK / sizeof(uint64_t)];
+        };
+
+    private:
+        friend class aes_ctr;
+        friend class aes_gcm;
 
-        static void subShift(uint8_t *state);
-        static void mixColumns(uint8_t *state);
-        void addRoundKey(uint32_t k, uint8_t *state);
+        round_keys_t Rk;    //! AES expanded round key
+        uint8_t      Nr;    //! Number of AES rounds
     };
 
     /** AES CTR encryption and decryption context */
@@ -57,17 +76,109 @@ namespace ub::crypto {
         /** Reset AES-CTR context, clearing all sensitive data */
         void reset();
 
-        /** Initialize AES-CTR context */
-        bool init(const uint8_t *key, const uint8_t *nonce, size_t keyLength);
+        /**
+         * Initialize AES-CTR context with initial counter block `nonce`. Whole 128-bit block is incremented as a
+         * big-endian counter by default, only the last 32 bits are incremented (wrapping around) when `counter32` is
+         * set, as in GCM mode.
+         */
+        bool init(const uint8_t *key, const uint8_t *nonce, size_t keyLength, bool counter32 = false);
 
         /** Process (encrypt or decrypt) a buffer. This function could operate in-place. */
         void process(uint8_t *dst, const uint8_t *src, size_t length);
 
     private:
+        friend class aes_gcm;
+
+        constexpr static size_t STREAM = aes::PARALLEL * aes::BLOCK;
+
         aes     m_aes;
         uint8_t m_counter[aes::BLOCK];
-        uint8_t m_stream[aes::BLOCK];
+        uint8_t m_stream[STREAM];       //! Key stream of `aes::PARALLEL` consecutive blocks
         uint8_t m_streamPos;
+        bool    m_counter32;
+
+        void generate();
+    };
+
+    /**
+     * AES-GCM authenticated encryption (NIST SP 800-38D) with 96-bit nonces and 128-bit tags. GHASH uses carry-less
+     * multiplication instructions together with hardware AES, and constant-time integer multiplications otherwise.
+     * Single message must not exceed 2^36 - 32 bytes.
+     */
+    class aes_gcm {
+    public:
+        /** Length of nonce in bytes */
+        constexpr static size_t NONCE_LENGTH = 12;
+
+        /** Length of authentication tag in bytes */
+        constexpr static size_t TAG_LENGTH = 16;
+
+        /** Number of precomputed powers of the hash key, hardware GHASH aggregates that many blocks */
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+        constexpr static size_t HASH_POWERS = 8;
+#else
+        constexpr static size_t HASH_POWERS = 1;
+#endif
+
+        /** Hash key with its powers, representation depends on the backend selected at initialization */
+        union alignas(16) hash_key_t {
+            uint8_t  u8[HASH_POWERS * aes::BLOCK];
+            uint32_t u32[HASH_POWERS * aes::BLOCK / sizeof(uint32_t)];
+            uint64_t u64[HASH_POWERS * aes::BLOCK / sizeof(uint64_t)];
+        };
+
+        /** Create new empty AEAD instance */
+        explicit aes_gcm();
+
+        /** Destroy AEAD instance, erasing all sensitive data */
+        ~aes_gcm() { reset(); }
+
+        /** Reset AEAD instance, erasing all sensitive data */
+        void reset();
+
+        /**
+         * Initialize AEAD instance with key and nonce, nonce must never be reused with the same key.
+         *
+         * @param key       Key material
+         * @param keyLength Key length in bytes
+         * @param nonce     `NONCE_LENGTH` bytes long nonce
+         * @return `true` if context was initialized, `false` if key size is invalid.
+         */
+        bool init(const uint8_t *key, size_t keyLength, const uint8_t *nonce);
+
+        /**
+         * Absorb associated data, could be called several times before any message data is processed. Calls made
+         * after the first `encrypt()` or `decrypt()` call are ignored.
+         */
+        void authenticate(const uint8_t *data, size_t length);
+
+        /** Encrypt a buffer, this function could operate in-place */
+        void encrypt(uint8_t *dst, const uint8_t *src, size_t length) { process(dst, src, length, false); }
+
+        /** Decrypt a buffer, this function could operate in-place */
+        void decrypt(uint8_t *dst, const uint8_t *src, size_t length) { process(dst, src, length, true); }
+
+        /** Finish encryption and produce `TAG_LENGTH` bytes long authentication tag */
+        void finish(uint8_t *tag);
+
+        /**
+         * Finish decryption and compare authentication tag in constant time. Decrypted data must be discarded if
+         * this function returns false.
+         */
+        bool verify(const uint8_t *tag);
+
+    private:
+        aes_ctr    m_ctr;
+        hash_key_t m_hashKey;
+        uint8_t    m_hash[aes::BLOCK];      //! GHASH accumulator
+        uint8_t    m_tagMask[aes::BLOCK];   //! Encrypted initial counter block
+        uint64_t   m_adLength;
+        uint64_t   m_msgLength;
+        uint8_t    m_phase;                 //! Current processing phase (associated data or message)
+
+        void absorb(const uint8_t *data, size_t length, uint64_t &total);
+        void beginMessage();
+        void process(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt);
     };
 }
 
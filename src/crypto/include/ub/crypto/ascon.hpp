@@ -0,0 +1,174 @@
+#ifndef UB_CRYPTO_ASCON_H
+#define UB_CRYPTO_ASCON_H
+
+#include <ub/crypto/utility.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ub::crypto {
+    /** Raw Ascon-p[320] permutation and streaming sponge primitive (NIST SP 800-232) */
+    struct ascon320 {
+        // Static declarations: ----------------------------------------------------------------------------------------
+
+        /** Length of the state in bytes */
+        constexpr static size_t LENGTH = 40;
+
+        /** Maximum number of rounds of Ascon-p permutation */
+        constexpr static uint32_t ROUNDS = 12;
+
+        /**
+         * Internal state array type. Representation depends on selected permutation backend: five native 64-bit
+         * words on 64-bit hosts, bit-interleaved pairs of 32-bit words (even bits, odd bits) otherwise.
+         */
+        union state_t {
+            uint64_t u64[LENGTH / sizeof(uint64_t)];
+            uint32_t u32[LENGTH / sizeof(uint32_t)];
+        };
+
+        /** Apply Ascon-p[rounds] permutation (the last `rounds` rounds of Ascon-p[12]) to the state array */
+        static void apply(state_t &state, uint32_t rounds = ROUNDS);
+
+        // Streaming sponge primitive: ---------------------------------------------------------------------------------
+
+        state_t st;     // Current state
+        uint8_t ptr;    // Pointer to write next byte into state
+        uint8_t rate;   // Rate of this function in bytes (8 or 16)
+        uint8_t rounds; // Number of permutation rounds between rate blocks
+
+        /** Reset this object to all-zero state */
+        void reset() {
+            secureZero(st.u64, LENGTH);
+            ptr = 0;
+        }
+
+        /** Absorb more data, state is permuted every time rate block is filled */
+        void consume(const uint8_t *buf, size_t length);
+
+        /** Pad absorbed data with '1' bit and permute the state */
+        void finish();
+
+        /** Produce next chunk of output, state is permuted before the next rate block is read */
+        void produce(uint8_t *buf, size_t length);
+
+        /**
+         * Duplex encryption primitive: XOR `length` bytes from `src` with state bytes at current position into `dst`
+         * and absorb plaintext, so state bytes become ciphertext. Buffers could be the same.
+         */
+        void duplex(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt);
+
+        /** XOR 64-bit word `x` into state word `index` */
+        void xorWord(size_t index, uint64_t x);
+
+        /** @return State word `index` */
+        uint64_t word(size_t index) const;
+    };
+
+    /**
+     * Ascon-AEAD128 authenticated encryption (NIST SP 800-232) with 128-bit key, nonce and tag.
+     *
+     * Associated data must be supplied before message data, it is ignored afterwards. Either `finish()` (encryption)
+     * or `verify()` (decryption) completes the operation, both leave the instance in reset state.
+     */
+    class ascon_aead128 {
+    public:
+        /** Length of encryption key in bytes */
+        constexpr static size_t KEY_LENGTH = 16;
+
+        /** Length of nonce in bytes */
+        constexpr static size_t NONCE_LENGTH = 16;
+
+        /** Length of authentication tag in bytes */
+        constexpr static size_t TAG_LENGTH = 16;
+
+        /** Create new empty AEAD instance */
+        explicit ascon_aead128(): a {}, m_key {}, m_phase(0) {}
+
+        /** Destroy AEAD instance, erasing all sensitive data */
+        ~ascon_aead128() { reset(); }
+
+        /** Reset AEAD instance, erasing all sensitive data */
+        void reset();
+
+        /** Initialize AEAD instance with key and nonce, nonce must never be reused with the same key */
+        void init(const uint8_t *key, const uint8_t *nonce);
+
+        /**
+         * Absorb associated data, could be called several times before any message data is processed. Calls made
+         * after the first `encrypt()` or `decrypt()` call are ignored.
+         */
+        void authenticate(const uint8_t *data, size_t length);
+
+        /** Encrypt a buffer, this function could operate in-place */
+        void encrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Decrypt a buffer, this function could operate in-place */
+        void decrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Finish encryption and produce `TAG_LENGTH` bytes long authentication tag */
+        void finish(uint8_t *tag);
+
+        /**
+         * Finish decryption and compare authentication tag in constant time. Decrypted data must be discarded if
+         * this function returns false.
+         */
+        bool verify(const uint8_t *tag);
+
+    private:
+        ascon320    a;
+        uint64_t    m_key[2];
+        uint8_t     m_phase;    //! Current processing phase (associated data or message)
+
+        void beginMessage();
+    };
+
+    /** Ascon-Hash256 hash function (NIST SP 800-232) */
+    class ascon_hash256 {
+    public:
+        /** Create new empty Ascon-Hash256 context */
+        explicit ascon_hash256(): a {} { reset(); }
+
+        /** Destroy Ascon-Hash256 context, clearing all sensitive data */
+        ~ascon_hash256() { a.reset(); }
+
+        /** Reset Ascon-Hash256 context to prepare for new hashing */
+        void reset();
+
+        /** Update Ascon-Hash256 state with input data */
+        void update(const uint8_t *data, size_t length) { a.consume(data, length); }
+
+        /** Finish hashing operation, producing the final digest. Context is reset for new hashing. */
+        void finish(uint8_t *digest);
+
+        /** Length of Ascon-Hash256 output digest */
+        constexpr static size_t OUTPUT = 32;
+
+    private:
+        ascon320    a;
+    };
+
+    /** Ascon-XOF128 extendable output function (NIST SP 800-232) */
+    class ascon_xof128 {
+    public:
+        /** Create new empty Ascon-XOF128 context */
+        explicit ascon_xof128(): a {}, m_generating(false) { reset(); }
+
+        /** Destroy Ascon-XOF128 context, clearing all sensitive data */
+        ~ascon_xof128() { a.reset(); }
+
+        /** Reset Ascon-XOF128 context to prepare for new hashing */
+        void reset();
+
+        /** Update Ascon-XOF128 state with new data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Generate a next block of Ascon-XOF128 function output */
+        void generate(uint8_t *output, size_t length);
+
+    private:
+        ascon320    a;
+        bool        m_generating;
+    };
+}
+
+#endif // UB_CRYPTO_ASCON_H
@@ -0,0 +1,54 @@
+#ifndef UB_CRYPTO_BLAKE2_H
+#define UB_CRYPTO_BLAKE2_H
+
+#include <ub/crypto/utility.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ub::crypto {
+    /** BLAKE2s hash function with optional key and digest length of 1 to 32 bytes */
+    class blake2s {
+    public:
+        /** Create new empty BLAKE2s context, digest length is specified in bytes */
+        explicit blake2s(size_t digestLength = OUTPUT);
+
+        /** Destroy BLAKE2s context, clearing all sensitive data */
+        ~blake2s() { reset(); }
+
+        /**
+         * Reset BLAKE2s context to prepare for new unkeyed hashing, clearing all sensitive data.
+         * Changes digest length if length is specified.
+         */
+        void reset(size_t digestLength = 0);
+
+        /** Initialize BLAKE2s context for keyed hashing (MAC), key could be up to `KEY_LENGTH` bytes long */
+        void init(const uint8_t *key, size_t keyLength, size_t digestLength = OUTPUT);
+
+        /** Update BLAKE2s state with input data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Finish hashing operation, producing the final digest. Context is reset for new unkeyed hashing. */
+        void finish(uint8_t *digest);
+
+        /** Length of BLAKE2s internal block */
+        constexpr static size_t BLOCK = 64;
+
+        /** Maximum (and default) length of BLAKE2s output digest */
+        constexpr static size_t OUTPUT = 32;
+
+        /** Maximum length of BLAKE2s key */
+        constexpr static size_t KEY_LENGTH = 32;
+
+    private:
+        uint32_t m_state[8];
+        uint8_t  m_block[BLOCK];
+        uint64_t m_totalBytes;      //! Number of bytes compressed so far
+        uint8_t  m_used;            //! Number of bytes in block buffer, the last block is compressed in `finish()`
+        uint8_t  m_digestLength;
+
+        void compress(const uint8_t *block, uint32_t length, bool last);
+    };
+}
+
+#endif // UB_CRYPTO_BLAKE2_H
@@ -0,0 +1,85 @@
+#ifndef UB_CRYPTO_BLAKE3_H
+#define UB_CRYPTO_BLAKE3_H
+
+#include <ub/crypto/utility.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ub::crypto {
+    /**
+     * BLAKE3 hash function in hash, keyed hash and key derivation modes with extendable output. Large buffers passed
+     * to `update()` are split into subtrees of chunks, which are compressed in SIMD lanes (SSE4.1/AVX2 on x86, NEON
+     * on AArch64) by worker threads.
+     */
+    class blake3 {
+    public:
+        /** Create new BLAKE3 context in default hashing mode */
+        explicit blake3();
+
+        /** Destroy BLAKE3 context, clearing all sensitive data */
+        ~blake3() { reset(); }
+
+        /** Reset BLAKE3 context to default hashing mode, clearing all sensitive data including key */
+        void reset();
+
+        /** Initialize BLAKE3 context in keyed hashing mode with `KEY_LENGTH` bytes long key */
+        void initKeyed(const uint8_t *key);
+
+        /** Initialize BLAKE3 context in key derivation mode with context string, key material is input data */
+        void initDeriveKey(const uint8_t *context, size_t length);
+
+        /** Update BLAKE3 state with input data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Finish hashing operation, producing `OUTPUT` bytes long digest, and prepare for new input */
+        void finish(uint8_t *digest);
+
+        /**
+         * Generate a next block of BLAKE3 extendable output, the first call finishes input. Call `restart()` to
+         * hash new input in the same mode.
+         */
+        void generate(uint8_t *output, size_t length);
+
+        /** Prepare context for new input, keeping selected mode and key */
+        void restart();
+
+        /** Length of BLAKE3 default output */
+        constexpr static size_t OUTPUT = 32;
+
+        /** Length of BLAKE3 key */
+        constexpr static size_t KEY_LENGTH = 32;
+
+        /** Length of BLAKE3 block */
+        constexpr static size_t BLOCK = 64;
+
+        /** Length of BLAKE3 chunk, leaf of the hash tree */
+        constexpr static size_t CHUNK = 1024;
+
+    private:
+        constexpr static size_t MAX_DEPTH = 54;     // 2^64 bytes of input
+
+        uint32_t m_key[8];                          //! Key words (IV in default mode)
+        uint32_t m_cv[8];                           //! Chaining value of current chunk, or root input chaining value
+        uint8_t  m_block[BLOCK];                    //! Partially filled block of current chunk, or root block
+        uint8_t  m_blockLength;
+        uint8_t  m_blocks;                          //! Number of compressed blocks in current chunk
+        uint8_t  m_flags;                           //! Mode flags
+        uint8_t  m_rootFlags;                       //! Flags of root node while generating output
+        uint64_t m_chunks;                          //! Number of completed chunks
+        uint32_t m_stack[MAX_DEPTH][8];             //! Chaining values of subtrees, one per set bit of `m_chunks`
+        uint8_t  m_depth;                           //! Number of chaining values in stack
+        bool     m_generating;
+        uint64_t m_outputBlock;                     //! Counter of the next output block
+        uint8_t  m_output[BLOCK];                   //! Current output block
+        uint8_t  m_outputUsed;                      //! Number of bytes already taken from output block
+
+        void init(const uint32_t *key, uint8_t flags);
+        void compressBlock(const uint8_t *block);
+        void pushChunk();
+        void pushSubtree(const uint8_t *cv, uint32_t level);
+        void finalize();
+    };
+}
+
+#endif // UB_CRYPTO_BLAKE3_H
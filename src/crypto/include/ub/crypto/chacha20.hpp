@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <cstddef>
 
+#include <ub/crypto/poly1305.hpp>
+
 namespace ub::crypto {
     class chacha20 {
     public:
@@ -13,19 +15,40 @@ namespace ub::crypto {
         /** Length of nonce in bytes */
         constexpr static size_t NONCE_LENGTH = 12;
 
+        /** Length of nonce in bytes for the original variant with 64-bit block counter */
+        constexpr static size_t NONCE64_LENGTH = 8;
+
         /** Initialize ChaCha20 instance */
         explicit chacha20();
 
         /** Destroy ChaCha20 instance, erasing sensitive data */
         ~chacha20();
 
+        /** Reset ChaCha20 instance, erasing key and key stream */
+        void reset();
+
         /** Initialize cipher with key and nonce */
         void init(const uint8_t *key, const uint8_t *nonce);
 
         /** Initialize cipher with key and nonce as unsigned integer */
         void init(const uint8_t *key, uint64_t nonce);
 
-        /** Process (encrypt or decrypt) a buffer. This function could operate in-place. */
+        /**
+         * Initialize cipher with key and `NONCE64_LENGTH` bytes long nonce using the original variant with 64-bit block
+         * counter, which allows key streams longer than 256 GiB.
+         */
+        void init64(const uint8_t *key, const uint8_t *nonce);
+
+        /**
+         * Move to the given byte offset of the key stream, counted from the block with zero counter. With 32-bit block
+         * counter offsets wrap around every 256 GiB.
+         */
+        void seek(uint64_t offset);
+
+        /**
+         * Process (encrypt or decrypt) a buffer. This function could operate in-place. Large buffers are split between
+         * worker threads (see `setMaxThreads()`), producing the same output as sequential processing.
+         */
         void process(uint8_t *dst, const uint8_t *src, size_t length);
 
         // Low-level functions to use ChaCha20 primitive in other cryptographic constructs:
@@ -48,9 +71,68 @@ namespace ub::crypto {
         state_t  m_state;
         state_t  m_stream;
         uint8_t  m_streamPtr;
+        bool     m_counter64;   //! Block counter carries into the 13th state word
 
         void processBlock();
     };
+
+    /**
+     * ChaCha20-Poly1305 authenticated encryption (RFC 8439). Poly1305 one-time key is taken from the first ChaCha20
+     * block, message is encrypted starting from the second one.
+     */
+    class chacha20_poly1305 {
+    public:
+        /** Length of encryption key in bytes */
+        constexpr static size_t KEY_LENGTH = chacha20::KEY_LENGTH;
+
+        /** Length of nonce in bytes */
+        constexpr static size_t NONCE_LENGTH = chacha20::NONCE_LENGTH;
+
+        /** Length of authentication tag in bytes */
+        constexpr static size_t TAG_LENGTH = poly1305::TAG_LENGTH;
+
+        /** Create new empty AEAD instance */
+        explicit chacha20_poly1305();
+
+        /** Destroy AEAD instance, erasing all sensitive data */
+        ~chacha20_poly1305() { reset(); }
+
+        /** Reset AEAD instance, erasing all sensitive data */
+        void reset();
+
+        /** Initialize AEAD instance with key and nonce, nonce must never be reused with the same key */
+        void init(const uint8_t *key, const uint8_t *nonce);
+
+        /**
+         * Absorb associated data, could be called several times before any message data is processed. Calls made
+         * after the first `encrypt()` or `decrypt()` call are ignored.
+         */
+        void authenticate(const uint8_t *data, size_t length);
+
+        /** Encrypt a buffer, this function could operate in-place */
+        void encrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Decrypt a buffer, this function could operate in-place */
+        void decrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Finish encryption and produce `TAG_LENGTH` bytes long authentication tag */
+        void finish(uint8_t *tag);
+
+        /**
+         * Finish decryption and compare authentication tag in constant time. Decrypted data must be discarded if
+         * this function returns false.
+         */
+        bool verify(const uint8_t *tag);
+
+    private:
+        chacha20 m_cipher;
+        poly1305 m_mac;
+        uint64_t m_adLength;
+        uint64_t m_msgLength;
+        uint8_t  m_phase;       //! Current processing phase (associated data or message)
+
+        void beginMessage();
+    };
 }
 
 #endif // UB_CRYPTO_CHACHA20_H
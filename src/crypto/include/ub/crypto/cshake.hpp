@@ -0,0 +1,128 @@
+#ifndef UB_CRYPTO_CSHAKE_H
+#define UB_CRYPTO_CSHAKE_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include <ub/crypto/sha3.hpp>
+
+namespace ub::crypto {
+    /** cSHAKE customizable extendable output function (NIST SP 800-185) */
+    class cshake {
+    public:
+        /** Create new cSHAKE instance */
+        explicit cshake();
+
+        /** Destroy cSHAKE instance, erasing all sensitive data */
+        ~cshake() { reset(); }
+
+        /** Reset cSHAKE instance to it's default state, erasing all sensitive data */
+        void reset();
+
+        /**
+         * Initialize cSHAKE instance with function name `N` and customization string `S`. Variant is specified as
+         * either CSHAKE_128 or CSHAKE_256 static constant. When both strings are empty, cSHAKE is equal to SHAKE.
+         */
+        void init(uint32_t variant, const uint8_t *name, size_t nameLength, const uint8_t *custom, size_t customLength);
+
+        /** Update cSHAKE instance with additional data */
+        void update(const uint8_t *data, size_t length) { k.consume(data, length); }
+
+        /** Generate a next block of cSHAKE function output */
+        void generate(uint8_t *output, size_t length);
+
+        constexpr static uint32_t CSHAKE_128 = 0;
+        constexpr static uint32_t CSHAKE_256 = 1;
+
+    private:
+        keccak1600  k;
+        uint8_t     m_trailer;
+        bool        m_generating;
+    };
+
+    /** TupleHash and TupleHashXOF functions (NIST SP 800-185) hashing unambiguously encoded sequence of strings */
+    class tuplehash {
+    public:
+        /** Create new TupleHash instance */
+        explicit tuplehash();
+
+        /** Destroy TupleHash instance, erasing all sensitive data */
+        ~tuplehash() { reset(); }
+
+        /** Reset TupleHash instance to it's default state, erasing all sensitive data */
+        void reset();
+
+        /**
+         * Initialize TupleHash instance. Variant is specified as either TUPLEHASH_128 or TUPLEHASH_256 static
+         * constant. Output length is specified in bytes, zero output length selects TupleHashXOF function.
+         */
+        void init(uint32_t variant, const uint8_t *custom, size_t customLength, size_t outputLength);
+
+        /** Append next string to the tuple */
+        void add(const uint8_t *data, size_t length);
+
+        /** Finish TupleHash operation and produce output of length specified in `init()` */
+        void finish(uint8_t *output);
+
+        /** Generate a next block of TupleHashXOF output, only valid when initialized with zero output length */
+        void generate(uint8_t *output, size_t length);
+
+        constexpr static uint32_t TUPLEHASH_128 = 0;
+        constexpr static uint32_t TUPLEHASH_256 = 1;
+
+    private:
+        keccak1600  k;
+        size_t      m_outputLength;
+        bool        m_generating;
+    };
+
+    /**
+     * ParallelHash and ParallelHashXOF functions (NIST SP 800-185). Input is split into blocks of user-specified
+     * size, which are hashed independently by worker threads and SIMD lanes when large buffers are passed to
+     * `update()`.
+     */
+    class parallelhash {
+    public:
+        /** Create new ParallelHash instance */
+        explicit parallelhash();
+
+        /** Destroy ParallelHash instance, erasing all sensitive data */
+        ~parallelhash() { reset(); }
+
+        /** Reset ParallelHash instance to it's default state, erasing all sensitive data */
+        void reset();
+
+        /**
+         * Initialize ParallelHash instance. Variant is specified as either PARALLELHASH_128 or PARALLELHASH_256
+         * static constant. Block size must be non-zero, block size and output length are specified in bytes, zero
+         * output length selects ParallelHashXOF function.
+         */
+        void init(uint32_t variant, size_t blockSize, const uint8_t *custom, size_t customLength,
+                  size_t outputLength);
+
+        /** Update ParallelHash instance with additional data, ignored if instance is not initialized */
+        void update(const uint8_t *data, size_t length);
+
+        /** Finish ParallelHash operation and produce output of length specified in `init()` */
+        void finish(uint8_t *output);
+
+        /** Generate a next block of ParallelHashXOF output, only valid when initialized with zero output length */
+        void generate(uint8_t *output, size_t length);
+
+        constexpr static uint32_t PARALLELHASH_128 = 0;
+        constexpr static uint32_t PARALLELHASH_256 = 1;
+
+    private:
+        keccak1600  m_node;         //! Outer cSHAKE instance absorbing chaining values of blocks
+        keccak1600  m_leaf;         //! Partially filled block
+        size_t      m_blockSize;
+        size_t      m_used;         //! Number of bytes in partially filled block
+        uint64_t    m_blocks;       //! Number of completed blocks
+        size_t      m_outputLength;
+        bool        m_generating;
+
+        void finishLeaf();
+    };
+}
+
+#endif // UB_CRYPTO_CSHAKE_H
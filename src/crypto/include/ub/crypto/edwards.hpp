@@ -67,6 +67,27 @@ namespace ub::crypto {
          * @return          true if signature is valid
          */
         bool verifyHash(const uint8_t *key, const uint8_t *signature, const uint8_t *hash);
+
+        /**
+         * Verify a batch of messages signed with Ed25519, checking a random linear combination of signature equations
+         * at once. Large batches are split into groups verified by worker threads. If a group fails, its signatures are
+         * verified one by one to find out which ones are invalid.
+         *
+         * Every signature is accepted by cofactored equation `[8][S]B = [8]R + [8][k]A`, which is permitted by RFC 8032.
+         * The same rule applies to signatures verified one by one (small batches and groups which failed the combined
+         * check), so results do not depend on other signatures in the batch. Unlike `verify()` it accepts signatures
+         * deliberately crafted with small order components, both accept the same set of signatures produced by `sign()`.
+         *
+         * @param keys       Array of `count` Ed25519 public key buffers (of length `KEY_LENGTH`)
+         * @param signatures Array of `count` message signature buffers (of length `SIGNATURE_LENGTH`)
+         * @param messages   Array of `count` message buffers
+         * @param lengths    Array of `count` message lengths
+         * @param count      Number of signatures
+         * @param valid      Optional array of `count` flags, set to whether each signature is valid
+         * @return           true if all signatures are valid
+         */
+        bool verifyBatch(const uint8_t * const *keys, const uint8_t * const *signatures,
+                         const uint8_t * const *messages, const size_t *lengths, size_t count, bool *valid = nullptr);
     }
 
     namespace x448 {
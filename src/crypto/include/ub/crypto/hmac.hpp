@@ -5,12 +5,78 @@
 #include <cstddef>
 
 namespace ub::crypto {
+    template <typename hash>
+    class hmac;
+
+    /**
+     * Prepared HMAC key: hash states after absorbing inner and outer padded key blocks. Initializing HMAC context
+     * from prepared key copies these states instead of hashing both padded key blocks for every message.
+     */
+    template <typename hash>
+    class hmac_key {
+    public:
+        /** Create new empty prepared key */
+        explicit hmac_key() = default;
+
+        /** Destroy prepared key, clearing all sensitive data */
+        ~hmac_key() { reset(); }
+
+        /** Reset prepared key, clearing all sensitive data */
+        void reset() {
+            m_inner.reset();
+            m_outer.reset();
+        }
+
+        /** Prepare key for HMAC computations */
+        void init(const uint8_t *key, size_t length) {
+            prepare(m_inner, m_outer, key, length);
+        }
+
+    private:
+        constexpr static uint8_t O_PAD = 0x5C;
+        constexpr static uint8_t I_PAD = 0x36;
+
+        hash m_inner;
+        hash m_outer;
+
+        friend class hmac<hash>;
+
+        /** Absorb inner and outer padded key blocks into respective hash states */
+        static void prepare(hash &inner, hash &outer, const uint8_t *key, size_t length) {
+            uint8_t block[hash::BLOCK] {};
+
+            if (length > hash::BLOCK) {
+                inner.reset();
+                inner.update(key, length);
+                inner.finish(block);
+            } else {
+                memcpy(block, key, length);
+            }
+
+            for (uint8_t &k: block) {
+                k ^= I_PAD;
+            }
+
+            inner.reset();
+            inner.update(block, hash::BLOCK);
+
+            for (uint8_t &k: block) {
+                k ^= I_PAD ^ O_PAD; // undo I_PAD and apply O_PAD
+            }
+
+            outer.reset();
+            outer.update(block, hash::BLOCK);
+
+            secureZero(block, sizeof(block));
+        }
+    };
+
     /** Generic HMAC primitive over arbitrary hash function */
     template <typename hash>
     class hmac {
     public:
         /** Create new empty HMAC context */
-        explicit hmac(): m_key {} {}
+        explicit hmac() = default;
 
         /** Destroy HMAC context, clearing all sensitive data */
         ~hmac() { reset(); }
@@ -18,25 +84,18 @@ namespace ub::crypto {
         /** Reset HMAC context, clearing all sensitive data */
         void reset() {
             m_hash.reset();
-            secureZero(m_key, sizeof(m_key));
+            m_outer.reset();
         }
 
         /** Initialize HMAC context with key and prepare it to consume data */
         void init(const uint8_t *key, size_t length) {
-            memset(m_key, 0, sizeof(m_key));
-
-            if (length > hash::BLOCK) {
-                m_hash.reset();
-                m_hash.update(key, length);
-                m_hash.finish(m_key);
-            } else {
-                memcpy(m_key, key, length);
-            }
-
-            maskKey(I_PAD);
+            hmac_key<hash>::prepare(m_hash, m_outer, key, length);
+        }
 
-            m_hash.reset();
-            m_hash.update(m_key, hash::BLOCK);
+        /** Initialize HMAC context with prepared key and prepare it to consume data */
+        void init(const hmac_key<hash> &key) {
+            m_hash = key.m_inner;
+            m_outer = key.m_outer;
         }
 
         /** Update HMAC context with data */
@@ -47,30 +106,17 @@ namespace ub::crypto {
         /** Finish HMAC computation */
         void finish(uint8_t *mac) {
             m_hash.finish(mac);
-            maskKey(I_PAD ^ O_PAD); // undo I_PAD and apply O_PAD
 
-            m_hash.reset();
-            m_hash.update(m_key, hash::BLOCK);
-            m_hash.update(mac, hash::OUTPUT);
-            m_hash.finish(mac);
+            m_outer.update(mac, hash::OUTPUT);
+            m_outer.finish(mac);
         }
 
         /** HMAC output length */
         constexpr static uint32_t OUTPUT = hash::OUTPUT;
 
     private:
-        constexpr static uint8_t O_PAD = 0x5C;
-        constexpr static uint8_t I_PAD = 0x36;
-
-        hash    m_hash;
-        uint8_t m_key[hash::BLOCK];
-
-        /** XOR all key bytes with padding byte */
-        void maskKey(uint8_t pad) {
-            for (uint8_t &k: m_key) {
-                k ^= pad;
-            }
-        }
+        hash m_hash;    //! Inner hash state
+        hash m_outer;   //! Outer hash state after absorbing padded key block
     };
 }
 
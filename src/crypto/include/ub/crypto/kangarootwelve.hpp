@@ -0,0 +1,56 @@
+#ifndef UB_CRYPTO_KANGAROOTWELVE_H
+#define UB_CRYPTO_KANGAROOTWELVE_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include <ub/crypto/sha3.hpp>
+
+namespace ub::crypto {
+    /**
+     * KangarooTwelve (KT128) extensible output function. Input is split into 8 KiB chunks, all chunks except the
+     * first one are hashed as independent leaves, which are processed in parallel by worker threads and SIMD lanes
+     * when large buffers are passed to `update()`.
+     */
+    class kangarootwelve {
+    public:
+        /** Create new empty KangarooTwelve context */
+        explicit kangarootwelve();
+
+        /** Destroy KangarooTwelve context, clearing all sensitive data */
+        ~kangarootwelve() { reset(); }
+
+        /** Reset KangarooTwelve context to prepare for new hashing, clearing all sensitive data */
+        void reset();
+
+        /** Update KangarooTwelve state with new data */
+        void update(const uint8_t *data, size_t length);
+
+        /**
+         * Finish message input and append customization string. Called implicitly with empty customization string
+         * by the first `generate()` call if not called explicitly.
+         */
+        void finish(const uint8_t *customization = nullptr, size_t length = 0);
+
+        /** Generate a next block of KangarooTwelve function output */
+        void generate(uint8_t *output, size_t length);
+
+        /** Length of a single chunk */
+        constexpr static size_t CHUNK = 8192;
+
+        /** Length of chaining value of a leaf */
+        constexpr static size_t CV = 32;
+
+    private:
+        keccak1600  m_node;         //! Final node: first chunk followed by chaining values of leaves
+        keccak1600  m_leaf;         //! Partially filled leaf
+        uint64_t    m_length;       //! Number of bytes absorbed so far
+        uint64_t    m_leaves;       //! Number of completed leaves
+        bool        m_generating;
+
+        void finishLeaf();
+        void processLeaves(const uint8_t *data, size_t count);
+    };
+}
+
+#endif // UB_CRYPTO_KANGAROOTWELVE_H
@@ -0,0 +1,81 @@
+#ifndef UB_CRYPTO_KECCAK_AEAD_H
+#define UB_CRYPTO_KECCAK_AEAD_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include <ub/crypto/sha3.hpp>
+
+namespace ub::crypto {
+    /**
+     * Authenticated encryption in a single pass over the data with keyed duplex construction over 12-round
+     * Keccak-p[1600] permutation (256-bit capacity).
+     *
+     * Every duplex call processes up to `DATA_RATE` bytes followed by a trailer byte, which carries block type
+     * (key and nonce, associated data or message) and a flag marking the last block of its type, and the final '1'
+     * padding bit. Key and nonce are absorbed first, then associated data, then message bytes are XORed with the
+     * state into ciphertext while plaintext is absorbed. Tag is squeezed after the last message block.
+     *
+     * Associated data must be supplied before message data, it is ignored afterwards. Either `finish()` (encryption)
+     * or `verify()` (decryption) completes the operation, both leave the instance in reset state.
+     */
+    class keccak_aead {
+    public:
+        /** Length of encryption key in bytes */
+        constexpr static size_t KEY_LENGTH = 32;
+
+        /** Length of nonce in bytes */
+        constexpr static size_t NONCE_LENGTH = 16;
+
+        /** Length of authentication tag in bytes */
+        constexpr static size_t TAG_LENGTH = 16;
+
+        /** Number of data bytes processed by a single permutation call */
+        constexpr static size_t DATA_RATE = 167;
+
+        /** Create new empty AEAD instance */
+        explicit keccak_aead(): k {}, m_phase(0) {}
+
+        /** Destroy AEAD instance, erasing all sensitive data */
+        ~keccak_aead() { reset(); }
+
+        /** Reset AEAD instance, erasing all sensitive data */
+        void reset() {
+            k.reset();
+            m_phase = 0;
+        }
+
+        /** Initialize AEAD instance with key and nonce, nonce must never be reused with the same key */
+        void init(const uint8_t *key, const uint8_t *nonce);
+
+        /**
+         * Absorb associated data, could be called several times before any message data is processed. Calls made
+         * after message data has been encrypted or decrypted are ignored.
+         */
+        void authenticate(const uint8_t *data, size_t length);
+
+        /** Encrypt a buffer, this function could operate in-place */
+        void encrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Decrypt a buffer, this function could operate in-place */
+        void decrypt(uint8_t *dst, const uint8_t *src, size_t length);
+
+        /** Finish encryption and produce `TAG_LENGTH` bytes long authentication tag */
+        void finish(uint8_t *tag);
+
+        /**
+         * Finish decryption and compare authentication tag in constant time. Decrypted data must be discarded if
+         * this function returns false.
+         */
+        bool verify(const uint8_t *tag);
+
+    private:
+        keccak1600  k;
+        uint8_t     m_phase;    //! Type of the currently open block
+
+        void beginBlock(uint8_t phase);
+        void crypt(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt);
+    };
+}
+
+#endif // UB_CRYPTO_KECCAK_AEAD_H
@@ -7,6 +7,30 @@
 #include <ub/crypto/sha3.hpp>
 
 namespace ub::crypto {
+    /**
+     * Prepared KMAC key: Keccak state after absorbing function prefix and padded key. Initializing KMAC instance from
+     * prepared key copies this state instead of absorbing prefix and key for every message.
+     */
+    class kmac_key {
+    public:
+        /** Create new empty prepared key */
+        explicit kmac_key(): k {} {}
+
+        /** Destroy prepared key, erasing all sensitive data */
+        ~kmac_key() { reset(); }
+
+        /** Reset prepared key, erasing all sensitive data */
+        void reset() { k.reset(); }
+
+        /** Prepare key for KMAC computations, parameters have the same meaning as in `kmac::init()` */
+        void init(uint32_t variant, const uint8_t *key, size_t keyLength);
+
+    private:
+        keccak1600 k;
+
+        friend class kmac;
+    };
+
     class kmac {
     public:
         /** Create new KMAC instance */
@@ -29,6 +53,12 @@ namespace ub::crypto {
          */
         void init(uint32_t variant, const uint8_t *key, size_t keyLength, size_t macLength);
 
+        /** Initialize KMAC instance with prepared key and prepare it to consume data */
+        void init(const kmac_key &key, size_t macLength) {
+            k = key.k;
+            m_macLength = macLength;
+        }
+
         /** Update KMAC instance with additional data. */
         void update(const uint8_t *data, size_t length) { k.consume(data, length); }
 
@@ -42,6 +72,29 @@ namespace ub::crypto {
         keccak1600  k;
         size_t      m_macLength;
     };
+
+    class kmac_multi {
+    public:
+        /**
+         * Compute KMAC values of `count` independent messages with `keccak1600x4` permutation. Keys and messages could
+         * have arbitrary lengths, lanes are refilled with the next message as soon as the previous one is finished.
+         *
+         * @param variant    Function variant, `kmac::KMAC_128` or `kmac::KMAC_256`
+         * @param macs       Array of output MAC buffers (each of length `macLength`)
+         * @param macLength  MAC length in bytes
+         * @param keys       Array of keys (the same key pointer could be repeated)
+         * @param keyLengths Array of key lengths in bytes
+         * @param messages   Array of message buffers
+         * @param lengths    Array of message lengths in bytes
+         * @param count      Number of messages
+         */
+        static void compute(uint32_t variant, uint8_t * const *macs, size_t macLength, const uint8_t * const *keys,
+                            const size_t *keyLengths, const uint8_t * const *messages, const size_t *lengths,
+                            size_t count);
+
+        /** Maximum number of messages processed in parallel */
+        constexpr static size_t MAX_LANES = keccak1600x4::LANES;
+    };
 }
 
 #endif // UB_CRYPTO_KMAC_H
@@ -0,0 +1,69 @@
+#ifndef UB_CRYPTO_POLY1305_H
+#define UB_CRYPTO_POLY1305_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ub::crypto {
+    /**
+     * Poly1305 one-time authenticator (RFC 8439). Key must never be used for more than one message, see
+     * `chacha20_poly1305` for construction deriving such keys from ChaCha20.
+     *
+     * Arithmetic uses 26-bit limbs on 32-bit targets and 44-bit limbs on hosts with 128-bit integers (override with
+     * `UB_CRYPTO_POLY1305_64` definition). AVX2 processors additionally hash 4 blocks at once with powers of the key.
+     */
+    class poly1305 {
+    public:
+        /** Length of one-time key in bytes */
+        constexpr static size_t KEY_LENGTH = 32;
+
+        /** Length of authentication tag in bytes */
+        constexpr static size_t TAG_LENGTH = 16;
+
+        /** Length of message block in bytes */
+        constexpr static size_t BLOCK = 16;
+
+        /** Number of words in `state_t`: accumulator, key and pad, followed by 4 powers of the key on x86-64 */
+#if defined(__x86_64__)
+        constexpr static size_t STATE_WORDS = 36;
+#elif defined(__SIZEOF_INT128__)
+        constexpr static size_t STATE_WORDS = 16;
+#else
+        constexpr static size_t STATE_WORDS = 14;
+#endif
+
+        /** Accumulator and key, representation depends on the limb size selected at compile time */
+        union alignas(8) state_t {
+            uint32_t u32[STATE_WORDS];
+            uint64_t u64[STATE_WORDS / 2];
+        };
+
+        /** Create new empty Poly1305 instance */
+        explicit poly1305();
+
+        /** Destroy Poly1305 instance, erasing all sensitive data */
+        ~poly1305() { reset(); }
+
+        /** Reset Poly1305 instance, erasing all sensitive data */
+        void reset();
+
+        /** Initialize instance with `KEY_LENGTH` bytes long one-time key */
+        void init(const uint8_t *key);
+
+        /** Update authenticator with additional data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Pad buffered data with zeros up to the block boundary, as required by RFC 8439 AEAD construction */
+        void pad();
+
+        /** Finish computation and produce `TAG_LENGTH` bytes long authentication tag */
+        void finish(uint8_t *tag);
+
+    private:
+        state_t m_state;
+        uint8_t m_buffer[BLOCK];
+        uint8_t m_bufferPos;
+    };
+}
+
+#endif // UB_CRYPTO_POLY1305_H
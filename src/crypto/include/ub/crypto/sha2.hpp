@@ -8,6 +8,8 @@
 #include <cstring>
 
 namespace ub::crypto {
+    class sha256_multi;
+
     class sha256 {
     public:
         /** Create new empty SHA-256 context */
@@ -25,12 +27,24 @@ namespace ub::crypto {
         /** Finish hashing operation, producing the final digest */
         void finish(uint8_t *digest);
 
+        /**
+         * Export hashing midstate into `buffer` of at least `STATE_LENGTH` bytes, so hashing could be resumed later
+         * with `importState()`, possibly by another process. Returns number of bytes written.
+         */
+        size_t exportState(uint8_t *buffer) const;
+
+        /** Restore midstate written by `exportState()`. Returns false and keeps context intact if state is malformed */
+        bool importState(const uint8_t *buffer, size_t length);
+
         /** Length of SHA-256 internal block */
         constexpr static size_t BLOCK = 64;
 
         /** Length of SHA-256 output digest */
         constexpr static size_t OUTPUT = 32;
 
+        /** Maximum length of exported midstate: header, message length, chaining state and partial block */
+        constexpr static size_t STATE_LENGTH = 2 + 8 + OUTPUT + BLOCK - 1;
+
     private:
         static constexpr uint32_t W_STATE = OUTPUT / sizeof(uint32_t);
         static constexpr uint32_t W_BLOCK = BLOCK / sizeof(uint32_t);
@@ -41,9 +55,95 @@ namespace ub::crypto {
 
         uint8_t  m_block[BLOCK];
         uint32_t m_state[W_STATE];
-        uint32_t m_totalBytes;
+        uint64_t m_totalBytes;
+
+        void processBlocks(const uint8_t *data, size_t blocks);
+
+        friend class sha256_multi;
+    };
+
+    /**
+     * Multi-buffer SHA-256 engine. Hashes several independent messages at once, running each message in its own SIMD
+     * lane (8 lanes with AVX2, 4 lanes with SSE2 or generic vector code on other targets).
+     */
+    class sha256_multi {
+    public:
+        /**
+         * Compute SHA-256 digests of `count` independent messages. Messages could have arbitrary lengths, lanes are
+         * refilled with the next message as soon as the previous one is finished.
+         *
+         * @param digests  Array of output digest buffers (each of length `sha256::OUTPUT`)
+         * @param messages Array of message buffers
+         * @param lengths  Array of message lengths in bytes
+         * @param count    Number of messages
+         */
+        static void hash(uint8_t * const *digests, const uint8_t * const *messages, const size_t *lengths,
+                         size_t count);
+
+        /** Maximum number of messages processed in parallel */
+        constexpr static size_t MAX_LANES = 8;
+    };
+
+    /**
+     * SHA-256 Merkle tree hash (RFC 9162 layout): input is split into leaves of fixed size (the last leaf could be
+     * shorter), leaf digest is SHA-256(0x00 || leaf), internal node digest is SHA-256(0x01 || left || right), and the
+     * left subtree of every node is the largest perfect tree with fewer leaves than the node. Whole leaves passed to
+     * `update()` are hashed concurrently by worker threads, so large buffers (e.g. memory-mapped files) should be
+     * passed at once. Leaf size is not bound to the root, it must be authenticated along with it.
+     */
+    class sha256_tree {
+    public:
+        /** Create new empty tree hash context with given leaf size in bytes, zero leaf size is treated as one */
+        explicit sha256_tree(size_t leafSize);
+
+        /** Destroy tree hash context, clearing all sensitive data */
+        ~sha256_tree() { reset(); }
+
+        /** Reset tree hash context to prepare for new hashing, changes leaf size if specified */
+        void reset(size_t leafSize = 0);
 
-        void processBlock();
+        /** Update tree hash with input data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Finish hashing operation, producing the root digest. Root of an empty input is SHA-256 of empty string. */
+        void finish(uint8_t *root);
+
+        /** Compute digest of a single leaf */
+        static void hashLeaf(const uint8_t *leaf, size_t length, uint8_t *digest);
+
+        /**
+         * Compute digests of all leaves of `data` (`(length + leafSize - 1) / leafSize` digests) into `digests` in
+         * parallel. Leaf digests are used to build inclusion proofs. Zero leaf size is treated as one.
+         */
+        static void hashLeaves(size_t leafSize, const uint8_t *data, size_t length, uint8_t *digests);
+
+        /**
+         * Build inclusion proof of leaf `index` from digests of all `count` leaves. Returns proof length in bytes,
+         * which is at most `MAX_PROOF`.
+         */
+        static size_t buildProof(const uint8_t *digests, size_t count, size_t index, uint8_t *proof);
+
+        /**
+         * Verify that `leaf` is a leaf number `index` of a tree with `count` leaves and given `root`, using inclusion
+         * proof produced by `buildProof()`. Only the leaf itself is hashed, so it is suitable for constrained devices.
+         */
+        static bool verifyLeaf(const uint8_t *root, size_t count, size_t index, const uint8_t *leaf, size_t length,
+                               const uint8_t *proof, size_t proofLength);
+
+        /** Length of root, leaf and node digests */
+        constexpr static size_t OUTPUT = sha256::OUTPUT;
+
+        /** Maximum length of inclusion proof */
+        constexpr static size_t MAX_PROOF = sizeof(size_t) * 8 * OUTPUT;
+
+    private:
+        sha256      m_leaf;                             //! Partially filled leaf
+        size_t      m_leafSize;
+        size_t      m_used;                             //! Number of bytes in partially filled leaf
+        uint64_t    m_leaves;                           //! Number of completed leaves
+        uint8_t     m_stack[64][OUTPUT];                //! Roots of perfect subtrees, one per set bit of `m_leaves`
+
+        void pushLeaves(const uint8_t *digests, size_t count);
     };
 
     class sha512 {
@@ -63,12 +163,24 @@ namespace ub::crypto {
         /** Finish hashing operation, producing the final digest */
         void finish(uint8_t *digest);
 
+        /**
+         * Export hashing midstate into `buffer` of at least `STATE_LENGTH` bytes, so hashing could be resumed later
+         * with `importState()`, possibly by another process. Returns number of bytes written.
+         */
+        size_t exportState(uint8_t *buffer) const;
+
+        /** Restore midstate written by `exportState()`. Returns false and keeps context intact if state is malformed */
+        bool importState(const uint8_t *buffer, size_t length);
+
         /** Length of SHA-512 internal block */
         constexpr static size_t BLOCK = 128;
 
         /** Length of SHA-512 output digest */
         constexpr static size_t OUTPUT = 64;
 
+        /** Maximum length of exported midstate: header, message length, chaining state and partial block */
+        constexpr static size_t STATE_LENGTH = 2 + 8 + OUTPUT + BLOCK - 1;
+
     private:
         static constexpr uint32_t W_STATE = OUTPUT / sizeof(uint64_t);
         static constexpr uint32_t W_BLOCK = BLOCK / sizeof(uint64_t);
@@ -79,9 +191,9 @@ namespace ub::crypto {
 
         uint8_t  m_block[BLOCK];
         uint64_t m_state[W_STATE];
-        size_t   m_totalBytes;
+        uint64_t m_totalBytes;
 
-        void processBlock();
+        void processBlocks(const uint8_t *data, size_t blocks);
     };
 }
 
@@ -15,20 +15,31 @@ namespace ub::crypto {
         /** Length of the intermediate state in bytes */
         constexpr static size_t LENGTH = 200;
 
-        /** Internal state array type */
+        /** Number of rounds of Keccak-f[1600] permutation */
+        constexpr static uint32_t ROUNDS = 24;
+
+        /**
+         * Internal state array type. Layout depends on the permutation backend (native 64-bit lanes or bit-interleaved
+         * 32-bit halves), so byte and word views are for the backend only. Outside code must treat the state as opaque
+         * and access it through `consume()`, `produce()`, `duplex()` and `exportState()`/`importState()`.
+         */
         union state_t {
             uint8_t  u8[LENGTH];
             uint32_t u32[LENGTH / sizeof(uint32_t)];
         };
 
-        /** Apply Keccak block permutation to the state array */
-        static void apply(state_t &state);
+        /**
+         * Apply Keccak block permutation to the state array. Reduced-round Keccak-p[1600, n] permutation is selected
+         * with `rounds` argument, which runs the last `rounds` rounds of Keccak-f[1600].
+         */
+        static void apply(state_t &state, uint32_t rounds = ROUNDS);
 
         // Streaming Keccak1600 primitive: -----------------------------------------------------------------------------
 
-        state_t st;     // Current keccak state
+        state_t st;     // Current keccak state, opaque (see `state_t`)
         uint8_t ptr;    // Pointer to write next byte into state
         uint8_t rate;   // Rate of this function in bytes
+        uint8_t rounds; // Number of permutation rounds, zero selects full Keccak-f[1600]
 
         /** Reset this object to empty state */
         void reset() {
@@ -44,6 +55,39 @@ namespace ub::crypto {
 
         /** Produce next chunk of data from Keccak instance */
         void produce(uint8_t *buf, size_t length);
+
+        /**
+         * Duplex encryption primitive: XOR `length` bytes from `src` with state bytes at current position into `dst`
+         * and absorb plaintext (`src` when encrypting, `dst` when decrypting), so state bytes become ciphertext.
+         * Buffers could be the same, full rate blocks are permuted as in `consume()`.
+         */
+        void duplex(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt);
+
+        /** Maximum length of exported state: header, rate, rounds, pointer and state array */
+        constexpr static size_t STATE_LENGTH = 2 + 3 + LENGTH;
+
+        /**
+         * Export sponge state into `buffer` of at least `STATE_LENGTH` bytes in backend-independent form, so it could
+         * be restored later with `importState()`, possibly by another process. Returns number of bytes written.
+         */
+        size_t exportState(uint8_t *buffer) const;
+
+        /** Restore state written by `exportState()`. Returns false and keeps object intact if state is malformed */
+        bool importState(const uint8_t *buffer, size_t length);
+    };
+
+    /** Four independent Keccak 1600 states permuted at once */
+    struct keccak1600x4 {
+        /** Number of states permuted in parallel */
+        constexpr static size_t LANES = 4;
+
+        /** Internal state array type: lane `i` of state `j` is stored in `u64[i * LANES + j]` */
+        union alignas(32) state_t {
+            uint64_t u64[25 * LANES];
+        };
+
+        /** Apply Keccak block permutation to all four states, `rounds` has the same meaning as in `keccak1600` */
+        static void apply(state_t &state, uint32_t rounds = keccak1600::ROUNDS);
     };
 
     /** SHA-3 instance with arbitrary digest length */
@@ -70,6 +114,15 @@ namespace ub::crypto {
         /** Finish hashing operation, producing the final digest */
         void finish(uint8_t *digest);
 
+        /** Export hashing midstate, see `keccak1600::exportState()` */
+        size_t exportState(uint8_t *buffer) const { return k.exportState(buffer); }
+
+        /** Restore midstate written by `exportState()`, digest length is restored as well */
+        bool importState(const uint8_t *buffer, size_t length);
+
+        /** Maximum length of exported midstate */
+        constexpr static size_t STATE_LENGTH = keccak1600::STATE_LENGTH;
+
         /** Digest length for SHA3-224 variant */
         constexpr static uint32_t DIGEST_224 = 28;
 
@@ -120,6 +173,87 @@ namespace ub::crypto {
         keccak1600  k;
         bool        m_generating;
     };
+
+    /** TurboSHAKE extensible output function instance, SHAKE with 12-round Keccak-p[1600] permutation */
+    class turboshake {
+    public:
+        /**
+         * Create new empty TurboSHAKE context. Function variant must be initialized either in constructor or via
+         * `reset()` method before actual processing starts.
+         */
+        explicit turboshake(uint32_t variant = 0, uint8_t domain = DOMAIN_DEFAULT);
+
+        /** Destroy TurboSHAKE context, clearing all sensitive data */
+        ~turboshake() { reset(); }
+
+        /**
+         * Reset TurboSHAKE context to prepare for new hashing, clearing all sensitive data.
+         * Changes function variant and domain separation byte (0x01 - 0x7F) if specified.
+         */
+        void reset(uint32_t variant = 0, uint8_t domain = 0);
+
+        /** Update TurboSHAKE state with new data */
+        void update(const uint8_t *data, size_t length);
+
+        /** Generate a next block of TurboSHAKE function output */
+        void generate(uint8_t *output, size_t length);
+
+        /** Function variant for TurboSHAKE128 */
+        static constexpr uint32_t FN_TURBOSHAKE128 = 1;
+
+        /** Function variant for TurboSHAKE256 */
+        static constexpr uint32_t FN_TURBOSHAKE256 = 2;
+
+        /** Default domain separation byte */
+        static constexpr uint8_t DOMAIN_DEFAULT = 0x1F;
+
+        /** Number of Keccak-p[1600] rounds */
+        static constexpr uint32_t ROUNDS = 12;
+
+    private:
+        keccak1600  k;
+        uint8_t     m_domain;
+        bool        m_generating;
+    };
+
+    class sha3_multi {
+    public:
+        /**
+         * Compute SHA-3 digests of `count` independent messages with `keccak1600x4` permutation. Messages could have
+         * arbitrary lengths, lanes are refilled with the next message as soon as the previous one is finished.
+         *
+         * @param digestLength Digest length in bytes, same as for `sha3`
+         * @param digests      Array of output digest buffers (each of length `digestLength`)
+         * @param messages     Array of message buffers
+         * @param lengths      Array of message lengths in bytes
+         * @param count        Number of messages
+         */
+        static void hash(uint32_t digestLength, uint8_t * const *digests, const uint8_t * const *messages,
+                         const size_t *lengths, size_t count);
+
+        /** Maximum number of messages processed in parallel */
+        constexpr static size_t MAX_LANES = keccak1600x4::LANES;
+    };
+
+    class shake_multi {
+    public:
+        /**
+         * Compute SHAKE outputs of `count` independent messages with `keccak1600x4` permutation. Messages could have
+         * arbitrary lengths, lanes are refilled with the next message as soon as the previous one is finished.
+         *
+         * @param variant      Function variant, `shake::FN_SHAKE128` or `shake::FN_SHAKE256`
+         * @param outputs      Array of output buffers (each of length `outputLength`)
+         * @param outputLength Number of bytes to generate for each message
+         * @param messages     Array of message buffers
+         * @param lengths      Array of message lengths in bytes
+         * @param count        Number of messages
+         */
+        static void generate(uint32_t variant, uint8_t * const *outputs, size_t outputLength,
+                             const uint8_t * const *messages, const size_t *lengths, size_t count);
+
+        /** Maximum number of messages processed in parallel */
+        constexpr static size_t MAX_LANES = keccak1600x4::LANES;
+    };
 }
 
 #endif // UB_CRYPTO_SHA3_H
@@ -15,6 +15,12 @@ namespace ub::crypto {
      * `dst` buffer is used for `gamma` if `gamma` is null
      */
     void exclusiveOr(void *dst, const void *src, size_t length, const void *gamma = nullptr);
+
+    /**
+     * Limit number of threads used by parallel primitives (KangarooTwelve etc.), including the caller's thread.
+     * Zero selects number of hardware threads, one disables worker threads. Has no effect in builds without threads.
+     */
+    void setMaxThreads(size_t threads);
 }
 
 #endif // UB_CRYPTO_UTILITY_H
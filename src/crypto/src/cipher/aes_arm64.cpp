@@ -0,0 +1,302 @@
+#include "aes_common.hpp"
+
+#if UB_CRYPTO_AES_ARM64
+
+#include <cstring>
+
+#include <arm_neon.h>
+
+#if defined(__clang__)
+#define TARGET_AES      [[gnu::target("aes")]]
+#else
+#define TARGET_AES      [[gnu::target("+crypto")]]
+#endif
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// AESE combines AddRoundKey, SubBytes and ShiftRows, so the final AddRoundKey is a separate XOR. Multiple blocks are
+// interleaved round by round, as AESE/AESMC pairs are fused by most cores and could be issued every cycle.
+
+/** With the same word in every column ShiftRows has no effect, and AESE with zero key reduces to SubWord */
+TARGET_AES
+static uint32_t armv8_sub_word(uint32_t x) {
+    uint8x16_t r = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(x)), vdupq_n_u8(0));
+    return vgetq_lane_u32(vreinterpretq_u32_u8(r), 0);
+}
+
+static uint8_t armv8_key_schedule(aes::round_keys_t &rk, const uint8_t *key, size_t length) {
+    return aesExpandKey(rk, key, length, armv8_sub_word);
+}
+
+template <size_t N>
+TARGET_AES
+static inline void armv8_rounds(const uint8_t *k, uint32_t rounds, uint8x16_t *x) {
+    for (uint32_t r = 0; r < rounds - 1; r++) {
+        uint8x16_t rk = vld1q_u8(k + r * aes::BLOCK);
+
+#pragma GCC unroll 8
+        for (size_t i = 0; i < N; i++) {
+            x[i] = vaesmcq_u8(vaeseq_u8(x[i], rk));
+        }
+    }
+
+    uint8x16_t rk = vld1q_u8(k + (rounds - 1) * aes::BLOCK);
+    uint8x16_t rl = vld1q_u8(k + rounds * aes::BLOCK);
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        x[i] = veorq_u8(vaeseq_u8(x[i], rk), rl);
+    }
+}
+
+template <size_t N>
+TARGET_AES
+static inline void armv8_encrypt_blocks(const uint8_t *k, uint32_t rounds, uint8_t *blocks) {
+    uint8x16_t x[N];
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        x[i] = vld1q_u8(blocks + i * aes::BLOCK);
+    }
+
+    armv8_rounds<N>(k, rounds, x);
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        vst1q_u8(blocks + i * aes::BLOCK, x[i]);
+    }
+}
+
+TARGET_AES
+static void armv8_encrypt(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *blocks, size_t count) {
+    for (; count >= AES_PIPELINE_BLOCKS; count -= AES_PIPELINE_BLOCKS, blocks += AES_PIPELINE_BLOCKS * aes::BLOCK) {
+        armv8_encrypt_blocks<AES_PIPELINE_BLOCKS>(rk.u8, rounds, blocks);
+    }
+
+    for (; count != 0; count--, blocks += aes::BLOCK) {
+        armv8_encrypt_blocks<1>(rk.u8, rounds, blocks);
+    }
+}
+
+/** Fill `x` with `N` consecutive counter blocks, advancing `counter` */
+template <size_t N>
+TARGET_AES
+static inline void armv8_counters(uint8_t *counter, bool counter32, uint8x16_t *x) {
+    uint32_t low;
+    memcpy(&low, counter + 12, sizeof(low));
+    low = __builtin_bswap32(low);   // assume little-endian system
+
+    if (counter32 || low <= UINT32_MAX - N) {
+        // no carry out of the last 32 bits, counter blocks differ only in the last word
+        uint32x4_t base = vreinterpretq_u32_u8(vld1q_u8(counter));
+
+#pragma GCC unroll 8
+        for (size_t i = 0; i < N; i++) {
+            x[i] = vreinterpretq_u8_u32(vsetq_lane_u32(__builtin_bswap32(low + i), base, 3));
+        }
+
+        low = __builtin_bswap32(low + N);
+        memcpy(counter + 12, &low, sizeof(low));
+    } else {
+        for (size_t i = 0; i < N; i++) {
+            x[i] = vld1q_u8(counter);
+            aesCtrIncrement(counter, counter32);
+        }
+    }
+}
+
+/** XOR `N` key stream blocks with `src` into `dst` */
+template <size_t N>
+TARGET_AES
+static inline void armv8_xor_blocks(const uint8x16_t *x, uint8_t *dst, const uint8_t *src) {
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        vst1q_u8(dst + i * aes::BLOCK, veorq_u8(x[i], vld1q_u8(src + i * aes::BLOCK)));
+    }
+}
+
+template <size_t N>
+TARGET_AES
+static inline void armv8_ctr_blocks(const uint8_t *k, uint32_t rounds, uint8_t *counter, bool counter32,
+                                    uint8_t *dst, const uint8_t *src) {
+    uint8x16_t x[N];
+
+    armv8_counters<N>(counter, counter32, x);
+    armv8_rounds<N>(k, rounds, x);
+    armv8_xor_blocks<N>(x, dst, src);
+}
+
+TARGET_AES
+static void armv8_ctr(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *counter, bool counter32, uint8_t *dst,
+                      const uint8_t *src, size_t blocks) {
+    constexpr size_t BATCH = AES_PIPELINE_BLOCKS * aes::BLOCK;
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, dst += BATCH, src += BATCH) {
+        armv8_ctr_blocks<AES_PIPELINE_BLOCKS>(rk.u8, rounds, counter, counter32, dst, src);
+    }
+
+    for (; blocks >= aes::PARALLEL; blocks -= aes::PARALLEL) {
+        armv8_ctr_blocks<aes::PARALLEL>(rk.u8, rounds, counter, counter32, dst, src);
+        dst += aes::PARALLEL * aes::BLOCK;
+        src += aes::PARALLEL * aes::BLOCK;
+    }
+
+    for (; blocks != 0; blocks--, dst += aes::BLOCK, src += aes::BLOCK) {
+        armv8_ctr_blocks<1>(rk.u8, rounds, counter, counter32, dst, src);
+    }
+}
+
+// GHASH operates on byte-reversed blocks: bit-reflected field elements become 128-bit integers with the 64-bit lanes
+// holding big-endian halves of the block. Products of 8 blocks with powers of the hash key are accumulated unreduced,
+// then shifted by one bit and reduced modulo x^128 + x^7 + x^2 + x + 1 at once (as in BearSSL `ghash_ctmul64`).
+
+TARGET_AES
+static inline uint64x2_t ghash_load(const uint8_t *data) {
+    uint8x16_t x = vrev64q_u8(vld1q_u8(data));
+    return vreinterpretq_u64_u8(vextq_u8(x, x, 8));
+}
+
+TARGET_AES
+static inline void ghash_store(uint8_t *data, uint64x2_t x) {
+    uint8x16_t r = vrev64q_u8(vreinterpretq_u8_u64(x));
+    vst1q_u8(data, vextq_u8(r, r, 8));
+}
+
+/** Accumulate unreduced product `a * b` into `lo`, `mid` and `hi` */
+TARGET_AES
+static inline void ghash_multiply(uint64x2_t a, uint64x2_t b, uint64x2_t &lo, uint64x2_t &mid, uint64x2_t &hi) {
+    poly64_t a0 = (poly64_t) vgetq_lane_u64(a, 0), a1 = (poly64_t) vgetq_lane_u64(a, 1);
+    poly64_t b0 = (poly64_t) vgetq_lane_u64(b, 0), b1 = (poly64_t) vgetq_lane_u64(b, 1);
+
+    lo = veorq_u64(lo, vreinterpretq_u64_p128(vmull_p64(a0, b0)));
+    mid = veorq_u64(mid, vreinterpretq_u64_p128(vmull_p64(a0, b1)));
+    mid = veorq_u64(mid, vreinterpretq_u64_p128(vmull_p64(a1, b0)));
+    hi = veorq_u64(hi, vreinterpretq_u64_p128(vmull_high_p64(vreinterpretq_p64_u64(a), vreinterpretq_p64_u64(b))));
+}
+
+TARGET_AES
+static inline uint64x2_t ghash_reduce(uint64x2_t lo, uint64x2_t mid, uint64x2_t hi) {
+    const uint64x2_t zero = vdupq_n_u64(0);
+
+    lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+    // 256-bit shift left by one bit
+    uint64x2_t cl = vshrq_n_u64(lo, 63);
+    uint64x2_t ch = vshrq_n_u64(hi, 63);
+    lo = vorrq_u64(vshlq_n_u64(lo, 1), vextq_u64(zero, cl, 1));
+    hi = vorrq_u64(vshlq_n_u64(hi, 1), vextq_u64(cl, ch, 1));
+
+    // fold the lower 64-bit words one by one, the upper one absorbs what the lower fold put into it
+    uint64x2_t u = veorq_u64(veorq_u64(vshlq_n_u64(lo, 63), vshlq_n_u64(lo, 62)), vshlq_n_u64(lo, 57));
+    lo = veorq_u64(lo, vextq_u64(zero, u, 1));
+    hi = veorq_u64(hi, vextq_u64(u, zero, 1));
+
+    uint64x2_t t = veorq_u64(veorq_u64(lo, vshrq_n_u64(lo, 1)), veorq_u64(vshrq_n_u64(lo, 2), vshrq_n_u64(lo, 7)));
+    return veorq_u64(hi, t);
+}
+
+/** Absorb `N` blocks into byte-reversed accumulator `y`, `h` holds byte-reversed powers `H^1 .. H^N` */
+template <size_t N>
+TARGET_AES
+static inline uint64x2_t ghash_blocks(const uint64_t *h, uint64x2_t y, const uint8_t *data) {
+    uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        uint64x2_t x = ghash_load(data + i * aes::BLOCK);
+        if (i == 0) {
+            x = veorq_u64(x, y);
+        }
+
+        ghash_multiply(x, vld1q_u64(h + 2 * (N - 1 - i)), lo, mid, hi);
+    }
+
+    return ghash_reduce(lo, mid, hi);
+}
+
+TARGET_AES
+static void pmull_ghash_key(aes_gcm::hash_key_t &hk, const uint8_t *h) {
+    uint64x2_t h1 = ghash_load(h);
+    uint64x2_t p = h1;
+    vst1q_u64(hk.u64, p);
+
+    for (size_t i = 1; i < aes_gcm::HASH_POWERS; i++) {
+        uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+        ghash_multiply(p, h1, lo, mid, hi);
+        p = ghash_reduce(lo, mid, hi);
+        vst1q_u64(hk.u64 + 2 * i, p);
+    }
+}
+
+TARGET_AES
+static void pmull_ghash(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks) {
+    uint64x2_t acc = ghash_load(y);
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, data += AES_PIPELINE_BLOCKS * aes::BLOCK) {
+        acc = ghash_blocks<AES_PIPELINE_BLOCKS>(hk.u64, acc, data);
+    }
+
+    for (; blocks != 0; blocks--, data += aes::BLOCK) {
+        acc = ghash_blocks<1>(hk.u64, acc, data);
+    }
+
+    ghash_store(y, acc);
+}
+
+/**
+ * Stitched GCM: GHASH of one batch of ciphertext runs while AES rounds of the next batch are in flight. When
+ * encrypting, ciphertext of a batch is hashed together with the next batch.
+ */
+TARGET_AES
+static void armv8_gcm(const aes::round_keys_t &rk, uint32_t rounds, const aes_gcm::hash_key_t &hk, uint8_t *y,
+                      uint8_t *counter, uint8_t *dst, const uint8_t *src, size_t blocks, bool decrypt) {
+    constexpr size_t BATCH = AES_PIPELINE_BLOCKS * aes::BLOCK;
+
+    uint64x2_t acc = ghash_load(y);
+    const uint8_t *pending = nullptr;
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, dst += BATCH, src += BATCH) {
+        uint8x16_t x[AES_PIPELINE_BLOCKS];
+        armv8_counters<AES_PIPELINE_BLOCKS>(counter, true, x);
+        armv8_rounds<AES_PIPELINE_BLOCKS>(rk.u8, rounds, x);
+
+        const uint8_t *hashed = decrypt ? src : pending;
+        if (hashed != nullptr) {
+            acc = ghash_blocks<AES_PIPELINE_BLOCKS>(hk.u64, acc, hashed);
+        }
+
+        armv8_xor_blocks<AES_PIPELINE_BLOCKS>(x, dst, src);
+        pending = decrypt ? nullptr : dst;
+    }
+
+    if (pending != nullptr) {
+        acc = ghash_blocks<AES_PIPELINE_BLOCKS>(hk.u64, acc, pending);
+    }
+
+    for (; blocks != 0; blocks--, dst += aes::BLOCK, src += aes::BLOCK) {
+        if (decrypt) {
+            acc = ghash_blocks<1>(hk.u64, acc, src);
+        }
+
+        armv8_ctr_blocks<1>(rk.u8, rounds, counter, true, dst, src);
+
+        if (!decrypt) {
+            acc = ghash_blocks<1>(hk.u64, acc, dst);
+        }
+    }
+
+    ghash_store(y, acc);
+}
+
+const aes_backend ub::crypto::impl::aesARMv8Backend = {
+    armv8_key_schedule,
+    armv8_encrypt,
+    armv8_ctr,
+    pmull_ghash_key,
+    pmull_ghash,
+    armv8_gcm
+};
+
+#endif
@@ -0,0 +1,400 @@
+#include "aes_common.hpp"
+
+#include <ub/crypto/utility.hpp>
+
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Bitsliced state is eight words, word `i` holds bit `i` of every byte of all blocks. Words are split into four rows,
+// each row holds one column after another and every column holds the same byte of all blocks.
+
+#if UB_CRYPTO_AES64
+typedef uint64_t aes_word_t;
+#else
+typedef uint32_t aes_word_t;
+#endif
+
+static constexpr unsigned AES_WORD_BITS = sizeof(aes_word_t) * 8;
+static constexpr unsigned AES_BLOCKS = AES_BITSLICE_BLOCKS;
+
+// Compressed round key keeps only one copy of every bit instead of `AES_BLOCKS` copies
+static constexpr unsigned AES_KEY_WORDS = 8 / AES_BLOCKS;
+
+/** Lowest bit of every group of `AES_BLOCKS` bits */
+static constexpr aes_word_t AES_KEY_MASK = ~(aes_word_t) 0 / ((1U << AES_BLOCKS) - 1);
+
+static aes_word_t aes_ct_rotr(aes_word_t x, unsigned n) {
+    return (x >> n) | (x << (AES_WORD_BITS - n));
+}
+
+static void aes_ct_swap(aes_word_t &x, aes_word_t &y, aes_word_t mask, unsigned shift) {
+    aes_word_t a = x, b = y;
+    x = (a & mask) | ((b & mask) << shift);
+    y = ((a & ~mask) >> shift) | (b & ~mask);
+}
+
+/** Transpose 8x8 bit matrices formed by bytes at the same position of all eight words, this is an involution */
+static void aes_ct_ortho(aes_word_t *q) {
+    for (size_t i = 0; i < 8; i += 2) {
+        aes_ct_swap(q[i], q[i + 1], ~(aes_word_t) 0 / 3, 1);
+    }
+
+    for (size_t i = 0; i < 8; i += (i & 1) ? 3 : 1) {
+        aes_ct_swap(q[i], q[i + 2], ~(aes_word_t) 0 / 5, 2);   // pairs 0-2, 1-3, 4-6, 5-7
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        aes_ct_swap(q[i], q[i + 4], ~(aes_word_t) 0 / 17, 4);
+    }
+}
+
+#if UB_CRYPTO_AES64
+static void aes_ct_interleave_in(aes_word_t &q0, aes_word_t &q1, const uint8_t *block) {
+    uint32_t w[4];
+    std::memcpy(w, block, sizeof(w)); // assume little-endian system
+
+    uint64_t x[4];
+    for (size_t i = 0; i < 4; i++) {
+        x[i] = w[i];
+        x[i] |= x[i] << 16;
+        x[i] &= 0x0000FFFF0000FFFF;
+        x[i] |= x[i] << 8;
+        x[i] &= 0x00FF00FF00FF00FF;
+    }
+
+    q0 = x[0] | (x[2] << 8);
+    q1 = x[1] | (x[3] << 8);
+}
+
+static void aes_ct_interleave_out(uint8_t *block, aes_word_t q0, aes_word_t q1) {
+    uint64_t x[4] = {
+            q0 & 0x00FF00FF00FF00FF,
+            q1 & 0x00FF00FF00FF00FF,
+            (q0 >> 8) & 0x00FF00FF00FF00FF,
+            (q1 >> 8) & 0x00FF00FF00FF00FF
+    };
+
+    uint32_t w[4];
+    for (size_t i = 0; i < 4; i++) {
+        x[i] |= x[i] >> 8;
+        x[i] &= 0x0000FFFF0000FFFF;
+        w[i] = (uint32_t) x[i] | (uint32_t) (x[i] >> 16);
+    }
+
+    std::memcpy(block, w, sizeof(w)); // assume little-endian system
+}
+
+static void aes_ct_load(aes_word_t *q, const uint8_t *blocks) {
+    for (size_t i = 0; i < AES_BLOCKS; i++) {
+        aes_ct_interleave_in(q[i], q[i + 4], blocks + i * aes::BLOCK);
+    }
+
+    aes_ct_ortho(q);
+}
+
+static void aes_ct_store(uint8_t *blocks, aes_word_t *q) {
+    aes_ct_ortho(q);
+
+    for (size_t i = 0; i < AES_BLOCKS; i++) {
+        aes_ct_interleave_out(blocks + i * aes::BLOCK, q[i], q[i + 4]);
+    }
+}
+
+static void aes_ct_shift_rows(aes_word_t *q) {
+    for (size_t i = 0; i < 8; i++) {
+        aes_word_t x = q[i];
+        q[i] = (x & 0x000000000000FFFF)
+               | ((x & 0x00000000FFF00000) >> 4) | ((x & 0x00000000000F0000) << 12)
+               | ((x & 0x0000FF0000000000) >> 8) | ((x & 0x000000FF00000000) << 8)
+               | ((x & 0xF000000000000000) >> 12) | ((x & 0x0FFF000000000000) << 4);
+    }
+}
+#else
+static void aes_ct_load(aes_word_t *q, const uint8_t *blocks) {
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < AES_BLOCKS; j++) {
+            std::memcpy(&q[2 * i + j], blocks + j * aes::BLOCK + 4 * i, sizeof(aes_word_t)); // assume little-endian
+        }
+    }
+
+    aes_ct_ortho(q);
+}
+
+static void aes_ct_store(uint8_t *blocks, aes_word_t *q) {
+    aes_ct_ortho(q);
+
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < AES_BLOCKS; j++) {
+            std::memcpy(blocks + j * aes::BLOCK + 4 * i, &q[2 * i + j], sizeof(aes_word_t)); // assume little-endian
+        }
+    }
+}
+
+static void aes_ct_shift_rows(aes_word_t *q) {
+    for (size_t i = 0; i < 8; i++) {
+        aes_word_t x = q[i];
+        q[i] = (x & 0x000000FF)
+               | ((x & 0x0000FC00) >> 2) | ((x & 0x00000300) << 6)
+               | ((x & 0x00F00000) >> 4) | ((x & 0x000F0000) << 4)
+               | ((x & 0xC0000000) >> 6) | ((x & 0x3F000000) << 2);
+    }
+}
+#endif
+
+/** AES S-box as a boolean circuit (Boyar and Peralta, 113 gates) applied to all bytes at once */
+static void aes_ct_sbox(aes_word_t *q) {
+    aes_word_t x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // top linear transformation
+    aes_word_t y14 = x3 ^ x5;
+    aes_word_t y13 = x0 ^ x6;
+    aes_word_t y9 = x0 ^ x3;
+    aes_word_t y8 = x0 ^ x5;
+    aes_word_t t0 = x1 ^ x2;
+    aes_word_t y1 = t0 ^ x7;
+    aes_word_t y4 = y1 ^ x3;
+    aes_word_t y12 = y13 ^ y14;
+    aes_word_t y2 = y1 ^ x0;
+    aes_word_t y5 = y1 ^ x6;
+    aes_word_t y3 = y5 ^ y8;
+    aes_word_t t1 = x4 ^ y12;
+    aes_word_t y15 = t1 ^ x5;
+    aes_word_t y20 = t1 ^ x1;
+    aes_word_t y6 = y15 ^ x7;
+    aes_word_t y10 = y15 ^ t0;
+    aes_word_t y11 = y20 ^ y9;
+    aes_word_t y7 = x7 ^ y11;
+    aes_word_t y17 = y10 ^ y11;
+    aes_word_t y19 = y10 ^ y8;
+    aes_word_t y16 = t0 ^ y11;
+    aes_word_t y21 = y13 ^ y16;
+    aes_word_t y18 = x0 ^ y16;
+
+    // non-linear section
+    aes_word_t t2 = y12 & y15;
+    aes_word_t t3 = y3 & y6;
+    aes_word_t t4 = t3 ^ t2;
+    aes_word_t t5 = y4 & x7;
+    aes_word_t t6 = t5 ^ t2;
+    aes_word_t t7 = y13 & y16;
+    aes_word_t t8 = y5 & y1;
+    aes_word_t t9 = t8 ^ t7;
+    aes_word_t t10 = y2 & y7;
+    aes_word_t t11 = t10 ^ t7;
+    aes_word_t t12 = y9 & y11;
+    aes_word_t t13 = y14 & y17;
+    aes_word_t t14 = t13 ^ t12;
+    aes_word_t t15 = y8 & y10;
+    aes_word_t t16 = t15 ^ t12;
+    aes_word_t t17 = t4 ^ t14;
+    aes_word_t t18 = t6 ^ t16;
+    aes_word_t t19 = t9 ^ t14;
+    aes_word_t t20 = t11 ^ t16;
+    aes_word_t t21 = t17 ^ y20;
+    aes_word_t t22 = t18 ^ y19;
+    aes_word_t t23 = t19 ^ y21;
+    aes_word_t t24 = t20 ^ y18;
+
+    aes_word_t t25 = t21 ^ t22;
+    aes_word_t t26 = t21 & t23;
+    aes_word_t t27 = t24 ^ t26;
+    aes_word_t t28 = t25 & t27;
+    aes_word_t t29 = t28 ^ t22;
+    aes_word_t t30 = t23 ^ t24;
+    aes_word_t t31 = t22 ^ t26;
+    aes_word_t t32 = t31 & t30;
+    aes_word_t t33 = t32 ^ t24;
+    aes_word_t t34 = t23 ^ t33;
+    aes_word_t t35 = t27 ^ t33;
+    aes_word_t t36 = t24 & t35;
+    aes_word_t t37 = t36 ^ t34;
+    aes_word_t t38 = t27 ^ t36;
+    aes_word_t t39 = t29 & t38;
+    aes_word_t t40 = t25 ^ t39;
+
+    aes_word_t t41 = t40 ^ t37;
+    aes_word_t t42 = t29 ^ t33;
+    aes_word_t t43 = t29 ^ t40;
+    aes_word_t t44 = t33 ^ t37;
+    aes_word_t t45 = t42 ^ t41;
+    aes_word_t z0 = t44 & y15;
+    aes_word_t z1 = t37 & y6;
+    aes_word_t z2 = t33 & x7;
+    aes_word_t z3 = t43 & y16;
+    aes_word_t z4 = t40 & y1;
+    aes_word_t z5 = t29 & y7;
+    aes_word_t z6 = t42 & y11;
+    aes_word_t z7 = t45 & y17;
+    aes_word_t z8 = t41 & y10;
+    aes_word_t z9 = t44 & y12;
+    aes_word_t z10 = t37 & y3;
+    aes_word_t z11 = t33 & y4;
+    aes_word_t z12 = t43 & y13;
+    aes_word_t z13 = t40 & y5;
+    aes_word_t z14 = t29 & y2;
+    aes_word_t z15 = t42 & y9;
+    aes_word_t z16 = t45 & y14;
+    aes_word_t z17 = t41 & y8;
+
+    // bottom linear transformation
+    aes_word_t t46 = z15 ^ z16;
+    aes_word_t t47 = z10 ^ z11;
+    aes_word_t t48 = z5 ^ z13;
+    aes_word_t t49 = z9 ^ z10;
+    aes_word_t t50 = z2 ^ z12;
+    aes_word_t t51 = z2 ^ z5;
+    aes_word_t t52 = z7 ^ z8;
+    aes_word_t t53 = z0 ^ z3;
+    aes_word_t t54 = z6 ^ z7;
+    aes_word_t t55 = z16 ^ z17;
+    aes_word_t t56 = z12 ^ t48;
+    aes_word_t t57 = t50 ^ t53;
+    aes_word_t t58 = z4 ^ t46;
+    aes_word_t t59 = z3 ^ t54;
+    aes_word_t t60 = t46 ^ t57;
+    aes_word_t t61 = z14 ^ t57;
+    aes_word_t t62 = t52 ^ t58;
+    aes_word_t t63 = t49 ^ t58;
+    aes_word_t t64 = z4 ^ t59;
+    aes_word_t t65 = t61 ^ t62;
+    aes_word_t t66 = z1 ^ t63;
+    aes_word_t s0 = t59 ^ t63;
+    aes_word_t s6 = t56 ^ ~t62;
+    aes_word_t s7 = t48 ^ ~t60;
+    aes_word_t t67 = t64 ^ t65;
+    aes_word_t s3 = t53 ^ t66;
+    aes_word_t s4 = t51 ^ t66;
+    aes_word_t s5 = t47 ^ t65;
+    aes_word_t s1 = t64 ^ ~s3;
+    aes_word_t s2 = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+static void aes_ct_mix_columns(aes_word_t *q) {
+    constexpr unsigned ROW = AES_WORD_BITS / 4;
+
+    aes_word_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    aes_word_t r0 = aes_ct_rotr(q0, ROW), r1 = aes_ct_rotr(q1, ROW), r2 = aes_ct_rotr(q2, ROW);
+    aes_word_t r3 = aes_ct_rotr(q3, ROW), r4 = aes_ct_rotr(q4, ROW), r5 = aes_ct_rotr(q5, ROW);
+    aes_word_t r6 = aes_ct_rotr(q6, ROW), r7 = aes_ct_rotr(q7, ROW);
+
+    q[0] = q7 ^ r7 ^ r0 ^ aes_ct_rotr(q0 ^ r0, 2 * ROW);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ aes_ct_rotr(q1 ^ r1, 2 * ROW);
+    q[2] = q1 ^ r1 ^ r2 ^ aes_ct_rotr(q2 ^ r2, 2 * ROW);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ aes_ct_rotr(q3 ^ r3, 2 * ROW);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ aes_ct_rotr(q4 ^ r4, 2 * ROW);
+    q[5] = q4 ^ r4 ^ r5 ^ aes_ct_rotr(q5 ^ r5, 2 * ROW);
+    q[6] = q5 ^ r5 ^ r6 ^ aes_ct_rotr(q6 ^ r6, 2 * ROW);
+    q[7] = q6 ^ r6 ^ r7 ^ aes_ct_rotr(q7 ^ r7, 2 * ROW);
+}
+
+/** Expand compressed round key on the fly and add it to the state */
+static void aes_ct_add_round_key(aes_word_t *q, const aes_word_t *rk) {
+    for (size_t i = 0; i < AES_KEY_WORDS; i++) {
+        for (size_t j = 0; j < AES_BLOCKS; j++) {
+            aes_word_t x = (rk[i] >> j) & AES_KEY_MASK;
+            q[i * AES_BLOCKS + j] ^= (x << AES_BLOCKS) - x;
+        }
+    }
+}
+
+static aes_word_t *aes_ct_keys(aes::round_keys_t &rk) {
+#if UB_CRYPTO_AES64
+    return rk.u64;
+#else
+    return rk.u32;
+#endif
+}
+
+static const aes_word_t *aes_ct_keys(const aes::round_keys_t &rk) {
+    return aes_ct_keys(const_cast<aes::round_keys_t &>(rk));
+}
+
+/** SubWord() of key schedule, computed with the same circuit to avoid table lookups */
+static uint32_t aes_ct_sub_word(uint32_t x) {
+    aes_word_t q[8] = { x };
+
+    aes_ct_ortho(q);
+    aes_ct_sbox(q);
+    aes_ct_ortho(q);
+
+    return (uint32_t) q[0];
+}
+
+uint8_t ub::crypto::impl::aesBitsliceKeySchedule(aes::round_keys_t &rk, const uint8_t *key, size_t length) {
+    constexpr size_t MAX_WORDS = (aes::MAX_ROUNDS + 1) * 4;
+
+    uint32_t w[MAX_WORDS];
+    size_t Nk = length >> 2;
+    size_t Nr = 6 + Nk;
+    size_t Nw = (Nr + 1) * 4;
+
+    std::memcpy(w, key, length); // assume little-endian system
+
+    uint32_t rc = 0x01;
+    for (size_t i = Nk; i < Nw; i++) {
+        uint32_t t = w[i - 1];
+        size_t iN = i % Nk;
+
+        if (iN == 0) {
+            t = aes_ct_sub_word((t >> 8) | (t << 24)) ^ rc;
+            rc = ((rc << 1) ^ (0x1B & -(rc >> 7))) & 0xFF;
+        } else if (Nk > 6 && iN == 4) {
+            t = aes_ct_sub_word(t);
+        }
+
+        w[i] = w[i - Nk] ^ t;
+    }
+
+    // every round key is loaded into all blocks of the state, then a single copy of each bit is kept
+    aes_word_t *dst = aes_ct_keys(rk);
+    uint8_t blocks[AES_BLOCKS * aes::BLOCK];
+    aes_word_t q[8];
+
+    for (size_t r = 0; r <= Nr; r++) {
+        for (size_t j = 0; j < AES_BLOCKS; j++) {
+            std::memcpy(blocks + j * aes::BLOCK, w + 4 * r, aes::BLOCK);
+        }
+
+        aes_ct_load(q, blocks);
+
+        for (size_t i = 0; i < AES_KEY_WORDS; i++, dst++) {
+            *dst = 0;
+
+            for (size_t j = 0; j < AES_BLOCKS; j++) {
+                *dst |= q[i * AES_BLOCKS + j] & (AES_KEY_MASK << j);
+            }
+        }
+    }
+
+    secureZero(w, sizeof(w));
+    secureZero(blocks, sizeof(blocks));
+    secureZero(q, sizeof(q));
+
+    return Nr;
+}
+
+void ub::crypto::impl::aesBitsliceEncrypt(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *blocks) {
+    const aes_word_t *k = aes_ct_keys(rk);
+    aes_word_t q[8];
+
+    aes_ct_load(q, blocks);
+    aes_ct_add_round_key(q, k);
+
+    for (uint32_t i = 1; i < rounds; i++) {
+        aes_ct_sbox(q);
+        aes_ct_shift_rows(q);
+        aes_ct_mix_columns(q);
+        aes_ct_add_round_key(q, k + i * AES_KEY_WORDS);
+    }
+
+    aes_ct_sbox(q);
+    aes_ct_shift_rows(q);
+    aes_ct_add_round_key(q, k + rounds * AES_KEY_WORDS);
+
+    aes_ct_store(blocks, q);
+}
@@ -0,0 +1,119 @@
+#ifndef UB_SRC_CRYPTO_CIPHER_AES_COMMON_H
+#define UB_SRC_CRYPTO_CIPHER_AES_COMMON_H
+
+#include <ub/crypto/aes.hpp>
+
+#include "../cpu.hpp"
+
+// Bitsliced AES backend: 64-bit words holding four blocks on 64-bit hosts, 32-bit words holding two blocks otherwise.
+// Can be overridden by defining UB_CRYPTO_AES64 to 0 or 1. Representation of `aes::round_keys_t` depends on selected
+// backend.
+#if !defined(UB_CRYPTO_AES64)
+#define UB_CRYPTO_AES64             (__SIZEOF_POINTER__ >= 8)
+#endif
+
+// ARMv8 AES and PMULL backend has not been verified on AArch64 hardware yet, so it is built and selected only when
+// UB_CRYPTO_AES_ARM64 is defined to 1
+#if !defined(UB_CRYPTO_AES_ARM64) || !UB_CRYPTO_ARM64
+#undef UB_CRYPTO_AES_ARM64
+#define UB_CRYPTO_AES_ARM64         0
+#endif
+
+// Runtime selection of AES backend is available only on targets with hardware AES instructions
+#if UB_CRYPTO_X86 || UB_CRYPTO_AES_ARM64
+#define UB_CRYPTO_AES_DISPATCH 1
+#else
+#define UB_CRYPTO_AES_DISPATCH 0
+#endif
+
+namespace ub::crypto::impl {
+    /** Number of blocks encrypted by a single `aesBitsliceEncrypt()` call */
+    constexpr size_t AES_BITSLICE_BLOCKS = UB_CRYPTO_AES64 ? 4 : 2;
+
+    /** Number of blocks interleaved by hardware backends to hide latency of AES round instructions */
+    constexpr size_t AES_PIPELINE_BLOCKS = 8;
+
+    /** AES implementation. Round keys produced by `keySchedule` are meaningful only for the same backend. */
+    struct aes_backend {
+        /** Expand AES key into round keys. Key length must be valid. Returns number of AES rounds. */
+        uint8_t (*keySchedule)(aes::round_keys_t &rk, const uint8_t *key, size_t length);
+
+        /** Encrypt `count` consecutive blocks in-place */
+        void (*encrypt)(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *blocks, size_t count);
+
+        /**
+         * Process `blocks` whole blocks in CTR mode starting with counter block `counter`, which is advanced past the
+         * last used value. See `aesCtrIncrement()` for the meaning of `counter32`.
+         */
+        void (*ctr)(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *counter, bool counter32, uint8_t *dst,
+                    const uint8_t *src, size_t blocks);
+
+        /** Derive GHASH key from hash subkey `h = E(K, 0)` */
+        void (*ghashKey)(aes_gcm::hash_key_t &hk, const uint8_t *h);
+
+        /** Update GHASH accumulator `y` with `blocks` whole blocks */
+        void (*ghash)(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks);
+
+        /**
+         * Process `blocks` whole blocks in GCM mode: CTR with 32-bit `counter` combined with GHASH of the ciphertext
+         * (`src` when decrypting, `dst` when encrypting) into accumulator `y`.
+         */
+        void (*gcm)(const aes::round_keys_t &rk, uint32_t rounds, const aes_gcm::hash_key_t &hk, uint8_t *y,
+                    uint8_t *counter, uint8_t *dst, const uint8_t *src, size_t blocks, bool decrypt);
+    };
+
+    /**
+     * Expand AES key into round keys. Key length must be valid.
+     *
+     * @return Number of AES rounds
+     */
+    uint8_t aesBitsliceKeySchedule(aes::round_keys_t &rk, const uint8_t *key, size_t length);
+
+    /** Encrypt `AES_BITSLICE_BLOCKS` consecutive blocks in-place in constant time */
+    void aesBitsliceEncrypt(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *blocks);
+
+    /**
+     * Expand AES key into FIPS-197 round keys (first round key is the key itself) using given constant-time `SubWord`
+     * implementation. Words are loaded from key material as little-endian. Key length must be valid.
+     *
+     * @return Number of AES rounds
+     */
+    uint8_t aesExpandKey(aes::round_keys_t &rk, const uint8_t *key, size_t length, uint32_t (*subWord)(uint32_t));
+
+    /**
+     * Increment big-endian counter block. Carry out of the last 32 bits propagates into the rest of the block unless
+     * `counter32` is set (GCM-style counter).
+     */
+    void aesCtrIncrement(uint8_t *counter, bool counter32);
+
+    /** Derive GHASH key for `ghashPortable()` */
+    void ghashKeyPortable(aes_gcm::hash_key_t &hk, const uint8_t *h);
+
+    /** GHASH with constant-time integer multiplications, 64-bit or 32-bit depending on `UB_CRYPTO_AES64` */
+    void ghashPortable(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks);
+
+    /** Portable bitsliced backend */
+    extern const aes_backend aesBitsliceBackend;
+
+#if UB_CRYPTO_X86
+    /** Backend using x86 AES-NI instructions */
+    extern const aes_backend aesNIBackend;
+#endif
+
+#if UB_CRYPTO_AES_ARM64
+    /** Backend using ARMv8 AES instructions */
+    extern const aes_backend aesARMv8Backend;
+#endif
+
+#if UB_CRYPTO_AES_DISPATCH
+    /** AES backend selected for the running processor */
+    const aes_backend &aesBackend();
+
+    /** Forget selected backend, so it is selected again on next use (see `cpuRestrictFeatures()`) */
+    void aesResetBackends();
+#else
+    inline const aes_backend &aesBackend() { return aesBitsliceBackend; }
+#endif
+}
+
+#endif // UB_SRC_CRYPTO_CIPHER_AES_COMMON_H
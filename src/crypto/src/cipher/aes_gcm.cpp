@@ -0,0 +1,177 @@
+#include <ub/crypto/aes.hpp>
+#include <ub/crypto/utility.hpp>
+
+#include "aes_common.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Processing phases
+static constexpr uint8_t AES_GCM_AD     = 0;
+static constexpr uint8_t AES_GCM_MSG    = 1;
+
+static const uint8_t aes_gcm_zero[aes::BLOCK] = {};
+
+aes_gcm::aes_gcm(): m_hashKey {}, m_hash {}, m_tagMask {} {
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = AES_GCM_AD;
+}
+
+void aes_gcm::reset() {
+    m_ctr.reset();
+    secureZero(&m_hashKey, sizeof(m_hashKey));
+    secureZero(m_hash, sizeof(m_hash));
+    secureZero(m_tagMask, sizeof(m_tagMask));
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = AES_GCM_AD;
+}
+
+bool aes_gcm::init(const uint8_t *key, size_t keyLength, const uint8_t *nonce) {
+    // pre-counter block J0 = nonce || 1, message is encrypted starting from J0 + 1
+    uint8_t counter[aes::BLOCK];
+    std::memcpy(counter, nonce, NONCE_LENGTH);
+    counter[12] = counter[13] = counter[14] = 0;
+    counter[15] = 2;
+
+    if (!m_ctr.init(key, counter, keyLength, true)) {
+        return false;
+    }
+
+    const aes_backend &b = aesBackend();
+
+    uint8_t h[aes::BLOCK] = {};
+    m_ctr.m_aes.encrypt(h);
+    b.ghashKey(m_hashKey, h);
+    secureZero(h, sizeof(h));
+
+    counter[15] = 1;
+    std::memcpy(m_tagMask, counter, sizeof(m_tagMask));
+    m_ctr.m_aes.encrypt(m_tagMask);
+
+    std::memset(m_hash, 0, sizeof(m_hash));
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = AES_GCM_AD;
+    return true;
+}
+
+/** XOR data into GHASH accumulator, multiplying it by the hash key on every completed block */
+void aes_gcm::absorb(const uint8_t *data, size_t length, uint64_t &total) {
+    const aes_backend &b = aesBackend();
+
+    while (length != 0) {
+        size_t pos = total % aes::BLOCK;
+
+        if (pos == 0 && length >= aes::BLOCK) {
+            size_t blocks = length / aes::BLOCK;
+            b.ghash(m_hashKey, m_hash, data, blocks);
+
+            data += blocks * aes::BLOCK;
+            length -= blocks * aes::BLOCK;
+            total += blocks * aes::BLOCK;
+            continue;
+        }
+
+        size_t len = std::min(length, aes::BLOCK - pos);
+        exclusiveOr(m_hash + pos, data, len);
+
+        data += len;
+        length -= len;
+        total += len;
+
+        if (pos + len == aes::BLOCK) {
+            b.ghash(m_hashKey, m_hash, aes_gcm_zero, 1);
+        }
+    }
+}
+
+void aes_gcm::authenticate(const uint8_t *data, size_t length) {
+    // associated data could not follow message data
+    if (m_phase == AES_GCM_MSG) {
+        return;
+    }
+
+    absorb(data, length, m_adLength);
+}
+
+void aes_gcm::beginMessage() {
+    if (m_phase == AES_GCM_MSG) {
+        return;
+    }
+
+    // partial block of associated data is padded with zeros
+    if (m_adLength % aes::BLOCK != 0) {
+        aesBackend().ghash(m_hashKey, m_hash, aes_gcm_zero, 1);
+    }
+
+    m_phase = AES_GCM_MSG;
+}
+
+void aes_gcm::process(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt) {
+    beginMessage();
+
+    while (length != 0) {
+        size_t pos = m_msgLength % aes_ctr::STREAM;
+
+        if (pos == 0 && length >= aes_ctr::STREAM) {
+            // key stream buffer is empty, so whole multiples of it are processed by stitched CTR and GHASH
+            size_t blocks = length / aes_ctr::STREAM * aes::PARALLEL;
+            aesBackend().gcm(m_ctr.m_aes.Rk, m_ctr.m_aes.Nr, m_hashKey, m_hash, m_ctr.m_counter, dst, src, blocks,
+                             decrypt);
+
+            dst += blocks * aes::BLOCK;
+            src += blocks * aes::BLOCK;
+            length -= blocks * aes::BLOCK;
+            m_msgLength += blocks * aes::BLOCK;
+            continue;
+        }
+
+        size_t len = std::min(length, aes_ctr::STREAM - pos);
+        uint64_t total = m_msgLength;
+
+        // GHASH is computed over ciphertext, which could be overwritten when operating in-place
+        if (decrypt) {
+            absorb(src, len, total);
+            m_ctr.process(dst, src, len);
+        } else {
+            m_ctr.process(dst, src, len);
+            absorb(dst, len, total);
+        }
+
+        dst += len;
+        src += len;
+        length -= len;
+        m_msgLength = total;
+    }
+}
+
+void aes_gcm::finish(uint8_t *tag) {
+    beginMessage();
+
+    const aes_backend &b = aesBackend();
+    if (m_msgLength % aes::BLOCK != 0) {
+        b.ghash(m_hashKey, m_hash, aes_gcm_zero, 1);
+    }
+
+    // lengths block: bit lengths of associated data and ciphertext as big-endian numbers, assume little-endian system
+    uint64_t lengths[2] = { __builtin_bswap64(m_adLength << 3), __builtin_bswap64(m_msgLength << 3) };
+    b.ghash(m_hashKey, m_hash, (const uint8_t *) lengths, 1);
+
+    exclusiveOr(tag, m_hash, TAG_LENGTH, m_tagMask);
+    reset();
+}
+
+bool aes_gcm::verify(const uint8_t *tag) {
+    uint8_t expected[TAG_LENGTH];
+    finish(expected);
+
+    bool valid = secureCompare(expected, tag, TAG_LENGTH);
+    secureZero(expected, sizeof(expected));
+
+    return valid;
+}
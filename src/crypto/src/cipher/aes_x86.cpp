@@ -0,0 +1,295 @@
+#include "aes_common.hpp"
+
+#if UB_CRYPTO_X86
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#define TARGET_AES [[gnu::target("aes,pclmul,ssse3,sse4.1")]]
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Round keys are stored in FIPS-197 byte order, which is directly usable by AESENC. Multiple blocks are interleaved
+// round by round: AESENC has latency of several cycles, but could be issued every cycle for independent blocks.
+
+/** `AESKEYGENASSIST` computes SubWord of the second dword into the lowest one */
+TARGET_AES
+static uint32_t aesni_sub_word(uint32_t x) {
+    __m128i r = _mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, (int) x, 0), 0);
+    return (uint32_t) _mm_cvtsi128_si32(r);
+}
+
+static uint8_t aesni_key_schedule(aes::round_keys_t &rk, const uint8_t *key, size_t length) {
+    return aesExpandKey(rk, key, length, aesni_sub_word);
+}
+
+template <size_t N>
+TARGET_AES
+static inline void aesni_rounds(const __m128i *k, uint32_t rounds, __m128i *x) {
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        x[i] = _mm_xor_si128(x[i], k[0]);
+    }
+
+    for (uint32_t r = 1; r < rounds; r++) {
+        __m128i rk = k[r];
+
+#pragma GCC unroll 8
+        for (size_t i = 0; i < N; i++) {
+            x[i] = _mm_aesenc_si128(x[i], rk);
+        }
+    }
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        x[i] = _mm_aesenclast_si128(x[i], k[rounds]);
+    }
+}
+
+template <size_t N>
+TARGET_AES
+static inline void aesni_encrypt_blocks(const __m128i *k, uint32_t rounds, uint8_t *blocks) {
+    __m128i x[N];
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        x[i] = _mm_loadu_si128((const __m128i *) (blocks + i * aes::BLOCK));
+    }
+
+    aesni_rounds<N>(k, rounds, x);
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        _mm_storeu_si128((__m128i *) (blocks + i * aes::BLOCK), x[i]);
+    }
+}
+
+TARGET_AES
+static void aesni_encrypt(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *blocks, size_t count) {
+    const __m128i *k = (const __m128i *) rk.u8;
+
+    for (; count >= AES_PIPELINE_BLOCKS; count -= AES_PIPELINE_BLOCKS, blocks += AES_PIPELINE_BLOCKS * aes::BLOCK) {
+        aesni_encrypt_blocks<AES_PIPELINE_BLOCKS>(k, rounds, blocks);
+    }
+
+    for (; count != 0; count--, blocks += aes::BLOCK) {
+        aesni_encrypt_blocks<1>(k, rounds, blocks);
+    }
+}
+
+/** Fill `x` with `N` consecutive counter blocks, advancing `counter` */
+template <size_t N>
+TARGET_AES
+static inline void aesni_counters(uint8_t *counter, bool counter32, __m128i *x) {
+    uint32_t low;
+    memcpy(&low, counter + 12, sizeof(low));
+    low = __builtin_bswap32(low);   // assume little-endian system
+
+    if (counter32 || low <= UINT32_MAX - N) {
+        // no carry out of the last 32 bits, counter blocks differ only in the last dword
+        __m128i base = _mm_loadu_si128((const __m128i *) counter);
+
+#pragma GCC unroll 8
+        for (size_t i = 0; i < N; i++) {
+            x[i] = _mm_insert_epi32(base, (int) __builtin_bswap32(low + i), 3);
+        }
+
+        low = __builtin_bswap32(low + N);
+        memcpy(counter + 12, &low, sizeof(low));
+    } else {
+        for (size_t i = 0; i < N; i++) {
+            x[i] = _mm_loadu_si128((const __m128i *) counter);
+            aesCtrIncrement(counter, counter32);
+        }
+    }
+}
+
+/** XOR `N` key stream blocks with `src` into `dst` */
+template <size_t N>
+TARGET_AES
+static inline void aesni_xor_blocks(const __m128i *x, uint8_t *dst, const uint8_t *src) {
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        __m128i m = _mm_loadu_si128((const __m128i *) (src + i * aes::BLOCK));
+        _mm_storeu_si128((__m128i *) (dst + i * aes::BLOCK), _mm_xor_si128(x[i], m));
+    }
+}
+
+template <size_t N>
+TARGET_AES
+static inline void aesni_ctr_blocks(const __m128i *k, uint32_t rounds, uint8_t *counter, bool counter32,
+                                    uint8_t *dst, const uint8_t *src) {
+    __m128i x[N];
+
+    aesni_counters<N>(counter, counter32, x);
+    aesni_rounds<N>(k, rounds, x);
+    aesni_xor_blocks<N>(x, dst, src);
+}
+
+TARGET_AES
+static void aesni_ctr(const aes::round_keys_t &rk, uint32_t rounds, uint8_t *counter, bool counter32, uint8_t *dst,
+                      const uint8_t *src, size_t blocks) {
+    const __m128i *k = (const __m128i *) rk.u8;
+    constexpr size_t BATCH = AES_PIPELINE_BLOCKS * aes::BLOCK;
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, dst += BATCH, src += BATCH) {
+        aesni_ctr_blocks<AES_PIPELINE_BLOCKS>(k, rounds, counter, counter32, dst, src);
+    }
+
+    for (; blocks >= aes::PARALLEL; blocks -= aes::PARALLEL) {
+        aesni_ctr_blocks<aes::PARALLEL>(k, rounds, counter, counter32, dst, src);
+        dst += aes::PARALLEL * aes::BLOCK;
+        src += aes::PARALLEL * aes::BLOCK;
+    }
+
+    for (; blocks != 0; blocks--, dst += aes::BLOCK, src += aes::BLOCK) {
+        aesni_ctr_blocks<1>(k, rounds, counter, counter32, dst, src);
+    }
+}
+
+// GHASH operates on byte-reversed blocks: bit-reflected field elements become 128-bit integers with the 64-bit lanes
+// holding big-endian halves of the block. Products of 8 blocks with powers of the hash key are accumulated unreduced,
+// then shifted by one bit and reduced modulo x^128 + x^7 + x^2 + x + 1 at once (as in BearSSL `ghash_ctmul64`).
+
+TARGET_AES
+static inline __m128i ghash_reverse(__m128i x) {
+    return _mm_shuffle_epi8(x, _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL));
+}
+
+/** Accumulate unreduced product `a * b` into `lo`, `mid` and `hi` */
+TARGET_AES
+static inline void ghash_multiply(__m128i a, __m128i b, __m128i &lo, __m128i &mid, __m128i &hi) {
+    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x01));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x10));
+    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+}
+
+TARGET_AES
+static inline __m128i ghash_reduce(__m128i lo, __m128i mid, __m128i hi) {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // 256-bit shift left by one bit
+    __m128i cl = _mm_srli_epi64(lo, 63);
+    __m128i ch = _mm_srli_epi64(hi, 63);
+    lo = _mm_or_si128(_mm_slli_epi64(lo, 1), _mm_slli_si128(cl, 8));
+    hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi64(hi, 1), _mm_srli_si128(cl, 8)), _mm_slli_si128(ch, 8));
+
+    // fold the lower 64-bit words one by one, the upper one absorbs what the lower fold put into it
+    __m128i u = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi64(lo, 63), _mm_slli_epi64(lo, 62)), _mm_slli_epi64(lo, 57));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(u, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(u, 8));
+
+    __m128i t = _mm_xor_si128(_mm_xor_si128(lo, _mm_srli_epi64(lo, 1)), _mm_xor_si128(_mm_srli_epi64(lo, 2),
+                                                                                    _mm_srli_epi64(lo, 7)));
+    return _mm_xor_si128(hi, t);
+}
+
+/** Absorb `N` blocks into byte-reversed accumulator `y`, `h` holds byte-reversed powers `H^1 .. H^N` */
+template <size_t N>
+TARGET_AES
+static inline __m128i ghash_blocks(const __m128i *h, __m128i y, const uint8_t *data) {
+    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+
+#pragma GCC unroll 8
+    for (size_t i = 0; i < N; i++) {
+        __m128i x = ghash_reverse(_mm_loadu_si128((const __m128i *) (data + i * aes::BLOCK)));
+        if (i == 0) {
+            x = _mm_xor_si128(x, y);
+        }
+
+        ghash_multiply(x, h[N - 1 - i], lo, mid, hi);
+    }
+
+    return ghash_reduce(lo, mid, hi);
+}
+
+TARGET_AES
+static void pclmul_ghash_key(aes_gcm::hash_key_t &hk, const uint8_t *h) {
+    auto powers = (__m128i *) hk.u8;
+    __m128i h1 = ghash_reverse(_mm_loadu_si128((const __m128i *) h));
+    powers[0] = h1;
+
+    for (size_t i = 1; i < aes_gcm::HASH_POWERS; i++) {
+        __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+        ghash_multiply(powers[i - 1], h1, lo, mid, hi);
+        powers[i] = ghash_reduce(lo, mid, hi);
+    }
+}
+
+TARGET_AES
+static void pclmul_ghash(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks) {
+    auto h = (const __m128i *) hk.u8;
+    __m128i acc = ghash_reverse(_mm_loadu_si128((const __m128i *) y));
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, data += AES_PIPELINE_BLOCKS * aes::BLOCK) {
+        acc = ghash_blocks<AES_PIPELINE_BLOCKS>(h, acc, data);
+    }
+
+    for (; blocks != 0; blocks--, data += aes::BLOCK) {
+        acc = ghash_blocks<1>(h, acc, data);
+    }
+
+    _mm_storeu_si128((__m128i *) y, ghash_reverse(acc));
+}
+
+/**
+ * Stitched GCM: GHASH of one batch of ciphertext runs while AES rounds of the next batch are in flight. When
+ * encrypting, ciphertext of a batch is hashed together with the next batch.
+ */
+TARGET_AES
+static void aesni_gcm(const aes::round_keys_t &rk, uint32_t rounds, const aes_gcm::hash_key_t &hk, uint8_t *y,
+                      uint8_t *counter, uint8_t *dst, const uint8_t *src, size_t blocks, bool decrypt) {
+    const __m128i *k = (const __m128i *) rk.u8;
+    auto h = (const __m128i *) hk.u8;
+    constexpr size_t BATCH = AES_PIPELINE_BLOCKS * aes::BLOCK;
+
+    __m128i acc = ghash_reverse(_mm_loadu_si128((const __m128i *) y));
+    const uint8_t *pending = nullptr;
+
+    for (; blocks >= AES_PIPELINE_BLOCKS; blocks -= AES_PIPELINE_BLOCKS, dst += BATCH, src += BATCH) {
+        __m128i x[AES_PIPELINE_BLOCKS];
+        aesni_counters<AES_PIPELINE_BLOCKS>(counter, true, x);
+        aesni_rounds<AES_PIPELINE_BLOCKS>(k, rounds, x);
+
+        const uint8_t *hashed = decrypt ? src : pending;
+        if (hashed != nullptr) {
+            acc = ghash_blocks<AES_PIPELINE_BLOCKS>(h, acc, hashed);
+        }
+
+        aesni_xor_blocks<AES_PIPELINE_BLOCKS>(x, dst, src);
+        pending = decrypt ? nullptr : dst;
+    }
+
+    if (pending != nullptr) {
+        acc = ghash_blocks<AES_PIPELINE_BLOCKS>(h, acc, pending);
+    }
+
+    for (; blocks != 0; blocks--, dst += aes::BLOCK, src += aes::BLOCK) {
+        if (decrypt) {
+            acc = ghash_blocks<1>(h, acc, src);
+        }
+
+        aesni_ctr_blocks<1>(k, rounds, counter, true, dst, src);
+
+        if (!decrypt) {
+            acc = ghash_blocks<1>(h, acc, dst);
+        }
+    }
+
+    _mm_storeu_si128((__m128i *) y, ghash_reverse(acc));
+}
+
+const aes_backend ub::crypto::impl::aesNIBackend = {
+    aesni_key_schedule,
+    aesni_encrypt,
+    aesni_ctr,
+    pclmul_ghash_key,
+    pclmul_ghash,
+    aesni_gcm
+};
+
+#endif
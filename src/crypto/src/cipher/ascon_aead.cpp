@@ -0,0 +1,109 @@
+#include <ub/crypto/ascon.hpp>
+
+#include "../hash/ascon_common.hpp"
+
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr uint64_t ASCON_AEAD128_IV  = 0x00001000808C0001;
+static constexpr uint8_t  ASCON_AEAD_RATE   = 16;
+
+// Processing phases
+static constexpr uint8_t ASCON_AEAD_NONE    = 0;    // associated data is not started yet
+static constexpr uint8_t ASCON_AEAD_AD      = 1;    // some associated data was absorbed
+static constexpr uint8_t ASCON_AEAD_MSG     = 2;
+
+static uint64_t ascon_load64(const uint8_t *buf) {
+    uint64_t x;
+    std::memcpy(&x, buf, sizeof(x)); // assume little-endian system
+    return x;
+}
+
+void ascon_aead128::reset() {
+    a.reset();
+    secureZero(m_key, sizeof(m_key));
+    m_phase = ASCON_AEAD_NONE;
+}
+
+void ascon_aead128::init(const uint8_t *key, const uint8_t *nonce) {
+    a.reset();
+    a.rate = ASCON_AEAD_RATE;
+    a.rounds = ASCON_ROUNDS_B;
+
+    m_key[0] = ascon_load64(key);
+    m_key[1] = ascon_load64(key + 8);
+
+    a.xorWord(0, ASCON_AEAD128_IV);
+    a.xorWord(1, m_key[0]);
+    a.xorWord(2, m_key[1]);
+    a.xorWord(3, ascon_load64(nonce));
+    a.xorWord(4, ascon_load64(nonce + 8));
+    ascon320::apply(a.st, ASCON_ROUNDS_A);
+
+    a.xorWord(3, m_key[0]);
+    a.xorWord(4, m_key[1]);
+
+    m_phase = ASCON_AEAD_NONE;
+}
+
+void ascon_aead128::authenticate(const uint8_t *data, size_t length) {
+    // associated data could not follow message data
+    if (length == 0 || m_phase == ASCON_AEAD_MSG) {
+        return;
+    }
+
+    a.consume(data, length);
+    m_phase = ASCON_AEAD_AD;
+}
+
+void ascon_aead128::beginMessage() {
+    if (m_phase == ASCON_AEAD_MSG) {
+        return;
+    }
+
+    // empty associated data is not padded
+    if (m_phase == ASCON_AEAD_AD) {
+        a.finish();
+    }
+
+    a.xorWord(4, 1ULL << 63);   // domain separation bit
+    m_phase = ASCON_AEAD_MSG;
+}
+
+void ascon_aead128::encrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    beginMessage();
+    a.duplex(dst, src, length, false);
+}
+
+void ascon_aead128::decrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    beginMessage();
+    a.duplex(dst, src, length, true);
+}
+
+void ascon_aead128::finish(uint8_t *tag) {
+    beginMessage();
+
+    // the last (possibly empty) message block is padded without permutation
+    a.xorWord(a.ptr >> 3, 0x01ULL << ((a.ptr & 7) << 3));
+    a.xorWord(2, m_key[0]);
+    a.xorWord(3, m_key[1]);
+    ascon320::apply(a.st, ASCON_ROUNDS_A);
+
+    uint64_t t[2] = { a.word(3) ^ m_key[0], a.word(4) ^ m_key[1] };
+    std::memcpy(tag, t, TAG_LENGTH); // assume little-endian system
+    secureZero(t, sizeof(t));
+
+    reset();
+}
+
+bool ascon_aead128::verify(const uint8_t *tag) {
+    uint8_t expected[TAG_LENGTH];
+    finish(expected);
+
+    bool valid = secureCompare(expected, tag, TAG_LENGTH);
+    secureZero(expected, sizeof(expected));
+
+    return valid;
+}
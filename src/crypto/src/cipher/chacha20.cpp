@@ -5,14 +5,11 @@
 
 #include <ub/crypto/utility.hpp>
 
-using namespace ub::crypto;
-
-static constexpr size_t CHACHA20_N_STATE = 16;
-static constexpr size_t CHACHA20_N_ROUNDS = 10;
+#include "chacha20_common.hpp"
+#include "../parallel.hpp"
 
-static constexpr size_t CHACHA20_ST_PTR_KEY     = 4;
-static constexpr size_t CHACHA20_ST_PTR_BLK     = 12;
-static constexpr size_t CHACHA20_ST_PTR_NONCE   = 13;
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
 
 /** Quarter-round state indices encoded as 4 nibbles */
 static const uint16_t chacha20_qr_indices[] = { 0x048C, 0x159D, 0x26AE, 0x37BF, 0x05AF, 0x16BC, 0x278D, 0x349E };
@@ -60,9 +57,80 @@ void chacha20::processBlock(uint32_t *state, const uint32_t *src) {
     }
 }
 
+/** Advance block counter by `blocks`, carrying into the next state word for 64-bit counter */
+static void chacha20_advance(uint32_t *state, bool counter64, uint64_t blocks) {
+    uint64_t counter = state[CHACHA20_ST_PTR_BLK];
+    if (counter64) {
+        counter |= (uint64_t) state[CHACHA20_ST_PTR_BLK + 1] << 32;
+        state[CHACHA20_ST_PTR_BLK + 1] = (uint32_t) ((counter + blocks) >> 32);
+    }
+
+    state[CHACHA20_ST_PTR_BLK] = (uint32_t) (counter + blocks);
+}
+
+/** XOR whole blocks with key stream starting at block counter of `state`, which is advanced past the last block */
+static void chacha20_xor_blocks(uint32_t *state, bool counter64, uint32_t *scratch, uint8_t *dst, const uint8_t *src,
+                                size_t blocks)
+{
+    while (blocks != 0) {
+        size_t done = 0;
+
+#if UB_CRYPTO_CHACHA20_SIMD
+        // SIMD lanes do not carry into the high word, so 64-bit counter must not wrap within a single call
+        size_t n = blocks;
+        if (counter64) {
+            n = (size_t) std::min<uint64_t>(n, (1ull << 32) - state[CHACHA20_ST_PTR_BLK]);
+        }
+
+        done = chacha20XorMany(state, dst, src, n);
+#endif
+
+        if (done == 0) {
+            chacha20::processBlock(scratch, state);
+            exclusiveOr(dst, src, chacha20::state_t::LENGTH, scratch);
+            done = 1;
+        }
+
+        chacha20_advance(state, counter64, done);
+        dst += done * chacha20::state_t::LENGTH;
+        src += done * chacha20::state_t::LENGTH;
+        blocks -= done;
+    }
+}
+
+#if UB_CRYPTO_THREADS
+/** Buffers smaller than this are not worth distributing between threads */
+static constexpr size_t CHACHA20_PARALLEL_MIN = 262144;
+
+/** Number of blocks processed by a single thread at once */
+static constexpr size_t CHACHA20_PARALLEL_GRAIN = 65536 / chacha20::state_t::LENGTH;
+
+struct chacha20_range {
+    const uint32_t *state;      //! State with block counter of the first block
+    bool            counter64;
+    uint8_t        *dst;
+    const uint8_t  *src;
+};
+
+static void chacha20_xor_range(void *ctx, size_t begin, size_t end) {
+    auto *r = (const chacha20_range *) ctx;
+
+    chacha20::state_t state, scratch;
+    std::memcpy(state.u32, r->state, sizeof(state));
+    chacha20_advance(state.u32, r->counter64, begin);
+
+    size_t offset = begin * chacha20::state_t::LENGTH;
+    chacha20_xor_blocks(state.u32, r->counter64, scratch.u32, r->dst + offset, r->src + offset, end - begin);
+
+    secureZero(&state, sizeof(state));
+    secureZero(&scratch, sizeof(scratch));
+}
+#endif
+
 chacha20::chacha20(): m_state {}, m_stream {} {
     std::memcpy(m_state.u32, initialConstants, sizeof(initialConstants));
     m_streamPtr = 0;
+    m_counter64 = false;
 }
 
 chacha20::~chacha20() {
@@ -70,10 +138,19 @@ chacha20::~chacha20() {
     secureZero(m_stream.u8, sizeof(m_stream));
 }
 
+void chacha20::reset() {
+    secureZero(m_state.u8, sizeof(m_state));
+    secureZero(m_stream.u8, sizeof(m_stream));
+    std::memcpy(m_state.u32, initialConstants, sizeof(initialConstants));
+    m_streamPtr = 0;
+    m_counter64 = false;
+}
+
 void chacha20::init(const uint8_t *key, const uint8_t *nonce) {
     std::memcpy(m_state.u32 + CHACHA20_ST_PTR_KEY, key, KEY_LENGTH);
     std::memcpy(m_state.u32 + CHACHA20_ST_PTR_NONCE, nonce, NONCE_LENGTH);
     m_state.u32[CHACHA20_ST_PTR_BLK] = 0;
+    m_counter64 = false;
 
     processBlock();
 }
@@ -85,10 +162,33 @@ void chacha20::init(const uint8_t *key, uint64_t nonce) {
     m_state.u32[CHACHA20_ST_PTR_NONCE + 0] = 0;
     m_state.u32[CHACHA20_ST_PTR_NONCE + 1] = (uint32_t) (nonce >> 32);
     m_state.u32[CHACHA20_ST_PTR_NONCE + 2] = (uint32_t) nonce;
+    m_counter64 = false;
+
+    processBlock();
+}
+
+void chacha20::init64(const uint8_t *key, const uint8_t *nonce) {
+    std::memcpy(m_state.u32 + CHACHA20_ST_PTR_KEY, key, KEY_LENGTH);
+    std::memcpy(m_state.u32 + CHACHA20_ST_PTR_NONCE + 1, nonce, NONCE64_LENGTH);
+    m_state.u32[CHACHA20_ST_PTR_BLK] = 0;
+    m_state.u32[CHACHA20_ST_PTR_BLK + 1] = 0;
+    m_counter64 = true;
 
     processBlock();
 }
 
+void chacha20::seek(uint64_t offset) {
+    uint64_t block = offset / state_t::LENGTH;
+    m_state.u32[CHACHA20_ST_PTR_BLK] = (uint32_t) block;
+
+    if (m_counter64) {
+        m_state.u32[CHACHA20_ST_PTR_BLK + 1] = (uint32_t) (block >> 32);
+    }
+
+    processBlock();
+    m_streamPtr = offset % state_t::LENGTH;
+}
+
 void chacha20::process(uint8_t *dst, const uint8_t *src, size_t length) {
     while (length != 0) {
         size_t len = std::min(length, (size_t) (state_t::LENGTH - m_streamPtr));
@@ -99,9 +199,30 @@ void chacha20::process(uint8_t *dst, const uint8_t *src, size_t length) {
         length -= len;
 
         m_streamPtr += len;
-        if (m_streamPtr == state_t::LENGTH) {
-            processBlock();
+        if (m_streamPtr != state_t::LENGTH) {
+            continue;
         }
+
+        // key stream buffer is exhausted, so whole blocks are processed directly
+        size_t blocks = length / state_t::LENGTH;
+
+#if UB_CRYPTO_THREADS
+        if (length >= CHACHA20_PARALLEL_MIN) {
+            chacha20_range range { m_state.u32, m_counter64, dst, src };
+            parallelFor(blocks, CHACHA20_PARALLEL_GRAIN, chacha20_xor_range, &range);
+            chacha20_advance(m_state.u32, m_counter64, blocks);
+        } else {
+            chacha20_xor_blocks(m_state.u32, m_counter64, m_stream.u32, dst, src, blocks);
+        }
+#else
+        chacha20_xor_blocks(m_state.u32, m_counter64, m_stream.u32, dst, src, blocks);
+#endif
+
+        dst += blocks * state_t::LENGTH;
+        src += blocks * state_t::LENGTH;
+        length -= blocks * state_t::LENGTH;
+
+        processBlock();
     }
 }
 
@@ -109,5 +230,5 @@ void chacha20::processBlock() {
     processBlock(m_stream.u32, m_state.u32);
     m_streamPtr = 0;
 
-    m_state.u32[CHACHA20_ST_PTR_BLK]++;
+    chacha20_advance(m_state.u32, m_counter64, 1);
 }
@@ -0,0 +1,36 @@
+#ifndef UB_SRC_CRYPTO_CIPHER_CHACHA20_COMMON_H
+#define UB_SRC_CRYPTO_CIPHER_CHACHA20_COMMON_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../cpu.hpp"
+
+// Multi-block ChaCha20 key stream runs in SIMD lanes on hosted targets, microcontrollers use compact table-driven code
+#if UB_CRYPTO_X86 || UB_CRYPTO_ARM64
+#define UB_CRYPTO_CHACHA20_SIMD     1
+#else
+#define UB_CRYPTO_CHACHA20_SIMD     0
+#endif
+
+namespace ub::crypto::impl {
+    constexpr size_t CHACHA20_N_STATE       = 16;
+    constexpr size_t CHACHA20_N_ROUNDS      = 10;
+
+    constexpr size_t CHACHA20_ST_PTR_KEY    = 4;
+    constexpr size_t CHACHA20_ST_PTR_BLK    = 12;
+    constexpr size_t CHACHA20_ST_PTR_NONCE  = 13;
+
+#if UB_CRYPTO_CHACHA20_SIMD
+    /**
+     * XOR `src` with key stream blocks starting at block counter of `state` into `dst`, processing as many of `blocks`
+     * whole blocks as fit SIMD lanes (4 blocks with SSE2 and NEON, 8 blocks with AVX2). Counter in `state` is not
+     * advanced, it wraps around within the 32-bit word.
+     *
+     * @return Number of processed blocks, zero when no SIMD instructions are available
+     */
+    size_t chacha20XorMany(const uint32_t *state, uint8_t *dst, const uint8_t *src, size_t blocks);
+#endif
+}
+
+#endif // UB_SRC_CRYPTO_CIPHER_CHACHA20_COMMON_H
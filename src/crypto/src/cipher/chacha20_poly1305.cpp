@@ -0,0 +1,94 @@
+#include <ub/crypto/chacha20.hpp>
+#include <ub/crypto/utility.hpp>
+
+#include <cstring>
+
+using namespace ub::crypto;
+
+// Processing phases
+static constexpr uint8_t CHACHA20_POLY1305_AD   = 0;
+static constexpr uint8_t CHACHA20_POLY1305_MSG  = 1;
+
+chacha20_poly1305::chacha20_poly1305() {
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = CHACHA20_POLY1305_AD;
+}
+
+void chacha20_poly1305::reset() {
+    m_cipher.reset();
+    m_mac.reset();
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = CHACHA20_POLY1305_AD;
+}
+
+void chacha20_poly1305::init(const uint8_t *key, const uint8_t *nonce) {
+    m_cipher.init(key, nonce);
+
+    // first key stream block: one-time Poly1305 key followed by 32 discarded bytes
+    uint8_t block[chacha20::state_t::LENGTH] = {};
+    m_cipher.process(block, block, sizeof(block));
+    m_mac.init(block);
+    secureZero(block, sizeof(block));
+
+    m_adLength = 0;
+    m_msgLength = 0;
+    m_phase = CHACHA20_POLY1305_AD;
+}
+
+void chacha20_poly1305::authenticate(const uint8_t *data, size_t length) {
+    // associated data could not follow message data
+    if (m_phase == CHACHA20_POLY1305_MSG) {
+        return;
+    }
+
+    m_mac.update(data, length);
+    m_adLength += length;
+}
+
+void chacha20_poly1305::beginMessage() {
+    if (m_phase == CHACHA20_POLY1305_MSG) {
+        return;
+    }
+
+    m_mac.pad();
+    m_phase = CHACHA20_POLY1305_MSG;
+}
+
+void chacha20_poly1305::encrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    beginMessage();
+    m_cipher.process(dst, src, length);
+    m_mac.update(dst, length);
+    m_msgLength += length;
+}
+
+void chacha20_poly1305::decrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    // MAC is computed over ciphertext, which could be overwritten when operating in-place
+    beginMessage();
+    m_mac.update(src, length);
+    m_cipher.process(dst, src, length);
+    m_msgLength += length;
+}
+
+void chacha20_poly1305::finish(uint8_t *tag) {
+    beginMessage();
+    m_mac.pad();
+
+    // lengths of associated data and ciphertext as little-endian numbers, assume little-endian system
+    uint64_t lengths[2] = { m_adLength, m_msgLength };
+    m_mac.update((const uint8_t *) lengths, sizeof(lengths));
+    m_mac.finish(tag);
+
+    reset();
+}
+
+bool chacha20_poly1305::verify(const uint8_t *tag) {
+    uint8_t expected[TAG_LENGTH];
+    finish(expected);
+
+    bool valid = secureCompare(expected, tag, TAG_LENGTH);
+    secureZero(expected, sizeof(expected));
+
+    return valid;
+}
@@ -0,0 +1,219 @@
+#include "chacha20_common.hpp"
+
+#if UB_CRYPTO_CHACHA20_SIMD
+
+#include <cstring>
+
+using namespace ub::crypto::impl;
+
+// Every SIMD lane computes its own block: vector `i` holds state word `i` of consecutive blocks, which are transposed
+// back into block order before XOR. Vector types are lowered by compiler to SSE2/AVX2 registers on x86 and to NEON
+// registers on AArch64. Working state is kept in registers and is deliberately not wiped: taking its address for
+// `secureZero()` forces it to the stack and makes the code three times slower.
+
+typedef uint32_t chacha20_v4 __attribute__((vector_size(16)));
+typedef uint32_t chacha20_v8 __attribute__((vector_size(32)));
+
+static constexpr size_t CHACHA20_BLOCK = CHACHA20_N_STATE * sizeof(uint32_t);
+
+typedef uint8_t chacha20_b16 __attribute__((vector_size(16)));
+typedef uint8_t chacha20_b32 __attribute__((vector_size(32)));
+typedef uint16_t chacha20_h8 __attribute__((vector_size(16)));
+typedef uint16_t chacha20_h16 __attribute__((vector_size(32)));
+
+/** Rotate every word left by 16 bits by swapping halfwords */
+template <typename V>
+[[gnu::always_inline]] static inline void chacha20_rotate16(V &x) {
+    if constexpr (sizeof(V) == sizeof(chacha20_v4)) {
+        x = (V) __builtin_shufflevector((chacha20_h8) x, (chacha20_h8) x, 1, 0, 3, 2, 5, 4, 7, 6);
+    } else {
+        x = (V) __builtin_shufflevector((chacha20_h16) x, (chacha20_h16) x,
+                                        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    }
+}
+
+/** Rotate every word left by 8 bits with a byte shuffle, which needs SSSE3 on x86 */
+template <typename V>
+[[gnu::always_inline]] static inline void chacha20_rotate8(V &x) {
+    if constexpr (sizeof(V) == sizeof(chacha20_v4)) {
+        x = (V) __builtin_shufflevector((chacha20_b16) x, (chacha20_b16) x,
+                                        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    } else {
+        x = (V) __builtin_shufflevector((chacha20_b32) x, (chacha20_b32) x,
+                                        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                        19, 16, 17, 18, 23, 20, 21, 22, 27, 24, 25, 26, 31, 28, 29, 30);
+    }
+}
+
+/** `x = rotl(x ^ y, N)`, with `Shuffle` set rotation by 8 is performed as a byte shuffle */
+template <int N, bool Shuffle, typename V>
+[[gnu::always_inline]] static inline void chacha20_xor_rotate(V &x, const V &y) {
+    x ^= y;
+
+    if constexpr (N == 16) {
+        chacha20_rotate16(x);
+    } else if constexpr (N == 8 && Shuffle) {
+        chacha20_rotate8(x);
+    } else {
+        x = (x << N) | (x >> (32 - N));
+    }
+}
+
+template <bool Shuffle, typename V>
+[[gnu::always_inline]] static inline void chacha20_quarter_round(V &a, V &b, V &c, V &d) {
+    a += b; chacha20_xor_rotate<16, Shuffle>(d, a);
+    c += d; chacha20_xor_rotate<12, Shuffle>(b, c);
+    a += b; chacha20_xor_rotate<8, Shuffle>(d, a);
+    c += d; chacha20_xor_rotate<7, Shuffle>(b, c);
+}
+
+/** Transpose `N` vectors of `N` words, so word `i` of each input lane ends up in vector `i` */
+template <typename V>
+[[gnu::always_inline]] static inline void chacha20_transpose(V *r) {
+    if constexpr (sizeof(V) == sizeof(chacha20_v4)) {
+        V t0 = __builtin_shufflevector(r[0], r[1], 0, 4, 1, 5);
+        V t1 = __builtin_shufflevector(r[0], r[1], 2, 6, 3, 7);
+        V t2 = __builtin_shufflevector(r[2], r[3], 0, 4, 1, 5);
+        V t3 = __builtin_shufflevector(r[2], r[3], 2, 6, 3, 7);
+
+        r[0] = __builtin_shufflevector(t0, t2, 0, 1, 4, 5);
+        r[1] = __builtin_shufflevector(t0, t2, 2, 3, 6, 7);
+        r[2] = __builtin_shufflevector(t1, t3, 0, 1, 4, 5);
+        r[3] = __builtin_shufflevector(t1, t3, 2, 3, 6, 7);
+    } else {
+        // interleave 32-bit words and 64-bit pairs within 128-bit halves, then swap halves
+        V t[8], u[8];
+#pragma GCC unroll 4
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = __builtin_shufflevector(r[i], r[i + 1], 0, 8, 1, 9, 4, 12, 5, 13);
+            t[i + 1] = __builtin_shufflevector(r[i], r[i + 1], 2, 10, 3, 11, 6, 14, 7, 15);
+        }
+
+#pragma GCC unroll 2
+        for (size_t i = 0; i < 8; i += 4) {
+            u[i] = __builtin_shufflevector(t[i], t[i + 2], 0, 1, 8, 9, 4, 5, 12, 13);
+            u[i + 1] = __builtin_shufflevector(t[i], t[i + 2], 2, 3, 10, 11, 6, 7, 14, 15);
+            u[i + 2] = __builtin_shufflevector(t[i + 1], t[i + 3], 0, 1, 8, 9, 4, 5, 12, 13);
+            u[i + 3] = __builtin_shufflevector(t[i + 1], t[i + 3], 2, 3, 10, 11, 6, 7, 14, 15);
+        }
+
+#pragma GCC unroll 4
+        for (size_t i = 0; i < 4; i++) {
+            r[i] = __builtin_shufflevector(u[i], u[i + 4], 0, 1, 2, 3, 8, 9, 10, 11);
+            r[i + 4] = __builtin_shufflevector(u[i], u[i + 4], 4, 5, 6, 7, 12, 13, 14, 15);
+        }
+    }
+}
+
+/** XOR one group of `N` consecutive blocks, block counters start at `counter` */
+template <typename V, bool Shuffle>
+[[gnu::always_inline]] static inline void chacha20_xor_lanes(const uint32_t *state, uint32_t counter, uint8_t *dst,
+                                                             const uint8_t *src)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+
+    // lane `l` processes block `counter + l`
+    V ctr = V {} + counter;
+    if constexpr (N == 4) {
+        ctr += V { 0, 1, 2, 3 };
+    } else {
+        ctr += V { 0, 1, 2, 3, 4, 5, 6, 7 };
+    }
+
+    V x[CHACHA20_N_STATE];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < CHACHA20_N_STATE; i++) {
+        x[i] = i == CHACHA20_ST_PTR_BLK ? ctr : V {} + state[i];
+    }
+
+#pragma GCC unroll 10
+    for (size_t r = 0; r < CHACHA20_N_ROUNDS; r++) {
+        chacha20_quarter_round<Shuffle>(x[0], x[4], x[8], x[12]);
+        chacha20_quarter_round<Shuffle>(x[1], x[5], x[9], x[13]);
+        chacha20_quarter_round<Shuffle>(x[2], x[6], x[10], x[14]);
+        chacha20_quarter_round<Shuffle>(x[3], x[7], x[11], x[15]);
+
+        chacha20_quarter_round<Shuffle>(x[0], x[5], x[10], x[15]);
+        chacha20_quarter_round<Shuffle>(x[1], x[6], x[11], x[12]);
+        chacha20_quarter_round<Shuffle>(x[2], x[7], x[8], x[13]);
+        chacha20_quarter_round<Shuffle>(x[3], x[4], x[9], x[14]);
+    }
+
+#pragma GCC unroll 16
+    for (size_t i = 0; i < CHACHA20_N_STATE; i++) {
+        x[i] += i == CHACHA20_ST_PTR_BLK ? ctr : V {} + state[i];
+    }
+
+    // after transposition of group `g`, vector `l` holds words `g * N .. g * N + N - 1` of block `l`
+#pragma GCC unroll 16
+    for (size_t g = 0; g < CHACHA20_N_STATE; g += N) {
+        chacha20_transpose(x + g);
+
+#pragma GCC unroll 8
+        for (size_t l = 0; l < N; l++) {
+            size_t offset = l * CHACHA20_BLOCK + g * sizeof(uint32_t);
+
+            V m;
+            std::memcpy(&m, src + offset, sizeof(V));    // assume little-endian system
+            m ^= x[g + l];
+            std::memcpy(dst + offset, &m, sizeof(V));
+        }
+    }
+}
+
+template <typename V, bool Shuffle>
+[[gnu::always_inline]] static inline size_t chacha20_xor_many_v(const uint32_t *state, uint8_t *dst,
+                                                                const uint8_t *src, size_t blocks)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+    uint32_t counter = state[CHACHA20_ST_PTR_BLK];
+    size_t done = 0;
+
+    for (; blocks - done >= N; done += N) {
+        chacha20_xor_lanes<V, Shuffle>(state, counter + done, dst + done * CHACHA20_BLOCK, src + done * CHACHA20_BLOCK);
+    }
+
+    return done;
+}
+
+#if UB_CRYPTO_X86
+[[gnu::target("avx2")]]
+static size_t chacha20_xor_many_avx2(const uint32_t *state, uint8_t *dst, const uint8_t *src, size_t blocks) {
+    size_t done = chacha20_xor_many_v<chacha20_v8, true>(state, dst, src, blocks);
+
+    if (blocks - done >= 4) {
+        chacha20_xor_lanes<chacha20_v4, true>(state, state[CHACHA20_ST_PTR_BLK] + done, dst + done * CHACHA20_BLOCK,
+                                        src + done * CHACHA20_BLOCK);
+        done += 4;
+    }
+
+    return done;
+}
+
+[[gnu::target("sse2")]]
+static size_t chacha20_xor_many_sse2(const uint32_t *state, uint8_t *dst, const uint8_t *src, size_t blocks) {
+    return chacha20_xor_many_v<chacha20_v4, false>(state, dst, src, blocks);
+}
+#else
+static size_t chacha20_xor_many_neon(const uint32_t *state, uint8_t *dst, const uint8_t *src, size_t blocks) {
+    return chacha20_xor_many_v<chacha20_v4, true>(state, dst, src, blocks);
+}
+#endif
+
+size_t ub::crypto::impl::chacha20XorMany(const uint32_t *state, uint8_t *dst, const uint8_t *src, size_t blocks) {
+#if UB_CRYPTO_X86
+    if (cpuFeatures() & CPU_X86_AVX2) {
+        return chacha20_xor_many_avx2(state, dst, src, blocks);
+    }
+
+    if (cpuFeatures() & CPU_X86_SSE2) {
+        return chacha20_xor_many_sse2(state, dst, src, blocks);
+    }
+
+    return 0;
+#else
+    return chacha20_xor_many_neon(state, dst, src, blocks);
+#endif
+}
+
+#endif // UB_CRYPTO_CHACHA20_SIMD
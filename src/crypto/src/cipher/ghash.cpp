@@ -0,0 +1,204 @@
+#include "aes_common.hpp"
+
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Constant-time GHASH after BearSSL `ghash_ctmul64` and `ghash_ctmul`: carry-less products are computed with ordinary
+// integer multiplications of operands with 3-bit holes between data bits, so carries never reach the next data bit.
+// GHASH bit order is reversed, so 128x128 products are taken as-is and the 255-bit result is shifted by one bit before
+// reduction modulo x^128 + x^7 + x^2 + x + 1. Hash key is stored as native words in `hk`.
+
+static uint32_t ghash_load32(const uint8_t *buf) {
+    uint32_t x;
+    std::memcpy(&x, buf, sizeof(x));
+    return __builtin_bswap32(x);    // assume little-endian system
+}
+
+static void ghash_store32(uint8_t *buf, uint32_t x) {
+    x = __builtin_bswap32(x);
+    std::memcpy(buf, &x, sizeof(x));
+}
+
+#if UB_CRYPTO_AES64
+/** Low 64 bits of carry-less product */
+static uint64_t ghash_bmul64(uint64_t x, uint64_t y) {
+    constexpr uint64_t M0 = 0x1111111111111111, M1 = M0 << 1, M2 = M0 << 2, M3 = M0 << 3;
+
+    uint64_t x0 = x & M0, x1 = x & M1, x2 = x & M2, x3 = x & M3;
+    uint64_t y0 = y & M0, y1 = y & M1, y2 = y & M2, y3 = y & M3;
+
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+    return (z0 & M0) | (z1 & M1) | (z2 & M2) | (z3 & M3);
+}
+
+static uint64_t ghash_rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555) << 1) | ((x >> 1) & 0x5555555555555555);
+    x = ((x & 0x3333333333333333) << 2) | ((x >> 2) & 0x3333333333333333);
+    x = ((x & 0x0F0F0F0F0F0F0F0F) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0F);
+    return __builtin_bswap64(x);
+}
+
+void ub::crypto::impl::ghashKeyPortable(aes_gcm::hash_key_t &hk, const uint8_t *h) {
+    hk.u64[0] = ((uint64_t) ghash_load32(h) << 32) | ghash_load32(h + 4);
+    hk.u64[1] = ((uint64_t) ghash_load32(h + 8) << 32) | ghash_load32(h + 12);
+}
+
+void ub::crypto::impl::ghashPortable(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks) {
+    uint64_t h1 = hk.u64[0], h0 = hk.u64[1];
+    uint64_t h0r = ghash_rev64(h0), h1r = ghash_rev64(h1);
+    uint64_t h2 = h0 ^ h1, h2r = h0r ^ h1r;
+
+    uint64_t y1 = ((uint64_t) ghash_load32(y) << 32) | ghash_load32(y + 4);
+    uint64_t y0 = ((uint64_t) ghash_load32(y + 8) << 32) | ghash_load32(y + 12);
+
+    for (; blocks != 0; blocks--, data += aes::BLOCK) {
+        y1 ^= ((uint64_t) ghash_load32(data) << 32) | ghash_load32(data + 4);
+        y0 ^= ((uint64_t) ghash_load32(data + 8) << 32) | ghash_load32(data + 12);
+
+        uint64_t y0r = ghash_rev64(y0), y1r = ghash_rev64(y1);
+        uint64_t y2 = y0 ^ y1, y2r = y0r ^ y1r;
+
+        // Karatsuba: low halves of products directly, high halves as low halves of bit-reversed products
+        uint64_t z0 = ghash_bmul64(y0, h0);
+        uint64_t z1 = ghash_bmul64(y1, h1);
+        uint64_t z2 = ghash_bmul64(y2, h2);
+        uint64_t z0h = ghash_bmul64(y0r, h0r);
+        uint64_t z1h = ghash_bmul64(y1r, h1r);
+        uint64_t z2h = ghash_bmul64(y2r, h2r);
+
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = ghash_rev64(z0h) >> 1;
+        z1h = ghash_rev64(z1h) >> 1;
+        z2h = ghash_rev64(z2h) >> 1;
+
+        uint64_t v0 = z0;
+        uint64_t v1 = z0h ^ z2;
+        uint64_t v2 = z1 ^ z2h;
+        uint64_t v3 = z1h;
+
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        y0 = v2;
+        y1 = v3;
+    }
+
+    ghash_store32(y, y1 >> 32);
+    ghash_store32(y + 4, y1);
+    ghash_store32(y + 8, y0 >> 32);
+    ghash_store32(y + 12, y0);
+}
+#else
+/** Carry-less 32x32 -> 64 product, constant-time as long as 32x32 -> 64 multiplication is */
+static uint64_t ghash_bmul32(uint32_t x, uint32_t y) {
+    constexpr uint32_t M0 = 0x11111111, M1 = M0 << 1, M2 = M0 << 2, M3 = M0 << 3;
+    constexpr uint64_t W0 = 0x1111111111111111, W1 = W0 << 1, W2 = W0 << 2, W3 = W0 << 3;
+
+    uint64_t x0 = x & M0, x1 = x & M1, x2 = x & M2, x3 = x & M3;
+    uint64_t y0 = y & M0, y1 = y & M1, y2 = y & M2, y3 = y & M3;
+
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+    return (z0 & W0) | (z1 & W1) | (z2 & W2) | (z3 & W3);
+}
+
+void ub::crypto::impl::ghashKeyPortable(aes_gcm::hash_key_t &hk, const uint8_t *h) {
+    for (size_t i = 0; i < 4; i++) {
+        hk.u32[i] = ghash_load32(h + 12 - 4 * i);
+    }
+}
+
+void ub::crypto::impl::ghashPortable(const aes_gcm::hash_key_t &hk, uint8_t *y, const uint8_t *data, size_t blocks) {
+    uint32_t yw[4];
+    for (size_t i = 0; i < 4; i++) {
+        yw[i] = ghash_load32(y + 12 - 4 * i);
+    }
+
+    for (; blocks != 0; blocks--, data += aes::BLOCK) {
+        for (size_t i = 0; i < 4; i++) {
+            yw[i] ^= ghash_load32(data + 12 - 4 * i);
+        }
+
+        // two levels of Karatsuba: nine 32x32 products for y[0,1]*h[0,1], y[2,3]*h[2,3] and their sums
+        uint32_t a[9], b[9];
+        const uint32_t *hw = hk.u32;
+
+        a[0] = yw[0];           b[0] = hw[0];
+        a[1] = yw[1];           b[1] = hw[1];
+        a[2] = a[0] ^ a[1];     b[2] = b[0] ^ b[1];
+        a[3] = yw[2];           b[3] = hw[2];
+        a[4] = yw[3];           b[4] = hw[3];
+        a[5] = a[3] ^ a[4];     b[5] = b[3] ^ b[4];
+        a[6] = a[0] ^ a[3];     b[6] = b[0] ^ b[3];
+        a[7] = a[1] ^ a[4];     b[7] = b[1] ^ b[4];
+        a[8] = a[6] ^ a[7];     b[8] = b[6] ^ b[7];
+
+        for (size_t i = 0; i < 9; i++) {
+            uint64_t z = ghash_bmul32(b[i], a[i]);
+            a[i] = (uint32_t) z;
+            b[i] = (uint32_t) (z >> 32);
+        }
+
+        uint32_t c0 = a[0];
+        uint32_t c1 = b[0] ^ a[2] ^ a[0] ^ a[1];
+        uint32_t c2 = a[1] ^ b[2] ^ b[0] ^ b[1];
+        uint32_t c3 = b[1];
+        uint32_t d0 = a[3];
+        uint32_t d1 = b[3] ^ a[5] ^ a[3] ^ a[4];
+        uint32_t d2 = a[4] ^ b[5] ^ b[3] ^ b[4];
+        uint32_t d3 = b[4];
+        uint32_t e0 = a[6];
+        uint32_t e1 = b[6] ^ a[8] ^ a[6] ^ a[7];
+        uint32_t e2 = a[7] ^ b[8] ^ b[6] ^ b[7];
+        uint32_t e3 = b[7];
+
+        e0 ^= c0 ^ d0;
+        e1 ^= c1 ^ d1;
+        e2 ^= c2 ^ d2;
+        e3 ^= c3 ^ d3;
+        c2 ^= e0;
+        c3 ^= e1;
+        d0 ^= e2;
+        d1 ^= e3;
+
+        uint32_t zw[8];
+        zw[0] = c0 << 1;
+        zw[1] = (c1 << 1) | (c0 >> 31);
+        zw[2] = (c2 << 1) | (c1 >> 31);
+        zw[3] = (c3 << 1) | (c2 >> 31);
+        zw[4] = (d0 << 1) | (c3 >> 31);
+        zw[5] = (d1 << 1) | (d0 >> 31);
+        zw[6] = (d2 << 1) | (d1 >> 31);
+        zw[7] = (d3 << 1) | (d2 >> 31);
+
+        for (size_t i = 0; i < 4; i++) {
+            uint32_t lw = zw[i];
+            zw[i + 4] ^= lw ^ (lw >> 1) ^ (lw >> 2) ^ (lw >> 7);
+            zw[i + 3] ^= (lw << 31) ^ (lw << 30) ^ (lw << 25);
+        }
+
+        std::memcpy(yw, zw + 4, sizeof(yw));
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        ghash_store32(y + 12 - 4 * i, yw[i]);
+    }
+}
+#endif
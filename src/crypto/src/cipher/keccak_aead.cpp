@@ -0,0 +1,101 @@
+#include <ub/crypto/keccak_aead.hpp>
+
+#include <ub/crypto/utility.hpp>
+
+#include <algorithm>
+
+using namespace ub::crypto;
+
+static constexpr uint8_t KECCAK_AEAD_RATE   = keccak_aead::DATA_RATE + 1;   // the last rate byte is padding only
+static constexpr uint8_t KECCAK_AEAD_ROUNDS = 12;
+
+// Block types in order of processing
+static constexpr uint8_t KECCAK_AEAD_KEY    = 0;
+static constexpr uint8_t KECCAK_AEAD_AD     = 1;
+static constexpr uint8_t KECCAK_AEAD_MSG    = 2;
+
+/** Trailer byte: 'last block' bit and two block type bits followed by '1' padding bit */
+static uint8_t keccak_aead_trailer(uint8_t type, bool last) {
+    return 0x08 | (type << 1) | (last ? 1 : 0);
+}
+
+void keccak_aead::init(const uint8_t *key, const uint8_t *nonce) {
+    k.reset();
+    k.rate = KECCAK_AEAD_RATE;
+    k.rounds = KECCAK_AEAD_ROUNDS;
+
+    k.consume(key, KEY_LENGTH);
+    k.consume(nonce, NONCE_LENGTH);
+    k.finish(keccak_aead_trailer(KECCAK_AEAD_KEY, true));
+
+    m_phase = KECCAK_AEAD_AD;
+}
+
+void keccak_aead::beginBlock(uint8_t phase) {
+    if (m_phase != phase) {
+        k.finish(keccak_aead_trailer(m_phase, true));
+        m_phase = phase;
+    } else if (k.ptr == DATA_RATE) {
+        // block is padded only when more data follows, so the last block is always marked
+        k.finish(keccak_aead_trailer(phase, false));
+    }
+}
+
+void keccak_aead::authenticate(const uint8_t *data, size_t length) {
+    // associated data blocks could not follow message blocks
+    if (m_phase == KECCAK_AEAD_MSG) {
+        return;
+    }
+
+    while (length != 0) {
+        beginBlock(KECCAK_AEAD_AD);
+
+        size_t ll = std::min(length, DATA_RATE - k.ptr);
+        k.consume(data, ll);
+
+        data += ll;
+        length -= ll;
+    }
+}
+
+void keccak_aead::crypt(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt) {
+    while (length != 0) {
+        beginBlock(KECCAK_AEAD_MSG);
+
+        size_t ll = std::min(length, DATA_RATE - k.ptr);
+        k.duplex(dst, src, ll, decrypt);
+
+        src += ll;
+        dst += ll;
+        length -= ll;
+    }
+}
+
+void keccak_aead::encrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    crypt(dst, src, length, false);
+}
+
+void keccak_aead::decrypt(uint8_t *dst, const uint8_t *src, size_t length) {
+    crypt(dst, src, length, true);
+}
+
+void keccak_aead::finish(uint8_t *tag) {
+    if (m_phase != KECCAK_AEAD_MSG) {
+        k.finish(keccak_aead_trailer(m_phase, true));
+    }
+
+    k.finish(keccak_aead_trailer(KECCAK_AEAD_MSG, true));
+    k.produce(tag, TAG_LENGTH);
+
+    reset();
+}
+
+bool keccak_aead::verify(const uint8_t *tag) {
+    uint8_t expected[TAG_LENGTH];
+    finish(expected);
+
+    bool valid = secureCompare(expected, tag, TAG_LENGTH);
+    secureZero(expected, sizeof(expected));
+
+    return valid;
+}
@@ -0,0 +1,314 @@
+#include <ub/crypto/poly1305.hpp>
+#include <ub/crypto/utility.hpp>
+
+#include "poly1305_common.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Accumulator is kept partially reduced modulo p = 2^130 - 5 between blocks: limbs could slightly exceed their nominal
+// size, and value could exceed p. Limbs above 2^130 are folded back multiplied by 5, since 2^130 = 5 (mod p).
+
+#if UB_CRYPTO_POLY1305_64
+static constexpr uint64_t POLY1305_M44 = (1ull << 44) - 1;
+static constexpr uint64_t POLY1305_M42 = (1ull << 42) - 1;
+
+typedef unsigned __int128 poly1305_u128;
+
+static uint64_t poly1305_load64(const uint8_t *buf) {
+    uint64_t x;
+    std::memcpy(&x, buf, sizeof(x));    // assume little-endian system
+    return x;
+}
+
+static void poly1305_init_key(poly1305::state_t &st, const uint8_t *key) {
+    uint64_t t0 = poly1305_load64(key), t1 = poly1305_load64(key + 8);
+    uint64_t *r = st.u64 + POLY1305_ST_R;
+
+    // clamping is applied to the 44-bit limbs directly
+    r[0] = t0 & 0xFFC0FFFFFFF;
+    r[1] = ((t0 >> 44) | (t1 << 20)) & 0xFFFFFC0FFFF;
+    r[2] = (t1 >> 24) & 0x00FFFFFFC0F;
+
+    st.u64[POLY1305_ST_PAD + 0] = poly1305_load64(key + 16);
+    st.u64[POLY1305_ST_PAD + 1] = poly1305_load64(key + 24);
+}
+
+/** Compute `h = (h + m) * r` for every block, `hibit` is the 2^128 bit of the blocks relative to the last limb */
+static void poly1305_blocks(poly1305::state_t &st, const uint8_t *data, size_t blocks, uint64_t hibit) {
+    uint64_t *h = st.u64 + POLY1305_ST_H;
+    const uint64_t *r = st.u64 + POLY1305_ST_R;
+
+    uint64_t h0 = h[0], h1 = h[1], h2 = h[2];
+    uint64_t r0 = r[0], r1 = r[1], r2 = r[2];
+    uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+
+    for (; blocks != 0; blocks--, data += poly1305::BLOCK) {
+        uint64_t t0 = poly1305_load64(data), t1 = poly1305_load64(data + 8);
+
+        h0 += t0 & POLY1305_M44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & POLY1305_M44;
+        h2 += ((t1 >> 24) & POLY1305_M42) | hibit;
+
+        poly1305_u128 d0 = (poly1305_u128) h0 * r0 + (poly1305_u128) h1 * s2 + (poly1305_u128) h2 * s1;
+        poly1305_u128 d1 = (poly1305_u128) h0 * r1 + (poly1305_u128) h1 * r0 + (poly1305_u128) h2 * s2;
+        poly1305_u128 d2 = (poly1305_u128) h0 * r2 + (poly1305_u128) h1 * r1 + (poly1305_u128) h2 * r0;
+
+        uint64_t c = (uint64_t) (d0 >> 44);
+        h0 = (uint64_t) d0 & POLY1305_M44;
+        d1 += c;
+
+        c = (uint64_t) (d1 >> 44);
+        h1 = (uint64_t) d1 & POLY1305_M44;
+        d2 += c;
+
+        c = (uint64_t) (d2 >> 42);
+        h2 = (uint64_t) d2 & POLY1305_M42;
+        h0 += c * 5;
+
+        c = h0 >> 44;
+        h0 &= POLY1305_M44;
+        h1 += c;
+    }
+
+    h[0] = h0;
+    h[1] = h1;
+    h[2] = h2;
+}
+
+static void poly1305_finish(poly1305::state_t &st, uint8_t *tag) {
+    const uint64_t *h = st.u64 + POLY1305_ST_H;
+    uint64_t h0 = h[0], h1 = h[1], h2 = h[2];
+
+    // fully carry accumulator
+    uint64_t c = h1 >> 44; h1 &= POLY1305_M44;
+    h2 += c; c = h2 >> 42; h2 &= POLY1305_M42;
+    h0 += c * 5; c = h0 >> 44; h0 &= POLY1305_M44;
+    h1 += c; c = h1 >> 44; h1 &= POLY1305_M44;
+    h2 += c; c = h2 >> 42; h2 &= POLY1305_M42;
+    h0 += c * 5; c = h0 >> 44; h0 &= POLY1305_M44;
+    h1 += c;
+
+    // g = h + 5 - 2^130, select it in constant time when no borrow occurred (h >= p)
+    uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= POLY1305_M44;
+    uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= POLY1305_M44;
+    uint64_t g2 = h2 + c - (1ull << 42);
+
+    uint64_t mask = (g2 >> 63) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+
+    // h + pad mod 2^128
+    uint64_t t0 = st.u64[POLY1305_ST_PAD], t1 = st.u64[POLY1305_ST_PAD + 1];
+    h0 += t0 & POLY1305_M44; c = h0 >> 44; h0 &= POLY1305_M44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & POLY1305_M44) + c; c = h1 >> 44; h1 &= POLY1305_M44;
+    h2 += ((t1 >> 24) & POLY1305_M42) + c;
+
+    uint64_t out[2] = { h0 | (h1 << 44), (h1 >> 20) | (h2 << 24) };
+    std::memcpy(tag, out, sizeof(out));     // assume little-endian system
+}
+#else
+static constexpr uint32_t POLY1305_M26 = (1u << 26) - 1;
+
+static uint32_t poly1305_load32(const uint8_t *buf) {
+    uint32_t x;
+    std::memcpy(&x, buf, sizeof(x));    // assume little-endian system
+    return x;
+}
+
+static void poly1305_init_key(poly1305::state_t &st, const uint8_t *key) {
+    uint32_t *r = st.u32 + POLY1305_ST_R;
+
+    // clamping is applied to the 26-bit limbs directly
+    r[0] = (poly1305_load32(key + 0)) & 0x3FFFFFF;
+    r[1] = (poly1305_load32(key + 3) >> 2) & 0x3FFFF03;
+    r[2] = (poly1305_load32(key + 6) >> 4) & 0x3FFC0FF;
+    r[3] = (poly1305_load32(key + 9) >> 6) & 0x3F03FFF;
+    r[4] = (poly1305_load32(key + 12) >> 8) & 0x00FFFFF;
+
+    for (size_t i = 0; i < 4; i++) {
+        st.u32[POLY1305_ST_PAD + i] = poly1305_load32(key + 16 + 4 * i);
+    }
+}
+
+/** Compute `h = (h + m) * r` for every block, `hibit` is the 2^128 bit of the blocks relative to the last limb */
+static void poly1305_blocks(poly1305::state_t &st, const uint8_t *data, size_t blocks, uint32_t hibit) {
+    uint32_t *h = st.u32 + POLY1305_ST_H;
+    const uint32_t *r = st.u32 + POLY1305_ST_R;
+
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    uint32_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+
+    for (; blocks != 0; blocks--, data += poly1305::BLOCK) {
+        h0 += (poly1305_load32(data + 0)) & POLY1305_M26;
+        h1 += (poly1305_load32(data + 3) >> 2) & POLY1305_M26;
+        h2 += (poly1305_load32(data + 6) >> 4) & POLY1305_M26;
+        h3 += (poly1305_load32(data + 9) >> 6) & POLY1305_M26;
+        h4 += (poly1305_load32(data + 12) >> 8) | hibit;
+
+        uint64_t d0 = (uint64_t) h0 * r0 + (uint64_t) h1 * s4 + (uint64_t) h2 * s3 + (uint64_t) h3 * s2
+                      + (uint64_t) h4 * s1;
+        uint64_t d1 = (uint64_t) h0 * r1 + (uint64_t) h1 * r0 + (uint64_t) h2 * s4 + (uint64_t) h3 * s3
+                      + (uint64_t) h4 * s2;
+        uint64_t d2 = (uint64_t) h0 * r2 + (uint64_t) h1 * r1 + (uint64_t) h2 * r0 + (uint64_t) h3 * s4
+                      + (uint64_t) h4 * s3;
+        uint64_t d3 = (uint64_t) h0 * r3 + (uint64_t) h1 * r2 + (uint64_t) h2 * r1 + (uint64_t) h3 * r0
+                      + (uint64_t) h4 * s4;
+        uint64_t d4 = (uint64_t) h0 * r4 + (uint64_t) h1 * r3 + (uint64_t) h2 * r2 + (uint64_t) h3 * r1
+                      + (uint64_t) h4 * r0;
+
+        uint32_t c = (uint32_t) (d0 >> 26); h0 = (uint32_t) d0 & POLY1305_M26;
+        d1 += c; c = (uint32_t) (d1 >> 26); h1 = (uint32_t) d1 & POLY1305_M26;
+        d2 += c; c = (uint32_t) (d2 >> 26); h2 = (uint32_t) d2 & POLY1305_M26;
+        d3 += c; c = (uint32_t) (d3 >> 26); h3 = (uint32_t) d3 & POLY1305_M26;
+        d4 += c; c = (uint32_t) (d4 >> 26); h4 = (uint32_t) d4 & POLY1305_M26;
+        h0 += c * 5; c = h0 >> 26; h0 &= POLY1305_M26;
+        h1 += c;
+    }
+
+    h[0] = h0;
+    h[1] = h1;
+    h[2] = h2;
+    h[3] = h3;
+    h[4] = h4;
+}
+
+static void poly1305_finish(poly1305::state_t &st, uint8_t *tag) {
+    const uint32_t *h = st.u32 + POLY1305_ST_H;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+
+    // fully carry accumulator
+    uint32_t c = h1 >> 26; h1 &= POLY1305_M26;
+    h2 += c; c = h2 >> 26; h2 &= POLY1305_M26;
+    h3 += c; c = h3 >> 26; h3 &= POLY1305_M26;
+    h4 += c; c = h4 >> 26; h4 &= POLY1305_M26;
+    h0 += c * 5; c = h0 >> 26; h0 &= POLY1305_M26;
+    h1 += c;
+
+    // g = h + 5 - 2^130, select it in constant time when no borrow occurred (h >= p)
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= POLY1305_M26;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= POLY1305_M26;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= POLY1305_M26;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= POLY1305_M26;
+    uint32_t g4 = h4 + c - (1u << 26);
+
+    uint32_t mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // pack into 32-bit words and add pad mod 2^128
+    uint32_t w[4] = {
+        h0 | (h1 << 26),
+        (h1 >> 6) | (h2 << 20),
+        (h2 >> 12) | (h3 << 14),
+        (h3 >> 18) | (h4 << 8)
+    };
+
+    uint64_t f = 0;
+    for (size_t i = 0; i < 4; i++) {
+        f += (uint64_t) w[i] + st.u32[POLY1305_ST_PAD + i];
+        w[i] = (uint32_t) f;
+        f >>= 32;
+    }
+
+    std::memcpy(tag, w, sizeof(w));     // assume little-endian system
+    secureZero(w, sizeof(w));
+}
+#endif
+
+#if UB_CRYPTO_POLY1305_AVX2
+static void poly1305_blocks_full(poly1305::state_t &st, const uint8_t *data, size_t blocks) {
+    if (blocks >= POLY1305_AVX2_MIN_BLOCKS && (cpuFeatures() & CPU_X86_AVX2)) {
+        size_t done = poly1305BlocksAVX2(st, data, blocks);
+        data += done * poly1305::BLOCK;
+        blocks -= done;
+    }
+
+    poly1305_blocks(st, data, blocks, 1ull << 40);
+}
+#elif UB_CRYPTO_POLY1305_64
+static void poly1305_blocks_full(poly1305::state_t &st, const uint8_t *data, size_t blocks) {
+    poly1305_blocks(st, data, blocks, 1ull << 40);
+}
+#else
+static void poly1305_blocks_full(poly1305::state_t &st, const uint8_t *data, size_t blocks) {
+    poly1305_blocks(st, data, blocks, 1u << 24);
+}
+#endif
+
+poly1305::poly1305(): m_state {}, m_buffer {} {
+    m_bufferPos = 0;
+}
+
+void poly1305::reset() {
+    secureZero(&m_state, sizeof(m_state));
+    secureZero(m_buffer, sizeof(m_buffer));
+    m_bufferPos = 0;
+}
+
+void poly1305::init(const uint8_t *key) {
+    std::memset(&m_state, 0, sizeof(m_state));
+    poly1305_init_key(m_state, key);
+    m_bufferPos = 0;
+
+#if UB_CRYPTO_POLY1305_AVX2
+    poly1305PowersAVX2(m_state);
+#endif
+}
+
+void poly1305::update(const uint8_t *data, size_t length) {
+    if (m_bufferPos != 0) {
+        size_t len = std::min(length, BLOCK - m_bufferPos);
+        std::memcpy(m_buffer + m_bufferPos, data, len);
+
+        data += len;
+        length -= len;
+        m_bufferPos += len;
+
+        if (m_bufferPos != BLOCK) {
+            return;
+        }
+
+        poly1305_blocks_full(m_state, m_buffer, 1);
+        m_bufferPos = 0;
+    }
+
+    size_t blocks = length / BLOCK;
+    poly1305_blocks_full(m_state, data, blocks);
+
+    data += blocks * BLOCK;
+    length -= blocks * BLOCK;
+
+    std::memcpy(m_buffer, data, length);
+    m_bufferPos = length;
+}
+
+void poly1305::pad() {
+    if (m_bufferPos == 0) {
+        return;
+    }
+
+    std::memset(m_buffer + m_bufferPos, 0, BLOCK - m_bufferPos);
+    poly1305_blocks_full(m_state, m_buffer, 1);
+    m_bufferPos = 0;
+}
+
+void poly1305::finish(uint8_t *tag) {
+    if (m_bufferPos != 0) {
+        // final partial block is padded with a single one bit instead of the 2^128 one
+        m_buffer[m_bufferPos] = 1;
+        std::memset(m_buffer + m_bufferPos + 1, 0, BLOCK - m_bufferPos - 1);
+        poly1305_blocks(m_state, m_buffer, 1, 0);
+    }
+
+    poly1305_finish(m_state, tag);
+    reset();
+}
@@ -0,0 +1,57 @@
+#ifndef UB_SRC_CRYPTO_CIPHER_POLY1305_COMMON_H
+#define UB_SRC_CRYPTO_CIPHER_POLY1305_COMMON_H
+
+#include <ub/crypto/poly1305.hpp>
+
+#include "../cpu.hpp"
+
+// Poly1305 arithmetic: three 44-bit limbs with 128-bit products on hosts, five 26-bit limbs with 64-bit products
+// otherwise. Can be overridden by defining UB_CRYPTO_POLY1305_64 to 0 (or to 1 when 128-bit integers are available).
+#if !defined(UB_CRYPTO_POLY1305_64)
+#if defined(__SIZEOF_INT128__)
+#define UB_CRYPTO_POLY1305_64       1
+#else
+#define UB_CRYPTO_POLY1305_64       0
+#endif
+#endif
+
+// 4-way AVX2 block function converts accumulator from and to 44-bit limbs
+#if defined(__x86_64__) && UB_CRYPTO_POLY1305_64
+#define UB_CRYPTO_POLY1305_AVX2     1
+#else
+#define UB_CRYPTO_POLY1305_AVX2     0
+#endif
+
+namespace ub::crypto::impl {
+#if UB_CRYPTO_POLY1305_64
+    // `state_t::u64` indices
+    constexpr size_t POLY1305_ST_H      = 0;    //! Accumulator, 3 limbs
+    constexpr size_t POLY1305_ST_R      = 3;    //! Clamped key, 3 limbs
+    constexpr size_t POLY1305_ST_PAD    = 6;    //! Final pad as two 64-bit words
+
+    // `state_t::u32` index of key powers r^1 .. r^4 as 5 limbs of 26 bits each, used by AVX2 code
+    constexpr size_t POLY1305_ST_POWERS = 16;
+#else
+    // `state_t::u32` indices
+    constexpr size_t POLY1305_ST_H      = 0;    //! Accumulator, 5 limbs
+    constexpr size_t POLY1305_ST_R      = 5;    //! Clamped key, 5 limbs
+    constexpr size_t POLY1305_ST_PAD    = 10;   //! Final pad as four 32-bit words
+#endif
+
+#if UB_CRYPTO_POLY1305_AVX2
+    /** Minimal number of blocks worth converting accumulator for AVX2 code */
+    constexpr size_t POLY1305_AVX2_MIN_BLOCKS = 16;
+
+    /**
+     * Hash whole 16-byte blocks (with the 2^128 bit set) four at a time, key powers must be present in the state.
+     *
+     * @return Number of processed blocks, a multiple of four
+     */
+    size_t poly1305BlocksAVX2(poly1305::state_t &st, const uint8_t *data, size_t blocks);
+
+    /** Compute key powers for `poly1305BlocksAVX2()` from the clamped key */
+    void poly1305PowersAVX2(poly1305::state_t &st);
+#endif
+}
+
+#endif // UB_SRC_CRYPTO_CIPHER_POLY1305_COMMON_H
@@ -0,0 +1,201 @@
+#include "poly1305_common.hpp"
+
+#if UB_CRYPTO_POLY1305_AVX2
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#define TARGET_AVX2 [[gnu::target("avx2")]]
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Message is split into four interleaved streams, lane `j` accumulates blocks `j`, `j + 4`, `j + 8` and so on:
+//   A_j = A_j * r^4 + m_j
+// Blocks are processed in lanes ordered as (0, 2, 1, 3), which is the natural order of 64-bit unpack instructions.
+// After the last group lanes are multiplied by their own powers (r^4, r^2, r^3, r^1) and summed, which equals
+// the sequential evaluation. Lanes hold five 26-bit limbs, so products fit 64 bits with plenty of headroom.
+
+static constexpr uint64_t POLY1305_M26 = (1ull << 26) - 1;
+static constexpr uint64_t POLY1305_M44 = (1ull << 44) - 1;
+
+typedef unsigned __int128 poly1305_u128;
+
+/** Convert partially reduced 44-bit limbs into 26-bit limbs, the top limb could exceed 26 bits */
+static void poly1305_limbs26(uint32_t *l, const uint64_t *h) {
+    poly1305_u128 v = h[0] + ((poly1305_u128) h[1] << 44);
+    l[0] = (uint32_t) v & POLY1305_M26; v >>= 26;
+    l[1] = (uint32_t) v & POLY1305_M26; v >>= 26;
+    l[2] = (uint32_t) v & POLY1305_M26; v >>= 26;
+
+    v += (poly1305_u128) h[2] << 10;
+    l[3] = (uint32_t) v & POLY1305_M26; v >>= 26;
+    l[4] = (uint32_t) v;
+}
+
+/** Convert carried 26-bit limbs into 44-bit limbs */
+static void poly1305_limbs44(uint64_t *h, const uint64_t *l) {
+    poly1305_u128 v = l[0] + ((poly1305_u128) l[1] << 26) + ((poly1305_u128) l[2] << 52);
+    h[0] = (uint64_t) v & POLY1305_M44; v >>= 44;
+
+    v += (poly1305_u128) l[3] << 34;
+    h[1] = (uint64_t) v & POLY1305_M44; v >>= 44;
+
+    v += (poly1305_u128) l[4] << 16;
+    h[2] = (uint64_t) v;
+}
+
+/** Partially carry 26-bit limbs of a product */
+static void poly1305_carry(uint64_t *d) {
+    uint64_t c;
+    c = d[0] >> 26; d[0] &= POLY1305_M26; d[1] += c;
+    c = d[1] >> 26; d[1] &= POLY1305_M26; d[2] += c;
+    c = d[2] >> 26; d[2] &= POLY1305_M26; d[3] += c;
+    c = d[3] >> 26; d[3] &= POLY1305_M26; d[4] += c;
+    c = d[4] >> 26; d[4] &= POLY1305_M26; d[0] += c * 5;
+    c = d[0] >> 26; d[0] &= POLY1305_M26; d[1] += c;
+}
+
+/** Scalar `a = a * b` with 26-bit limbs */
+static void poly1305_mul26(uint32_t *a, const uint32_t *b) {
+    uint64_t s[5], d[5];
+    for (size_t i = 1; i < 5; i++) {
+        s[i] = (uint64_t) b[i] * 5;
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        d[i] = 0;
+        for (size_t j = 0; j < 5; j++) {
+            d[i] += (uint64_t) a[j] * (j <= i ? b[i - j] : s[5 + i - j]);
+        }
+    }
+
+    poly1305_carry(d);
+    for (size_t i = 0; i < 5; i++) {
+        a[i] = (uint32_t) d[i];
+    }
+}
+
+void ub::crypto::impl::poly1305PowersAVX2(poly1305::state_t &st) {
+    uint32_t *p = st.u32 + POLY1305_ST_POWERS;
+    poly1305_limbs26(p, st.u64 + POLY1305_ST_R);
+
+    for (size_t k = 1; k < 4; k++) {
+        std::memcpy(p + 5 * k, p + 5 * (k - 1), 5 * sizeof(uint32_t));
+        poly1305_mul26(p + 5 * k, p);
+    }
+}
+
+/** Load four blocks into 26-bit limbs of lanes ordered as (0, 2, 1, 3), with the 2^128 bit set */
+TARGET_AVX2
+static inline void poly1305_load4(__m256i *m, const uint8_t *data) {
+    const __m256i mask = _mm256_set1_epi64x(POLY1305_M26);
+
+    __m256i a = _mm256_loadu_si256((const __m256i *) data);
+    __m256i b = _mm256_loadu_si256((const __m256i *) (data + 32));
+    __m256i t0 = _mm256_unpacklo_epi64(a, b);
+    __m256i t1 = _mm256_unpackhi_epi64(a, b);
+
+    m[0] = _mm256_and_si256(t0, mask);
+    m[1] = _mm256_and_si256(_mm256_srli_epi64(t0, 26), mask);
+    m[2] = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(t0, 52), _mm256_slli_epi64(t1, 12)), mask);
+    m[3] = _mm256_and_si256(_mm256_srli_epi64(t1, 14), mask);
+    m[4] = _mm256_or_si256(_mm256_srli_epi64(t1, 40), _mm256_set1_epi64x(1 << 24));
+}
+
+/** Products `d = a * r` of 26-bit limbs without carry, `s = 5 * r` */
+TARGET_AVX2
+static inline void poly1305_mul4(__m256i *d, const __m256i *a, const __m256i *r, const __m256i *s) {
+#pragma GCC unroll 5
+    for (size_t i = 0; i < 5; i++) {
+        d[i] = _mm256_mul_epu32(a[0], r[i]);
+
+#pragma GCC unroll 4
+        for (size_t j = 1; j < 5; j++) {
+            d[i] = _mm256_add_epi64(d[i], _mm256_mul_epu32(a[j], j <= i ? r[i - j] : s[5 + i - j]));
+        }
+    }
+}
+
+TARGET_AVX2
+static inline void poly1305_carry4(__m256i *d) {
+    const __m256i mask = _mm256_set1_epi64x(POLY1305_M26);
+    __m256i c;
+
+#pragma GCC unroll 4
+    for (size_t i = 0; i < 4; i++) {
+        c = _mm256_srli_epi64(d[i], 26);
+        d[i] = _mm256_and_si256(d[i], mask);
+        d[i + 1] = _mm256_add_epi64(d[i + 1], c);
+    }
+
+    c = _mm256_srli_epi64(d[4], 26);
+    d[4] = _mm256_and_si256(d[4], mask);
+    d[0] = _mm256_add_epi64(d[0], _mm256_add_epi64(c, _mm256_slli_epi64(c, 2)));
+
+    c = _mm256_srli_epi64(d[0], 26);
+    d[0] = _mm256_and_si256(d[0], mask);
+    d[1] = _mm256_add_epi64(d[1], c);
+}
+
+TARGET_AVX2
+size_t ub::crypto::impl::poly1305BlocksAVX2(poly1305::state_t &st, const uint8_t *data, size_t blocks) {
+    blocks &= ~(size_t) 3;
+    if (blocks == 0) {
+        return 0;
+    }
+
+    const uint32_t *p = st.u32 + POLY1305_ST_POWERS;
+    uint64_t *h = st.u64 + POLY1305_ST_H;
+
+    // r^4 in all lanes, and lane powers in block order (0, 2, 1, 3)
+    __m256i r4[5], s4[5], rl[5], sl[5];
+#pragma GCC unroll 5
+    for (size_t i = 0; i < 5; i++) {
+        r4[i] = _mm256_set1_epi64x(p[15 + i]);
+        s4[i] = _mm256_set1_epi64x(p[15 + i] * 5ull);
+        rl[i] = _mm256_set_epi64x(p[i], p[10 + i], p[5 + i], p[15 + i]);
+        sl[i] = _mm256_mul_epu32(rl[i], _mm256_set1_epi64x(5));
+    }
+
+    uint32_t h26[5];
+    poly1305_limbs26(h26, h);
+
+    __m256i a[5], d[5];
+    poly1305_load4(a, data);
+
+#pragma GCC unroll 5
+    for (size_t i = 0; i < 5; i++) {
+        a[i] = _mm256_add_epi64(a[i], _mm256_set_epi64x(0, 0, 0, h26[i]));
+    }
+
+    for (size_t done = 4; done < blocks; done += 4) {
+        __m256i m[5];
+        poly1305_mul4(d, a, r4, s4);
+        poly1305_carry4(d);
+        poly1305_load4(m, data + done * poly1305::BLOCK);
+
+#pragma GCC unroll 5
+        for (size_t i = 0; i < 5; i++) {
+            a[i] = _mm256_add_epi64(d[i], m[i]);
+        }
+    }
+
+    poly1305_mul4(d, a, rl, sl);
+
+    // horizontal sum of lanes, products are below 2^59 so the sum could not overflow
+    uint64_t l[5];
+#pragma GCC unroll 5
+    for (size_t i = 0; i < 5; i++) {
+        __m128i x = _mm_add_epi64(_mm256_castsi256_si128(d[i]), _mm256_extracti128_si256(d[i], 1));
+        x = _mm_add_epi64(x, _mm_unpackhi_epi64(x, x));
+        l[i] = (uint64_t) _mm_cvtsi128_si64(x);
+    }
+
+    poly1305_carry(l);
+    poly1305_limbs44(h, l);
+    return blocks;
+}
+
+#endif // UB_CRYPTO_POLY1305_AVX2
@@ -0,0 +1,107 @@
+#include "cpu.hpp"
+
+#if UB_CRYPTO_X86
+#include <cpuid.h>
+#endif
+
+#if UB_CRYPTO_ARM64 && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+using namespace ub::crypto::impl;
+
+static uint32_t cpu_features_mask = UINT32_MAX;
+
+#if UB_CRYPTO_X86
+static uint32_t cpu_detect_features() {
+    uint32_t a, b, c, d;
+    uint32_t r = 0;
+
+    if (!__get_cpuid(1, &a, &b, &c, &d)) {
+        return 0;
+    }
+
+    // AVX requires both CPU support and OS support for saving YMM registers (XCR0 bits 1 and 2)
+    bool osAvx = false;
+    if ((c & bit_OSXSAVE) && (c & bit_AVX)) {
+        uint32_t xcr0, xcr0h;
+        __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0h) : "c" (0));
+        osAvx = (xcr0 & 0x6) == 0x6;
+    }
+
+    if (d & bit_SSE2) {
+        r |= CPU_X86_SSE2;
+    }
+
+    bool sse41 = (c & bit_SSSE3) && (c & bit_SSE4_1);
+    if (sse41) {
+        r |= CPU_X86_SSE41;
+    }
+
+    if (sse41 && (c & bit_AES) && (c & bit_PCLMUL)) {
+        r |= CPU_X86_AES;
+    }
+
+    if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+        if (osAvx && (b & bit_AVX2)) {
+            r |= CPU_X86_AVX2;
+        }
+
+        if (sse41 && (b & bit_SHA)) {
+            r |= CPU_X86_SHA;
+        }
+    }
+
+    return r;
+}
+#elif UB_CRYPTO_ARM64
+static uint32_t cpu_detect_features() {
+    uint32_t r = 0;
+
+#if defined(__ARM_FEATURE_SHA2)
+    r |= CPU_ARM64_SHA2;
+#endif
+
+#if defined(__ARM_FEATURE_SHA512)
+    r |= CPU_ARM64_SHA512;
+#endif
+
+#if defined(__ARM_FEATURE_AES)     // implies PMULL
+    r |= CPU_ARM64_AES;
+#endif
+
+#if defined(__linux__)
+    // HWCAP_xxx constants are spelled out as they are missing from older kernel headers
+    unsigned long hwcap = getauxval(AT_HWCAP);
+
+    if ((hwcap & (3UL << 3)) == (3UL << 3)) {   // HWCAP_AES | HWCAP_PMULL
+        r |= CPU_ARM64_AES;
+    }
+
+    if (hwcap & (1UL << 6)) {           // HWCAP_SHA2
+        r |= CPU_ARM64_SHA2;
+    }
+
+    if (hwcap & (1UL << 21)) {          // HWCAP_SHA512
+        r |= CPU_ARM64_SHA512;
+    }
+#endif
+
+    return r;
+}
+#endif
+
+#if UB_CRYPTO_X86 || UB_CRYPTO_ARM64
+uint32_t ub::crypto::impl::cpuFeatures() {
+    static const uint32_t features = cpu_detect_features();
+    return features & cpu_features_mask;
+}
+#else
+uint32_t ub::crypto::impl::cpuFeatures() {
+    return 0;
+}
+#endif
+
+void ub::crypto::impl::cpuRestrictFeatures(uint32_t mask) {
+    cpu_features_mask = mask;
+}
@@ -0,0 +1,47 @@
+#ifndef UB_SRC_CRYPTO_CPU_H
+#define UB_SRC_CRYPTO_CPU_H
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UB_CRYPTO_X86 1
+#else
+#define UB_CRYPTO_X86 0
+#endif
+
+#if defined(__aarch64__)
+#define UB_CRYPTO_ARM64 1
+#else
+#define UB_CRYPTO_ARM64 0
+#endif
+
+namespace ub::crypto::impl {
+    enum : uint32_t {
+        CPU_X86_AVX2    = 1 << 0,   //! AVX2 instructions, including OS support for YMM state
+        CPU_X86_SHA     = 1 << 1,   //! SHA extensions (together with SSSE3 and SSE4.1 they depend on)
+        CPU_X86_SSE41   = 1 << 2,   //! SSE4.1 instructions (together with SSSE3)
+        CPU_X86_AES     = 1 << 3,   //! AES-NI and PCLMULQDQ instructions (together with SSSE3 and SSE4.1)
+        CPU_X86_SSE2    = 1 << 4,   //! SSE2 instructions (always present on x86-64)
+
+        CPU_ARM64_SHA2   = 1 << 16, //! ARMv8 SHA-1 and SHA-256 instructions
+        CPU_ARM64_SHA512 = 1 << 17, //! ARMv8.2 SHA-512 instructions
+        CPU_ARM64_AES    = 1 << 18, //! ARMv8 AES and 64-bit PMULL instructions
+    };
+
+    /**
+     * Detect instruction set extensions of the running processor. Detection is done on the first call, subsequent
+     * calls return cached value. Returns zero on targets without runtime detection (i.e. microcontrollers).
+     * On AArch64 features are detected with `getauxval()` on Linux and taken from compiler flags otherwise.
+     *
+     * @return Bit mask of `CPU_xxx` constants
+     */
+    uint32_t cpuFeatures();
+
+    /**
+     * Restrict set of features reported by `cpuFeatures()`, forcing implementations to choose fallback code paths.
+     * Intended to be used by tests to cover every available backend.
+     */
+    void cpuRestrictFeatures(uint32_t mask);
+}
+
+#endif // UB_SRC_CRYPTO_CPU_H
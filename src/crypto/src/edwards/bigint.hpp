@@ -98,35 +98,35 @@ namespace ub::crypto::impl {
     static_assert(std::is_trivially_copyable_v<uint256_t>, "uint256_t must be trivially copyable");
 
     /**
-     * Perform modular exponentiation with a constant exponent. Exponent is specified in compressed binary form,
-     * starting from most significant bit with first most significant '1' bit dropped. LSB of exponent entry encodes
-     * actual bit value (0 or 1), MSBs encode repetition count. Exponent must be terminated with null byte.
-     *
-     * Depending on the number of swaps (which is determined by number of zero bits in exponent) final result might be
-     * either in `r` or in `s`. If exponent has even number of zero bits, result is in `r`. Otherwise, result is in `s`.
+     * Recode `x` into width-`w` non-adjacent form, so `x = sum(r[i] * 2^i)` where every non-zero digit is odd and
+     * less than `2^(w-1)` in magnitude, and any `w` consecutive digits contain at most one non-zero digit. `r` must
+     * have `N_bits` entries and `x` must be less than `2^(N_bits-1)`. Runs in variable time, use for public data only.
      */
-    template <typename F, typename uint_t = typename F::uint_t>
-    void bigint_pow_rle(uint_t &r, uint_t &s, const uint_t &x, const uint8_t *exponent) {
-        uint_t *a = &s;
-        uint_t *b = &r;
-
-        std::memcpy(r.u8, x.u8, sizeof(r.u8));
-
-        uint8_t i;
-        while ((i = *exponent) != 0) {
-            while (i > 1) {
-                F::mul(*a, *b, *b);
+    template <size_t N_bits>
+    void bigint_wnaf(int8_t *r, const bigint_t<N_bits> &x, uint8_t w) {
+        std::memset(r, 0, N_bits);
+
+        uint32_t carry = 0;
+        for (size_t pos = 0; pos < N_bits;) {
+            uint32_t window = carry;
+            for (size_t j = 0; j < w && pos + j < N_bits; j++) {
+                window += ((x.u8[(pos + j) >> 3] >> ((pos + j) & 7)) & 1) << j;
+            }
 
-                if (i & 1) {
-                    F::mul(*b, *a, x);
-                } else {
-                    std::swap(a, b);
-                }
+            if ((window & 1) == 0) {
+                pos++;
+                continue;
+            }
 
-                i -= 2;
+            if (window < (1u << (w - 1))) {
+                r[pos] = (int8_t) window;
+                carry = 0;
+            } else {
+                r[pos] = (int8_t) (window - (1u << w));
+                carry = 1;
             }
 
-            exponent++;
+            pos += w;
         }
     }
 }
@@ -1,17 +1,9 @@
 #include "ed25519.hpp"
 
-using namespace ub::crypto::impl;
-
-static constexpr uint256_t ed25519_d {
-    uint256_t::from_u8,
-    0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
-    0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52
-};
+#include <algorithm>
+#include <iterator>
 
-static const uint8_t ed25519_base_x[32] {
-    0x1A, 0xD5, 0x25, 0x8F, 0x60, 0x2D, 0x56, 0xC9, 0xB2, 0xA7, 0x25, 0x95, 0x60, 0xC7, 0x2C, 0x69,
-    0x5C, 0xDC, 0xD6, 0xFD, 0x31, 0xE2, 0xA4, 0xC0, 0xFE, 0x53, 0x6E, 0xCD, 0xD3, 0x36, 0x69, 0x21
-};
+using namespace ub::crypto::impl;
 
 static constexpr uint256_t ed25519_sqrt_k { // 2^((p-1)/4) mod p
     uint256_t::from_u8,
@@ -43,26 +35,26 @@ bool ed25519_pt::load(const uint8_t *buffer) {
     z = 1;
 
     // Compute candidate root:
-    F25519::mul(tt[0], y, y);               // tt[0]: y^2
+    F25519::sqr(tt[0], y);                  // tt[0]: y^2
     F25519::sub(tt[1], tt[0], z);           // tt[1]: u = y^2 - 1
     F25519::normalize(tt[1]);
 
-    F25519::mul(tt[2], tt[0], ed25519_d);   // tt[2]: d y^2
+    F25519::mul(tt[2], tt[0], ED25519_D);   // tt[2]: d y^2
     F25519::add(tt[0], tt[2], z);           // tt[0]: v = d y^2 + 1
 
-    F25519::mul(tt[2], tt[0], tt[0]);       // tt[2]: v^2
-    F25519::mul(tt[3], tt[2], tt[2]);       // tt[3]: v^4
+    F25519::sqr(tt[2], tt[0]);              // tt[2]: v^2
+    F25519::sqr(tt[3], tt[2]);              // tt[3]: v^4
     F25519::mul(tt[4], tt[3], tt[2]);       // tt[4]: v^6
     F25519::mul(tt[2], tt[4], tt[0]);       // tt[2]: v^7
     F25519::mul(tt[3], tt[2], tt[1]);       // tt[3]: u v^7
     F25519::pow58(tt[2], tt[3]);            // tt[2]: (u v^7)^((p-5)/8)
     F25519::mul(tt[3], tt[2], tt[1]);       // tt[3]: u P58(u v^7)
-    F25519::mul(tt[2], tt[0], tt[0]);       // tt[2]: v^2
+    F25519::sqr(tt[2], tt[0]);              // tt[2]: v^2
     F25519::mul(tt[4], tt[2], tt[0]);       // tt[4]: v^3
     F25519::mul(tt[2], tt[4], tt[3]);       // tt[2]: x (candidate)
 
     // Compute v x^2 to check whether it's a root
-    F25519::mul(tt[3], tt[2], tt[2]);       // tt[3]: x^2
+    F25519::sqr(tt[3], tt[2]);              // tt[3]: x^2
     F25519::mul(tt[4], tt[3], tt[0]);       // tt[4]: v x^2
     F25519::normalize(tt[4]);
 
@@ -126,11 +118,8 @@ void ed25519_pt::destroy() {
 }
 
 void ed25519_pt::loadBase() {
-    // y = 0x6666....6658
-    std::memset(y.u8, 0x66, uint256_t::N_U8);
-    y.u8[0] = 0x58;
-
-    std::memcpy(x.u8, ed25519_base_x, uint256_t::N_U8);
+    x = ED25519_BASE_X;
+    y = ED25519_BASE_Y;
 
     z = 1;
     F25519::mul(t, x, y);
@@ -165,7 +154,7 @@ static void ed25519_add_impl(ed25519_pt &r, const ed25519_pt &p1, const ed25519_
     F25519::add(t[1], t[3], t[2]);  // t[1]: H=B+A
 
     F25519::mul(t[2], p1.t, p2.t);
-    F25519::mul(t[3], t[2], ed25519_d);
+    F25519::mul(t[3], t[2], ED25519_D);
     F25519::add(t[2], t[3], t[3]);  // t[2]: C=2*d*T1*T2
 
     F25519::mul(t[3], p1.z, p2.z);
@@ -181,17 +170,17 @@ static void ed25519_add_impl(ed25519_pt &r, const ed25519_pt &p1, const ed25519_
 }
 
 static void ed25519_double(ed25519_pt &r, const ed25519_pt &a, uint256_t *t) {
-    F25519::mul(t[0], a.x, a.x);    // t[0]: A=X^2
-    F25519::mul(t[1], a.y, a.y);    // t[1]: B=Y^2
+    F25519::sqr(t[0], a.x);         // t[0]: A=X^2
+    F25519::sqr(t[1], a.y);         // t[1]: B=Y^2
     F25519::add(t[2], t[0], t[1]);  // t[2]: H=A+B
     F25519::sub(t[3], t[0], t[1]);  // t[3]: G=A-B
 
-    F25519::mul(t[1], a.z, a.z);
+    F25519::sqr(t[1], a.z);
     F25519::add(t[0], t[1], t[1]);  // t[0]: C=2*Z^2
     F25519::add(t[0], t[0], t[3]);  // t[0]: F=C+G
 
     F25519::add(t[1], a.x, a.y);
-    F25519::mul(t[4], t[1], t[1]);
+    F25519::sqr(t[4], t[1]);
     F25519::sub(t[1], t[2], t[4]);  // t[1]: E=H-(X+Y)^2
 
     F25519::mul(r.x, t[1], t[0]);   // X3=E*F
@@ -225,3 +214,280 @@ void ED25519::mul(ed25519_pt &r, const ed25519_pt &x, const uint256_t &k) {
 
     ub::crypto::secureZero(t, sizeof(t));
 }
+
+static void ed25519_add_niels(ed25519_pt &r, const ed25519_pt &p, const ed25519_niels &q, uint256_t *t) {
+    F25519::sub(t[0], p.y, p.x);
+    F25519::mul(t[2], t[0], q.yminusx); // t[2]: A=(Y1-X1)*(y2-x2)
+
+    F25519::add(t[0], p.y, p.x);
+    F25519::mul(t[3], t[0], q.yplusx);  // t[3]: B=(Y1+X1)*(y2+x2)
+
+    F25519::sub(t[0], t[3], t[2]);  // t[0]: E=B-A
+    F25519::add(t[1], t[3], t[2]);  // t[1]: H=B+A
+
+    F25519::mul(t[2], p.t, q.xy2d); // t[2]: C=2*d*T1*x2*y2
+    F25519::add(t[3], p.z, p.z);    // t[3]: D=2*Z1
+
+    F25519::sub(t[4], t[3], t[2]);  // t[4]: F=D-C
+    F25519::add(t[5], t[3], t[2]);  // t[5]: G=D+C
+
+    F25519::mul(r.x, t[0], t[4]);   // X3=E*F
+    F25519::mul(r.y, t[5], t[1]);   // Y3=G*H
+    F25519::mul(r.z, t[5], t[4]);   // Z3=G*F
+    F25519::mul(r.t, t[0], t[1]);   // T3=E*H
+}
+
+/** Load `digit * row[0]` for `digit` in range -8 .. 8, reading every entry of the row */
+static void ed25519_select_niels(ed25519_niels &r, const ed25519_niels *row, int8_t digit, uint256_t &t) {
+    uint8_t negative = (uint8_t) digit >> 7;
+    uint8_t magnitude = (uint8_t) (digit - ((-negative & digit) << 1));
+
+    r.yplusx = 1;
+    r.yminusx = 1;
+    r.xy2d = 0;
+
+    for (uint8_t j = 0; j < 8; j++) {
+        bool match = (((uint32_t) (magnitude ^ (j + 1))) - 1) >> 31;
+        r.yplusx.select(match, r.yplusx, row[j].yplusx);
+        r.yminusx.select(match, r.yminusx, row[j].yminusx);
+        r.xy2d.select(match, r.xy2d, row[j].xy2d);
+    }
+
+    // -(x, y) = (-x, y)
+    uint256_t::swap(negative, r.yplusx, r.yminusx);
+    F25519::neg(t, r.xy2d);
+    r.xy2d.select(negative, r.xy2d, t);
+}
+
+void ED25519::mulBase(ed25519_pt &r, const uint256_t &k) {
+    // k = sum(e[i] * 16^i) with signed digits -8 <= e[i] < 8, except for the last one
+    int8_t e[64];
+    for (size_t i = 0; i < 32; i++) {
+        e[2 * i] = (int8_t) (k.u8[i] & 15);
+        e[2 * i + 1] = (int8_t) (k.u8[i] >> 4);
+    }
+
+    int8_t carry = 0;
+    for (size_t i = 0; i < 63; i++) {
+        e[i] = (int8_t) (e[i] + carry);
+        carry = (int8_t) ((e[i] + 8) >> 4);
+        e[i] = (int8_t) (e[i] - (carry << 4));
+    }
+    e[63] = (int8_t) (e[63] + carry);
+
+    uint256_t t[6];
+    ed25519_niels n;
+    r.loadNeutral();
+
+#if UB_CRYPTO_ED25519_BASE_ROWS == 32
+    // row i covers digits 2i and 2i+1, odd digits are accumulated first and shifted into place by 4 doublings
+    for (size_t i = 1; i < 64; i += 2) {
+        ed25519_select_niels(n, ED25519_BASE_TABLE.p[i / 2], e[i], t[0]);
+        ed25519_add_niels(r, r, n, t);
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        ed25519_double(r, r, t);
+    }
+
+    for (size_t i = 0; i < 64; i += 2) {
+        ed25519_select_niels(n, ED25519_BASE_TABLE.p[i / 2], e[i], t[0]);
+        ed25519_add_niels(r, r, n, t);
+    }
+#else
+    for (int32_t i = 63; i >= 0; i--) {
+        if (i != 63) {
+            for (size_t j = 0; j < 4; j++) {
+                ed25519_double(r, r, t);
+            }
+        }
+
+        ed25519_select_niels(n, ED25519_BASE_TABLE.p[0], e[i], t[0]);
+        ed25519_add_niels(r, r, n, t);
+    }
+#endif
+
+    ub::crypto::secureZero(e, sizeof(e));
+    ub::crypto::secureZero(&n, sizeof(n));
+    ub::crypto::secureZero(t, sizeof(t));
+}
+
+/** Window width of `A` scalar in variable time multiplication, table of its odd multiples is computed at runtime */
+static constexpr uint8_t ED25519_POINT_WNAF = 5;
+
+void ED25519::mulDiffVartime(ed25519_pt &r, const uint256_t &s, const ed25519_pt &a, const uint256_t &k) {
+    int8_t ds[uint256_t::N_BITS], dk[uint256_t::N_BITS];
+    bigint_wnaf(ds, s, ED25519_BASE_WNAF);
+    bigint_wnaf(dk, k, ED25519_POINT_WNAF);
+
+    uint256_t t[6];
+
+    // odd multiples of -A
+    ed25519_pt p[1 << (ED25519_POINT_WNAF - 2)], p2;
+    F25519::neg(p[0].x, a.x);
+    F25519::neg(p[0].t, a.t);
+    p[0].y = a.y;
+    p[0].z = a.z;
+
+    ed25519_double(p2, p[0], t);
+    for (size_t i = 1; i < std::size(p); i++) {
+        ed25519_add_impl(p[i], p[i - 1], p2, t);
+    }
+
+    int32_t i = uint256_t::N_BITS - 1;
+    while (i >= 0 && ds[i] == 0 && dk[i] == 0) {
+        i--;
+    }
+
+    r.loadNeutral();
+
+    ed25519_niels n;
+    ed25519_pt q;
+
+    for (; i >= 0; i--) {
+        ed25519_double(r, r, t);
+
+        if (ds[i] > 0) {
+            ed25519_add_niels(r, r, ED25519_BASE_ODD.p[ds[i] / 2], t);
+        } else if (ds[i] < 0) {
+            const ed25519_niels &b = ED25519_BASE_ODD.p[-ds[i] / 2];
+            n.yplusx = b.yminusx;
+            n.yminusx = b.yplusx;
+            F25519::neg(n.xy2d, b.xy2d);
+            ed25519_add_niels(r, r, n, t);
+        }
+
+        if (dk[i] > 0) {
+            ed25519_add_impl(r, r, p[dk[i] / 2], t);
+        } else if (dk[i] < 0) {
+            const ed25519_pt &m = p[-dk[i] / 2];
+            F25519::neg(q.x, m.x);
+            F25519::neg(q.t, m.t);
+            q.y = m.y;
+            q.z = m.z;
+            ed25519_add_impl(r, r, q, t);
+        }
+    }
+}
+
+void ED25519::toCached(ed25519_cached &r, const ed25519_pt &p) {
+    uint256_t t;
+
+    F25519::add(r.yplusx, p.y, p.x);
+    F25519::sub(r.yminusx, p.y, p.x);
+    F25519::add(r.z2, p.z, p.z);
+    F25519::mul(t, p.t, ED25519_D);
+    F25519::add(r.t2d, t, t);
+}
+
+/** Compute `R = P + Q`, or `R = P - Q` if `negate` is set */
+static void ed25519_add_cached(ed25519_pt &r, const ed25519_pt &p, const ed25519_cached &q, bool negate,
+                               uint256_t *t)
+{
+    // -(X, Y, Z, T) = (-X, Y, Z, -T), so Y + X and Y - X swap places and C changes sign
+    const uint256_t &yplusx = negate ? q.yminusx : q.yplusx;
+    const uint256_t &yminusx = negate ? q.yplusx : q.yminusx;
+
+    F25519::sub(t[0], p.y, p.x);
+    F25519::mul(t[2], t[0], yminusx);   // t[2]: A=(Y1-X1)*(Y2-X2)
+
+    F25519::add(t[0], p.y, p.x);
+    F25519::mul(t[3], t[0], yplusx);    // t[3]: B=(Y1+X1)*(Y2+X2)
+
+    F25519::sub(t[0], t[3], t[2]);  // t[0]: E=B-A
+    F25519::add(t[1], t[3], t[2]);  // t[1]: H=B+A
+
+    F25519::mul(t[2], p.t, q.t2d);  // t[2]: C=2*d*T1*T2
+    F25519::mul(t[3], p.z, q.z2);   // t[3]: D=2*Z1*Z2
+
+    if (negate) {
+        F25519::add(t[4], t[3], t[2]);  // t[4]: F=D+C
+        F25519::sub(t[5], t[3], t[2]);  // t[5]: G=D-C
+    } else {
+        F25519::sub(t[4], t[3], t[2]);  // t[4]: F=D-C
+        F25519::add(t[5], t[3], t[2]);  // t[5]: G=D+C
+    }
+
+    F25519::mul(r.x, t[0], t[4]);   // X3=E*F
+    F25519::mul(r.y, t[5], t[1]);   // Y3=G*H
+    F25519::mul(r.z, t[5], t[4]);   // Z3=G*F
+    F25519::mul(r.t, t[0], t[1]);   // T3=E*H
+}
+
+/** Number of bits in scalars of `ED25519::mulMultiVartime()` */
+static constexpr size_t ED25519_MULTI_BITS = 253;
+
+/** Largest window width of `ED25519::mulMultiVartime()` */
+static constexpr uint8_t ED25519_MULTI_WIDTH = 6;
+
+void ED25519::mulMultiVartime(ed25519_pt &r, const ed25519_cached *p, const uint256_t *k, size_t count) {
+    // wider windows mean fewer additions per point, but more buckets to sum up for each window
+    uint8_t c = count < 8 ? 3 : count < 32 ? 4 : count < 128 ? 5 : ED25519_MULTI_WIDTH;
+    size_t windows = (ED25519_MULTI_BITS + c - 1) / c;
+
+    // signed digits in range -2^(c-1) .. 2^(c-1) - 1, the top window is never full so it does not carry
+    int8_t digits[ED25519_MULTI_MAX][(ED25519_MULTI_BITS + 2) / 3];
+    for (size_t i = 0; i < count; i++) {
+        uint32_t carry = 0;
+        for (size_t w = 0; w < windows; w++) {
+            size_t bit = w * c;
+            uint32_t v = k[i].u8[bit >> 3] | (bit + 8 < uint256_t::N_BITS ? k[i].u8[(bit >> 3) + 1] << 8 : 0);
+            v = ((v >> (bit & 7)) & ((1u << c) - 1)) + carry;
+
+            carry = (v + (1u << (c - 1))) >> c;
+            digits[i][w] = (int8_t) (v - (carry << c));
+        }
+    }
+
+    uint256_t t[6];
+    ed25519_pt buckets[1 << (ED25519_MULTI_WIDTH - 1)], sum, acc;
+    bool used[1 << (ED25519_MULTI_WIDTH - 1)];
+    size_t n = 1u << (c - 1);
+
+    r.loadNeutral();
+
+    for (size_t w = windows; w-- > 0;) {
+        if (w + 1 != windows) {
+            for (size_t j = 0; j < c; j++) {
+                ed25519_double(r, r, t);
+            }
+        }
+
+        std::fill(used, used + n, false);
+
+        for (size_t i = 0; i < count; i++) {
+            int8_t d = digits[i][w];
+            if (d == 0) {
+                continue;
+            }
+
+            size_t b = (d > 0 ? d : -d) - 1;
+            if (!used[b]) {
+                buckets[b].loadNeutral();
+                used[b] = true;
+            }
+
+            ed25519_add_cached(buckets[b], buckets[b], p[i], d < 0, t);
+        }
+
+        // sum(j * bucket[j - 1]) as a sum of running sums from the top bucket down
+        sum.loadNeutral();
+        acc.loadNeutral();
+
+        bool started = false;
+        for (size_t b = n; b-- > 0;) {
+            if (used[b]) {
+                ed25519_add_impl(sum, sum, buckets[b], t);
+                started = true;
+            }
+
+            if (started) {
+                ed25519_add_impl(acc, acc, sum, t);
+            }
+        }
+
+        if (started) {
+            ed25519_add_impl(r, r, acc, t);
+        }
+    }
+}
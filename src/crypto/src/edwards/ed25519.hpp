@@ -4,6 +4,17 @@
 #include "f25519.hpp"
 #include "fprime8.hpp"
 
+// Fixed-base multiplication table: 32 rows of 8 multiples of the base point (24 KiB) on 64-bit hosts, a single row
+// (768 bytes) otherwise, trading 248 extra doublings for flash space. Can be overridden by defining
+// UB_CRYPTO_ED25519_BASE_ROWS to 1 or 32.
+#if !defined(UB_CRYPTO_ED25519_BASE_ROWS)
+#if __SIZEOF_POINTER__ >= 8
+#define UB_CRYPTO_ED25519_BASE_ROWS     32
+#else
+#define UB_CRYPTO_ED25519_BASE_ROWS     1
+#endif
+#endif
+
 namespace ub::crypto::impl {
     /** Order of Curve25519 elliptic group field, also known as `L` */
     extern const fp8_field_t C25519_ORDER;
@@ -47,12 +58,91 @@ namespace ub::crypto::impl {
     static_assert(std::is_trivially_copyable_v<ed25519_pt>, "ed25519_pt must be trivially copyable");
     static_assert(std::is_trivially_destructible_v<ed25519_pt>, "ed25519_pt must be trivially destructible");
 
+    /** Ed25519 point in affine Niels form, which saves two multiplications per addition */
+    struct ed25519_niels {
+        uint256_t yplusx;   //! y + x
+        uint256_t yminusx;  //! y - x
+        uint256_t xy2d;     //! 2 * d * x * y
+    };
+
+    /** Ed25519 point prepared for repeated additions in extended coordinates */
+    struct ed25519_cached {
+        uint256_t yplusx;   //! Y + X
+        uint256_t yminusx;  //! Y - X
+        uint256_t z2;       //! 2 * Z
+        uint256_t t2d;      //! 2 * d * T
+    };
+
+    /** Maximal number of points in `ED25519::mulMultiVartime()` */
+    constexpr size_t ED25519_MULTI_MAX = __SIZEOF_POINTER__ >= 8 ? 129 : 17;
+
+    static_assert(UB_CRYPTO_ED25519_BASE_ROWS == 1 || UB_CRYPTO_ED25519_BASE_ROWS == 32,
+                  "UB_CRYPTO_ED25519_BASE_ROWS must be either 1 or 32");
+
+    /** Row `i` holds points `j * 256^i * B` for `j = 1 .. 8`, computed at compile time */
+    struct ed25519_base_table_t {
+        ed25519_niels p[UB_CRYPTO_ED25519_BASE_ROWS][8];
+    };
+
+    extern const ed25519_base_table_t ED25519_BASE_TABLE;
+
+    /** Window width of base point scalar in variable time multiplication */
+    constexpr uint8_t ED25519_BASE_WNAF = UB_CRYPTO_ED25519_BASE_ROWS == 32 ? 7 : 5;
+
+    /** Odd multiples `B, 3B, 5B ..` of the base point for width-`ED25519_BASE_WNAF` digits, computed at compile time */
+    struct ed25519_base_odd_t {
+        ed25519_niels p[1 << (ED25519_BASE_WNAF - 2)];
+    };
+
+    extern const ed25519_base_odd_t ED25519_BASE_ODD;
+
+    /** Curve constant `d = -121665 / 121666` */
+    constexpr uint256_t ED25519_D {
+        uint256_t::from_u8,
+        0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+        0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52
+    };
+
+    /** Affine coordinates of the base point */
+    constexpr uint256_t ED25519_BASE_X {
+        uint256_t::from_u8,
+        0x1A, 0xD5, 0x25, 0x8F, 0x60, 0x2D, 0x56, 0xC9, 0xB2, 0xA7, 0x25, 0x95, 0x60, 0xC7, 0x2C, 0x69,
+        0x5C, 0xDC, 0xD6, 0xFD, 0x31, 0xE2, 0xA4, 0xC0, 0xFE, 0x53, 0x6E, 0xCD, 0xD3, 0x36, 0x69, 0x21
+    };
+
+    constexpr uint256_t ED25519_BASE_Y {  // 4 / 5
+        uint256_t::from_u8,
+        0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+        0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
+    };
+
     namespace ED25519 {
         /** Compute `R = X + Y` */
         void add(ed25519_pt &r, const ed25519_pt &x, const ed25519_pt &y);
 
         /** Compute `R = kX`. `R` and `X` must be distinct objects. */
         void mul(ed25519_pt &r, const ed25519_pt &x, const uint256_t &k);
+
+        /**
+         * Compute `R = kB` for base point `B` in constant time using precomputed table. `k` must be less than 2^255,
+         * which holds for any scalar reduced modulo `L`.
+         */
+        void mulBase(ed25519_pt &r, const uint256_t &k);
+
+        /**
+         * Compute `R = sB - kA` for base point `B` in variable time, so it must be used only with public data
+         * (i.e. for signature verification). `s` and `k` must be less than 2^255.
+         */
+        void mulDiffVartime(ed25519_pt &r, const uint256_t &s, const ed25519_pt &a, const uint256_t &k);
+
+        /** Convert a point into cached form */
+        void toCached(ed25519_cached &r, const ed25519_pt &p);
+
+        /**
+         * Compute `R = sum(k[i] * P[i])` for up to `ED25519_MULTI_MAX` points with bucket (Pippenger) method in
+         * variable time, for public data only. Scalars must be less than 2^253.
+         */
+        void mulMultiVartime(ed25519_pt &r, const ed25519_cached *p, const uint256_t *k, size_t count);
     }
 }
 
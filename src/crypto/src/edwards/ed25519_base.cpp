@@ -0,0 +1,282 @@
+#include "ed25519.hpp"
+
+#include <iterator>
+
+using namespace ub::crypto::impl;
+
+// Fixed-base table is evaluated by the compiler. Runtime field arithmetic is not usable in constant expressions
+// (it relies on unions and secure erasure), so generator has its own minimal one: signed 51-bit limbs with 128-bit
+// products, or 17-bit limbs with 64-bit products when 128-bit integers are not available. The latter is only cheap
+// enough for a single row within default constant evaluation limits. Inversions are batched into a single
+// exponentiation.
+
+namespace {
+#if defined(__SIZEOF_INT128__)
+    typedef __int128 gf_wide_t;
+    constexpr size_t GF_BITS = 51;
+#else
+    typedef int64_t gf_wide_t;
+    constexpr size_t GF_BITS = 17;
+#endif
+
+    constexpr size_t GF_N = 255 / GF_BITS;
+    static_assert(GF_N * GF_BITS == 255, "limbs must cover exactly 255 bits");
+
+    constexpr size_t ED25519_BASE_POINTS = UB_CRYPTO_ED25519_BASE_ROWS * 8;
+
+    struct gf_t {
+        int64_t v[GF_N];
+    };
+
+    struct gf_pt {
+        gf_t x, y, z, t;
+    };
+
+    constexpr gf_t gf_load(const uint256_t &x) {
+        gf_t r {};
+        gf_wide_t acc = 0;
+        size_t bits = 0, n = 0;
+
+        for (size_t i = 0; i < uint256_t::N_U8 && n < GF_N; i++) {
+            acc |= (gf_wide_t) x.u8[i] << bits;
+            bits += 8;
+
+            for (; bits >= GF_BITS && n < GF_N; bits -= GF_BITS) {
+                r.v[n++] = (int64_t) (acc & (((gf_wide_t) 1 << GF_BITS) - 1));
+                acc >>= GF_BITS;
+            }
+        }
+
+        return r;
+    }
+
+    /** Carry limbs of `t` into range 0 .. 2^GF_BITS, except for the first one which receives `19 * carry` */
+    template <typename T>
+    constexpr void gf_carry(T *t) {
+        for (size_t i = 0; i < GF_N; i++) {
+            T c = t[i] >> GF_BITS;
+            t[i] -= c * ((T) 1 << GF_BITS);
+
+            if (i + 1 < GF_N) {
+                t[i + 1] += c;
+            } else {
+                t[0] += 19 * c;
+            }
+        }
+    }
+
+    constexpr gf_t gf_add(const gf_t &a, const gf_t &b) {
+        gf_t r {};
+        for (size_t i = 0; i < GF_N; i++) {
+            r.v[i] = a.v[i] + b.v[i];
+        }
+
+        return r;
+    }
+
+    constexpr gf_t gf_sub(const gf_t &a, const gf_t &b) {
+        gf_t r {};
+        for (size_t i = 0; i < GF_N; i++) {
+            r.v[i] = a.v[i] - b.v[i];
+        }
+
+        return r;
+    }
+
+    constexpr gf_t gf_mul(const gf_t &a, const gf_t &b) {
+        gf_wide_t t[2 * GF_N - 1] {};
+        for (size_t i = 0; i < GF_N; i++) {
+            for (size_t j = 0; j < GF_N; j++) {
+                t[i + j] += (gf_wide_t) a.v[i] * b.v[j];
+            }
+        }
+
+        for (size_t i = 0; i + 1 < GF_N; i++) {
+            t[i] += 19 * t[i + GF_N];
+        }
+
+        gf_carry(t);
+        gf_carry(t);
+
+        gf_t r {};
+        for (size_t i = 0; i < GF_N; i++) {
+            r.v[i] = (int64_t) t[i];
+        }
+
+        return r;
+    }
+
+    /** x^(p-2) with exponent bits scanned from the top, p-2 = 2^255 - 21 */
+    constexpr gf_t gf_inv(const gf_t &x) {
+        gf_t r = x;
+        for (int i = 253; i >= 0; i--) {
+            r = gf_mul(r, r);
+            if (i != 2 && i != 4) {
+                r = gf_mul(r, x);
+            }
+        }
+
+        return r;
+    }
+
+    /** Fully reduce `x` modulo p and convert to runtime representation */
+    constexpr uint256_t gf_store(const gf_t &x) {
+        gf_t t = x;
+        gf_carry(t.v);
+        gf_carry(t.v);
+        gf_carry(t.v);
+
+        // t is non-negative and below 2p now, subtract p unless it borrows
+        gf_t m {};
+        int64_t borrow = 0;
+        for (size_t i = 0; i < GF_N; i++) {
+            int64_t limb = ((int64_t) 1 << GF_BITS) - (i == 0 ? 19 : 1);
+            m.v[i] = t.v[i] - limb - borrow;
+            borrow = m.v[i] < 0;
+            m.v[i] += borrow << GF_BITS;
+        }
+
+        if (!borrow) {
+            t = m;
+        }
+
+        uint256_t r;
+        gf_wide_t acc = 0;
+        size_t bits = 0, n = 0;
+
+        for (size_t i = 0; i < GF_N; i++) {
+            acc += (gf_wide_t) t.v[i] << bits;
+            bits += GF_BITS;
+
+            for (; bits >= 32; bits -= 32) {
+                r.u32[n++] = (uint32_t) acc;
+                acc >>= 32;
+            }
+        }
+
+        r.u32[n] = (uint32_t) acc;
+        return r;
+    }
+
+    /** Addition in extended coordinates, `q2d` is `2 * d * q.t` */
+    constexpr gf_pt gf_pt_add(const gf_pt &p, const gf_pt &q, const gf_t &q2d) {
+        gf_t a = gf_mul(gf_sub(p.y, p.x), gf_sub(q.y, q.x));
+        gf_t b = gf_mul(gf_add(p.y, p.x), gf_add(q.y, q.x));
+        gf_t c = gf_mul(p.t, q2d);
+        gf_t d = gf_mul(p.z, gf_add(q.z, q.z));
+
+        gf_t e = gf_sub(b, a);
+        gf_t f = gf_sub(d, c);
+        gf_t g = gf_add(d, c);
+        gf_t h = gf_add(b, a);
+
+        return { gf_mul(e, f), gf_mul(g, h), gf_mul(f, g), gf_mul(e, h) };
+    }
+
+    constexpr gf_pt gf_pt_double(const gf_pt &p) {
+        gf_t a = gf_mul(p.x, p.x);
+        gf_t b = gf_mul(p.y, p.y);
+        gf_t h = gf_add(a, b);
+        gf_t g = gf_sub(a, b);
+
+        gf_t c = gf_mul(p.z, p.z);
+        gf_t f = gf_add(gf_add(c, c), g);
+
+        gf_t s = gf_add(p.x, p.y);
+        gf_t e = gf_sub(h, gf_mul(s, s));
+
+        return { gf_mul(e, f), gf_mul(g, h), gf_mul(g, f), gf_mul(e, h) };
+    }
+
+    constexpr gf_t gf_d2() {
+        gf_t d = gf_load(ED25519_D);
+        return gf_add(d, d);
+    }
+
+    constexpr gf_pt gf_pt_base() {
+        gf_pt b {};
+        b.x = gf_load(ED25519_BASE_X);
+        b.y = gf_load(ED25519_BASE_Y);
+        b.z.v[0] = 1;
+        b.t = gf_mul(b.x, b.y);
+        return b;
+    }
+
+    /** Convert `N` points into affine Niels form */
+    template <size_t N>
+    constexpr void gf_pt_niels(ed25519_niels (&r)[N], const gf_pt (&p)[N]) {
+        gf_t d2 = gf_d2();
+
+        // Montgomery's trick: z[i]^-1 = (z[0] * .. * z[i - 1]) * (z[0] * .. * z[i])^-1
+        gf_t prefix[N] {};
+        prefix[0] = p[0].z;
+        for (size_t i = 1; i < N; i++) {
+            prefix[i] = gf_mul(prefix[i - 1], p[i].z);
+        }
+
+        gf_t inv = gf_inv(prefix[N - 1]);
+
+        for (size_t i = N; i-- > 0;) {
+            gf_t zi = i > 0 ? gf_mul(inv, prefix[i - 1]) : inv;
+            inv = gf_mul(inv, p[i].z);
+
+            gf_t x = gf_mul(p[i].x, zi);
+            gf_t y = gf_mul(p[i].y, zi);
+
+            r[i].yplusx = gf_store(gf_add(y, x));
+            r[i].yminusx = gf_store(gf_sub(y, x));
+            r[i].xy2d = gf_store(gf_mul(gf_mul(x, y), d2));
+        }
+    }
+
+    constexpr ed25519_base_table_t ed25519_base_table_generate() {
+        gf_t d2 = gf_d2();
+        gf_pt b = gf_pt_base();
+
+        gf_pt p[ED25519_BASE_POINTS] {};
+        for (size_t i = 0; i < UB_CRYPTO_ED25519_BASE_ROWS; i++) {
+            gf_t b2d = gf_mul(b.t, d2);
+
+            p[8 * i] = b;
+            for (size_t j = 1; j < 8; j++) {
+                p[8 * i + j] = gf_pt_add(p[8 * i + j - 1], b, b2d);
+            }
+
+            // 256^(i + 1) * B = 32 * (8 * 256^i * B)
+            b = p[8 * i + 7];
+            for (size_t j = 0; j < 5; j++) {
+                b = gf_pt_double(b);
+            }
+        }
+
+        ed25519_niels n[ED25519_BASE_POINTS] {};
+        gf_pt_niels(n, p);
+
+        ed25519_base_table_t r {};
+        for (size_t i = 0; i < ED25519_BASE_POINTS; i++) {
+            r.p[i / 8][i % 8] = n[i];
+        }
+
+        return r;
+    }
+
+    constexpr ed25519_base_odd_t ed25519_base_odd_generate() {
+        constexpr size_t N = std::size(ed25519_base_odd_t {}.p);
+
+        gf_pt b2 = gf_pt_double(gf_pt_base());
+        gf_t b2d = gf_mul(b2.t, gf_d2());
+
+        gf_pt p[N] {};
+        p[0] = gf_pt_base();
+        for (size_t i = 1; i < N; i++) {
+            p[i] = gf_pt_add(p[i - 1], b2, b2d);
+        }
+
+        ed25519_base_odd_t r {};
+        gf_pt_niels(r.p, p);
+        return r;
+    }
+}
+
+constexpr ed25519_base_table_t ub::crypto::impl::ED25519_BASE_TABLE = ed25519_base_table_generate();
+constexpr ed25519_base_odd_t ub::crypto::impl::ED25519_BASE_ODD = ed25519_base_odd_generate();
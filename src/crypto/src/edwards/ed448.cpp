@@ -2,6 +2,8 @@
 
 #include "f448.hpp"
 
+#include <iterator>
+
 using namespace ub::crypto::impl;
 
 constexpr static int32_t ED448_D = -39081;
@@ -41,7 +43,7 @@ bool ed448_pt::load(const uint8_t *buffer) {
     uint448_t u, v, t[3];
 
     // u = y^2 - 1; v = d y^2 - 1
-    F448::mul(u, y, y);
+    F448::sqr(u, y);
 
     F448::load(t[0], ED448_D);
     F448::mul(v, u, t[0]);
@@ -51,16 +53,16 @@ bool ed448_pt::load(const uint8_t *buffer) {
     F448::add(v, v, t[0]);
 
     // x = u^3 v (u^5 v^3)^((p-3)/4)
-    F448::mul(t[0], u, u);          // t[0] = u^2
-    F448::mul(t[1], t[0], t[0]);    // t[1] = u^4
+    F448::sqr(t[0], u);             // t[0] = u^2
+    F448::sqr(t[1], t[0]);          // t[1] = u^4
     F448::mul(t[0], t[1], u);       // t[0] = u^5
-    F448::mul(t[1], v, v);          // t[1] = v^2
+    F448::sqr(t[1], v);             // t[1] = v^2
     F448::mul(t[2], t[1], v);       // t[2] = v^3
     F448::mul(t[1], t[0], t[2]);    // t[1] = u^5 v^3
 
     F448::powP34(t[0], t[1]);       // t[0] = P34(u^5 v^3)
     F448::mul(t[1], t[0], v);       // t[1] = v P32(u^5 v^3)
-    F448::mul(t[0], u, u);          // t[0] = u^2
+    F448::sqr(t[0], u);             // t[0] = u^2
     F448::mul(t[2], t[0], u);       // t[2] = u^3
     F448::mul(x, t[1], t[2]);       // x = u^3 v P32(u^5 v^3)
 
@@ -71,7 +73,7 @@ bool ed448_pt::load(const uint8_t *buffer) {
     x.select(parityC ^ parityR, x, t[0]);
 
     // Check that X is a square
-    F448::mul(t[0], x, x);          // t[0] = x^2
+    F448::sqr(t[0], x);             // t[0] = x^2
     F448::mul(t[1], t[0], v);       // t[1] = v x^2
     F448::normalize(t[1], t[1]);
     F448::normalize(u, u);
@@ -133,7 +135,7 @@ void ED448::add(ed448_pt &r, const ed448_pt &a, const ed448_pt &b) {
     uint448_t t[8];
 
     F448::mul(t[0], a.z, b.z);      // A = Z1*Z2
-    F448::mul(t[1], t[0], t[0]);    // B = A^2
+    F448::sqr(t[1], t[0]);          // B = A^2
     F448::mul(t[2], a.x, b.x);      // C = X1*X2
     F448::mul(t[3], a.y, b.y);      // D = Y1*Y2
 
@@ -175,13 +177,13 @@ static void ed448_double(ed448_pt &r, const ed448_pt &a) {
 
     // B = (X1+Y1)^2
     F448::add(t[0], a.x, a.y);
-    F448::mul(t[1], t[0], t[0]);
+    F448::sqr(t[1], t[0]);
 
-    F448::mul(t[2], a.x, a.x);      // C = X1^2
-    F448::mul(t[3], a.y, a.y);      // D = Y1^2
+    F448::sqr(t[2], a.x);           // C = X1^2
+    F448::sqr(t[3], a.y);           // D = Y1^2
 
     F448::add(t[4], t[2], t[3]);    // E = C+D
-    F448::mul(t[5], a.z, a.z);      // H = Z1^2
+    F448::sqr(t[5], a.z);           // H = Z1^2
 
     F448::add(t[5], t[5], t[5]);
     F448::neg(t[5], t[5]);
@@ -216,3 +218,63 @@ void ED448::mul(ed448_pt &r, const ed448_pt &x, const uint448_t &k) {
         r.z.select(bit, r.z, s.z);
     }
 }
+
+/** Window width of both scalars in variable time multiplication, tables of odd multiples are computed at runtime */
+static constexpr uint8_t ED448_WNAF = 4;
+
+/** Compute odd multiples `P, 3P, 5P ..` of a point */
+static void ed448_odd_multiples(ed448_pt *r, size_t count, const ed448_pt &p) {
+    ed448_pt p2;
+    ed448_double(p2, p);
+
+    r[0] = p;
+    for (size_t i = 1; i < count; i++) {
+        ED448::add(r[i], r[i - 1], p2);
+    }
+}
+
+/** Compute `R = R + dP` for a non-zero odd digit `d`, table holds odd multiples of `P` */
+static void ed448_add_digit(ed448_pt &r, const ed448_pt *table, int8_t digit) {
+    if (digit > 0) {
+        ED448::add(r, r, table[digit / 2]);
+    } else {
+        ed448_pt q = table[-digit / 2];
+        F448::neg(q.x, q.x);
+        ED448::add(r, r, q);
+    }
+}
+
+void ED448::mulDiffVartime(ed448_pt &r, const uint448_t &s, const ed448_pt &a, const uint448_t &k) {
+    int8_t ds[uint448_t::N_BITS], dk[uint448_t::N_BITS];
+    bigint_wnaf(ds, s, ED448_WNAF);
+    bigint_wnaf(dk, k, ED448_WNAF);
+
+    ed448_pt pb[1 << (ED448_WNAF - 2)], pa[1 << (ED448_WNAF - 2)], t;
+
+    t.loadBase();
+    ed448_odd_multiples(pb, std::size(pb), t);
+
+    // odd multiples of -A
+    t = a;
+    F448::neg(t.x, t.x);
+    ed448_odd_multiples(pa, std::size(pa), t);
+
+    int32_t i = uint448_t::N_BITS - 1;
+    while (i >= 0 && ds[i] == 0 && dk[i] == 0) {
+        i--;
+    }
+
+    r.loadNeutral();
+
+    for (; i >= 0; i--) {
+        ed448_double(r, r);
+
+        if (ds[i] != 0) {
+            ed448_add_digit(r, pb, ds[i]);
+        }
+
+        if (dk[i] != 0) {
+            ed448_add_digit(r, pa, dk[i]);
+        }
+    }
+}
@@ -43,6 +43,12 @@ namespace ub::crypto::impl {
 
         /** Compute `R = kX`. `R` and `X` must be distinct object. */
         void mul(ed448_pt &r, const ed448_pt &x, const uint448_t &k);
+
+        /**
+         * Compute `R = sB - kA` for base point `B` in variable time, so it must be used only with public data
+         * (i.e. for signature verification). `s` and `k` must be less than 2^447.
+         */
+        void mulDiffVartime(ed448_pt &r, const uint448_t &s, const ed448_pt &a, const uint448_t &k);
     }
 }
 
@@ -51,14 +51,14 @@ static void edwards_multiply(uint8_t *r, const uintX_t &k, const uintX_t &u) {
         F::add(t[2], x2, z2);       // t[2]: DA + CB
         F::neg(t[3], z2);           // t[3]: -CB
 
-        F::mul(x3, t[2], t[2]);     // x3 = (DA + CB)^2
+        F::sqr(x3, t[2]);           // x3 = (DA + CB)^2
 
         F::add(t[3], x2, t[3]);     // t[3]: DA - CB
-        F::mul(t[2], t[3], t[3]);   // t[2]: (DA - CB)^2
+        F::sqr(t[2], t[3]);         // t[2]: (DA - CB)^2
         F::mul(z3, t[2], u);        // z3 = u * (DA - CB)^2
 
-        F::mul(t[2], t[0], t[0]);   // t[2]: AA = A^2
-        F::mul(t[3], t[1], t[1]);   // t[3]: BB = B^2
+        F::sqr(t[2], t[0]);         // t[2]: AA = A^2
+        F::sqr(t[3], t[1]);         // t[3]: BB = B^2
         F::mul(x2, t[2], t[3]);     // x2 = AA * BB
 
         F::neg(t[3], t[3]);
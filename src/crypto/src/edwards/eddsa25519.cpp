@@ -1,10 +1,15 @@
 #include <ub/crypto/edwards.hpp>
 
+#include <ub/crypto/chacha20.hpp>
 #include <ub/crypto/sha2.hpp>
 
 #include "f25519.hpp"
 #include "ed25519.hpp"
 #include "fprime8.hpp"
+#include "../parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
 
 // Planned customization option - create non-standard Ed25519 variants with different hashes
 // SHA-512 is way too big for some applications like bootloaders, with its giant round
@@ -78,14 +83,13 @@ static void ed25519_derive_r(const ed25519_sign_ctx &ctx, uint256_t &r)
 }
 
 static void ed25519_compute_R(uint256_t &r, uint8_t *signature) {
-    ed25519_pt b, R;
+    ed25519_pt R;
 
-    b.loadBase();
-    ED25519::mul(R, b, r);
+    ED25519::mulBase(R, r);
 
     R.store(signature);
 
-    b.destroy();
+    R.destroy();
 }
 
 static void ed25519_compute_k(const ed25519_msg &m, uint256_t &k, const uint8_t *publicKey, const uint8_t *R) {
@@ -121,29 +125,9 @@ static void ed25519_sign_impl(ed25519_sign_ctx &ctx, const uint8_t *key, uint8_t
     secureZero(&ctx, sizeof(ctx));
 }
 
-// compute R + kA part of the signature
-static bool ed25519_verify_compute_rhs(const ed25519_verify_ctx &ctx, ed25519_pt &r) {
-    ed25519_pt t;
-
-    if (!t.load(ctx.key)) {
-        return false;
-    }
-
-    uint256_t k;
-    ed25519_compute_k(ctx.m, k, ctx.key, ctx.sig);
-
-    ED25519::mul(r, t, k);
-
-    if (!t.load(ctx.sig)) {
-        return false;
-    }
-
-    ED25519::add(r, r, t);
-    return true;
-}
-
-// compute sB part of the signature
-static bool ed25519_verify_compute_lhs(const ed25519_verify_ctx &ctx, ed25519_pt &r) {
+// verification is a public procedure (no secrets are used), so there is no need to have strict timing invariance here
+// attacker is more than able to redo all these computations without even looking at the device
+static bool ed25519_verify_impl(ed25519_verify_ctx &ctx) {
     uint256_t S;
 
     Fp8::load(S.u8, ctx.sig + ed25519::KEY_LENGTH, ed25519::KEY_LENGTH, C25519_ORDER);
@@ -153,27 +137,22 @@ static bool ed25519_verify_compute_lhs(const ed25519_verify_ctx &ctx, ed25519_pt
         return false;
     }
 
-    ed25519_pt t;
-    t.loadBase();
-
-    ED25519::mul(r, t, S);
-    return true;
-}
-
-// verification is a public procedure (no secrets are used), so there is no need to have strict timing invariance here
-// attacker is more than able to redo all these computations without even looking at the device
-static bool ed25519_verify_impl(ed25519_verify_ctx &ctx) {
-    ed25519_pt rhs;
-    if (!ed25519_verify_compute_rhs(ctx, rhs)) {
+    ed25519_pt A;
+    if (!A.load(ctx.key)) {
         return false;
     }
 
-    ed25519_pt lhs;
-    if (!ed25519_verify_compute_lhs(ctx, lhs)) {
-        return false;
-    }
+    uint256_t k;
+    ed25519_compute_k(ctx.m, k, ctx.key, ctx.sig);
 
-    return lhs.equals(rhs);
+    // sB - kA must encode to R
+    ed25519_pt r;
+    ED25519::mulDiffVartime(r, S, A, k);
+
+    uint8_t R[ed25519::KEY_LENGTH];
+    r.store(R);
+
+    return std::memcmp(R, ctx.sig, ed25519::KEY_LENGTH) == 0;
 }
 
 static void ed25519_load_pure(ed25519_msg &msg, const uint8_t *message, size_t length) {
@@ -194,10 +173,8 @@ void ed25519::toPublic(uint8_t *publicKey, const uint8_t *privateKey) {
     ed25519_sign_ctx ctx;
     ed25519_expand_key(ctx, privateKey);
 
-    ed25519_pt b, A;
-    b.loadBase();
-
-    ED25519::mul(A, b, ctx.s);
+    ed25519_pt A;
+    ED25519::mulBase(A, ctx.s);
 
     A.store(publicKey);
 }
@@ -233,3 +210,237 @@ bool ed25519::verifyHash(const uint8_t *key, const uint8_t *signature, const uin
 
     return ed25519_verify_impl(ctx);
 }
+
+/** Maximal number of signatures combined into a single check, each one contributes two points */
+static constexpr size_t ED25519_BATCH = (ED25519_MULTI_MAX - 1) / 2;
+
+/** Smaller batches are verified one signature at a time */
+static constexpr size_t ED25519_BATCH_MIN = 4;
+
+/** Length of random coefficients of linear combination in bytes */
+static constexpr size_t ED25519_BATCH_Z = 16;
+
+struct ed25519_batch {
+    const uint8_t * const *keys;
+    const uint8_t * const *sigs;
+    const uint8_t * const *msgs;
+    const size_t          *lengths;
+    bool                  *valid;
+    size_t                count;
+    size_t                chunk;    //! Number of signatures in one check
+    std::atomic<bool>     ok;
+};
+
+/** Load a point, accepting only encodings `ed25519_pt::store()` can produce */
+static bool ed25519_load_canonical(ed25519_pt &p, const uint8_t *buffer) {
+    if (!p.load(buffer)) {
+        return false;
+    }
+
+    uint256_t x = p.x, y = p.y;
+    F25519::normalize(x);
+    F25519::normalize(y);
+    y.u8[31] |= (x.u8[0] & 1) << 7;
+
+    return std::memcmp(y.u8, buffer, uint256_t::N_U8) == 0;
+}
+
+/** Load `S` and check that it is less than L */
+static bool ed25519_load_s(uint256_t &S, const uint8_t *sig) {
+    Fp8::load(S.u8, sig + ed25519::KEY_LENGTH, ed25519::KEY_LENGTH, C25519_ORDER);
+    return std::memcmp(S.u8, sig + ed25519::KEY_LENGTH, ed25519::KEY_LENGTH) == 0;
+}
+
+/** Verify a single signature of the batch with the same cofactored equation as the combined check */
+static bool ed25519_verify_cofactored(const ed25519_batch &b, size_t i) {
+    uint256_t S;
+    ed25519_pt A, R;
+    if (!ed25519_load_s(S, b.sigs[i]) || !ed25519_load_canonical(R, b.sigs[i]) || !A.load(b.keys[i])) {
+        return false;
+    }
+
+    ed25519_msg m;
+    ed25519_load_pure(m, b.msgs[i], b.lengths[i]);
+
+    uint256_t k;
+    ed25519_compute_k(m, k, b.keys[i], b.sigs[i]);
+
+    // [8](sB - kA - R) must be the neutral point
+    ed25519_pt r;
+    ED25519::mulDiffVartime(r, S, A, k);
+
+    F25519::neg(R.x, R.x);
+    F25519::neg(R.t, R.t);
+    ED25519::add(r, r, R);
+
+    for (size_t j = 0; j < 3; j++) {
+        ED25519::add(r, r, r);
+    }
+
+    ed25519_pt neutral;
+    neutral.loadNeutral();
+    return r.equals(neutral);
+}
+
+/** Compute `r = a * b` for 128-bit `a` */
+static void ed25519_mul_z(bigint_t<384> &r, const uint32_t *a, const uint256_t &b) {
+    r = 0;
+
+    for (size_t i = 0; i < ED25519_BATCH_Z / 4; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < uint256_t::N_U32; j++) {
+            carry += (uint64_t) a[i] * b.u32[j] + r.u32[i + j];
+            r.u32[i + j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+
+        r.u32[i + uint256_t::N_U32] = (uint32_t) carry;
+    }
+}
+
+// Signatures are valid when sum(z[i] * (R[i] + k[i] * A[i] - S[i] * B)) is the neutral point, except with negligible
+// probability if coefficients z[i] are unpredictable. They are derived from a hash of the whole batch, so changing any
+// signature, key or message changes all of them. Multiplication by cofactor makes the check independent of small order
+// components of points.
+static bool ed25519_verify_batch_check(const ed25519_batch &b, size_t begin, size_t end) {
+    size_t n = end - begin;
+
+    ed25519_cached p[ED25519_MULTI_MAX];
+    uint256_t e[ED25519_MULTI_MAX];
+    ed25519_pt t;
+
+    ED25519_HASH hash;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t *key = b.keys[begin + i];
+        const uint8_t *sig = b.sigs[begin + i];
+
+        uint256_t S;
+        if (!ed25519_load_s(S, sig) || !ed25519_load_canonical(t, sig)) {
+            return false;
+        }
+        ED25519::toCached(p[2 * i], t);
+
+        if (!t.load(key)) {
+            return false;
+        }
+        ED25519::toCached(p[2 * i + 1], t);
+
+        ed25519_msg m;
+        ed25519_load_pure(m, b.msgs[begin + i], b.lengths[begin + i]);
+        ed25519_compute_k(m, e[2 * i + 1], key, sig);
+
+        hash.update(sig, ed25519::SIGNATURE_LENGTH);
+        hash.update(key, ed25519::KEY_LENGTH);
+        hash.update(e[2 * i + 1].u8, uint256_t::N_U8);
+    }
+
+    uint8_t seed[ED25519_HASH::OUTPUT];
+    hash.finish(seed);
+
+    uint8_t z[ED25519_BATCH][ED25519_BATCH_Z] = {};
+    chacha20 stream;
+    stream.init(seed, (uint64_t) 0);
+    stream.process(z[0], z[0], n * ED25519_BATCH_Z);
+
+    // R[i] and A[i] get coefficients z[i] and z[i] * k[i], -B gets sum(z[i] * S[i])
+    bigint_t<384> product;
+    bigint_t<416> sum;
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t zw[ED25519_BATCH_Z / 4];
+        std::memcpy(zw, z[i], ED25519_BATCH_Z);
+
+        e[2 * i] = 0;
+        std::memcpy(e[2 * i].u8, z[i], ED25519_BATCH_Z);
+
+        ed25519_mul_z(product, zw, e[2 * i + 1]);
+        Fp8::load(e[2 * i + 1].u8, product.u8, bigint_t<384>::N_U8, C25519_ORDER);
+
+        uint256_t S;
+        std::memcpy(S.u8, b.sigs[begin + i] + ed25519::KEY_LENGTH, ed25519::KEY_LENGTH);
+        ed25519_mul_z(product, zw, S);
+
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bigint_t<416>::N_U32; j++) {
+            carry += (uint64_t) sum.u32[j] + (j < bigint_t<384>::N_U32 ? product.u32[j] : 0);
+            sum.u32[j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+    }
+
+    Fp8::load(e[2 * n].u8, sum.u8, bigint_t<416>::N_U8, C25519_ORDER);
+
+    t.loadBase();
+    F25519::neg(t.x, t.x);
+    F25519::neg(t.t, t.t);
+    ED25519::toCached(p[2 * n], t);
+
+    ED25519::mulMultiVartime(t, p, e, 2 * n + 1);
+
+    for (size_t i = 0; i < 3; i++) {
+        ED25519::add(t, t, t);
+    }
+
+    ed25519_pt neutral;
+    neutral.loadNeutral();
+    return t.equals(neutral);
+}
+
+static void ed25519_verify_batch_range(void *ctx, size_t begin, size_t end) {
+    ed25519_batch &b = *(ed25519_batch *) ctx;
+
+    for (size_t c = begin; c < end; c++) {
+        size_t from = c * b.chunk;
+        size_t to = std::min(b.count, from + b.chunk);
+
+        if (to - from >= ED25519_BATCH_MIN && ed25519_verify_batch_check(b, from, to)) {
+            if (b.valid != nullptr) {
+                std::fill(b.valid + from, b.valid + to, true);
+            }
+
+            continue;
+        }
+
+        // failed check only tells that some signature is invalid, find out which ones if asked to
+        if (b.valid == nullptr && to - from >= ED25519_BATCH_MIN) {
+            b.ok = false;
+            continue;
+        }
+
+        for (size_t i = from; i < to; i++) {
+            bool valid = ed25519_verify_cofactored(b, i);
+            if (b.valid != nullptr) {
+                b.valid[i] = valid;
+            }
+
+            if (!valid) {
+                b.ok = false;
+            }
+        }
+    }
+}
+
+bool ed25519::verifyBatch(const uint8_t * const *keys, const uint8_t * const *signatures,
+                          const uint8_t * const *messages, const size_t *lengths, size_t count, bool *valid)
+{
+    ed25519_batch b;
+    b.keys = keys;
+    b.sigs = signatures;
+    b.msgs = messages;
+    b.lengths = lengths;
+    b.valid = valid;
+    b.count = count;
+    b.ok = true;
+
+    // split evenly into the smallest number of checks, every check is processed by a single thread
+    size_t checks = (count + ED25519_BATCH - 1) / ED25519_BATCH;
+    if (checks == 0) {
+        return true;
+    }
+
+    b.chunk = (count + checks - 1) / checks;
+    parallelFor(checks, 1, ed25519_verify_batch_range, &b);
+
+    return b.ok;
+}
@@ -115,32 +115,10 @@ static void ed448_sign_impl(ed448_sign_ctx &ctx, const uint8_t *key, uint8_t *si
     secureZero(&ctx, sizeof(ctx));
 }
 
-static bool ed448_verify_compute_rhs(ed448_verify_ctx &ctx, ed448_pt &r) {
-    ed448_pt t;
-    if (!t.load(ctx.key)) {
-        return false;
-    }
-
-    uint448_t k;
-    ed448_compute_k(ctx.m, k, ctx.key, ctx.sig);
-
-    ED448::mul(r, t, k);
-
-    if (!t.load(ctx.sig)) {
-        return false;
-    }
-
-    ED448::add(r, r, t);
-    return true;
-}
-
-static bool ed448_verify_compute_lhs(ed448_verify_ctx &ctx, ed448_pt &r) {
+// verification uses only public data, so variable time multiplication is fine here
+static bool ed448_verify_impl(ed448_verify_ctx &ctx) {
     uint448_t S;
 
-    if ((ctx.sig[ed448::KEY_LENGTH - 1] & 0x7F) != 0) {
-        return false;
-    }
-
     Fp8::load(S.u8, ctx.sig + ed448::KEY_LENGTH, ed448::KEY_LENGTH, C448_ORDER);
     if (std::memcmp(S.u8, ctx.sig + ed448::KEY_LENGTH, uint448_t::N_U8) != 0) {
         // S must be less than L, so load must not perform any modular reduction here.
@@ -148,25 +126,22 @@ static bool ed448_verify_compute_lhs(ed448_verify_ctx &ctx, ed448_pt &r) {
         return false;
     }
 
-    ed448_pt t;
-    t.loadBase();
-
-    ED448::mul(r, t, S);
-    return true;
-}
-
-static bool ed448_verify_impl(ed448_verify_ctx &ctx) {
-    ed448_pt rhs;
-    if (!ed448_verify_compute_rhs(ctx, rhs)) {
+    ed448_pt A;
+    if (!A.load(ctx.key)) {
         return false;
     }
 
-    ed448_pt lhs;
-    if (!ed448_verify_compute_lhs(ctx, lhs)) {
-        return false;
-    }
+    uint448_t k;
+    ed448_compute_k(ctx.m, k, ctx.key, ctx.sig);
+
+    // sB - kA must encode to R
+    ed448_pt r;
+    ED448::mulDiffVartime(r, S, A, k);
+
+    uint8_t R[ed448::KEY_LENGTH];
+    r.store(R);
 
-    return lhs.equals(rhs);
+    return std::memcmp(R, ctx.sig, ed448::KEY_LENGTH) == 0;
 }
 
 static void ed448_load_pure(ed448_msg &m, const uint8_t *message, size_t length) {
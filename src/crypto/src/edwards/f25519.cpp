@@ -4,6 +4,215 @@
 
 using namespace ub::crypto::impl;
 
+#if UB_CRYPTO_F25519_64
+typedef unsigned __int128 f25519_u128;
+
+static constexpr uint64_t F25519_M51 = (1ull << 51) - 1;
+static constexpr uint64_t F25519_TOP = 1ull << 63;
+
+static void f25519_load64(uint64_t *w, const uint256_t &x) {
+    std::memcpy(w, x.u8, uint256_t::N_U8);
+}
+
+static void f25519_store64(uint256_t &x, const uint64_t *w) {
+    std::memcpy(x.u8, w, uint256_t::N_U8);
+}
+
+static void f25519_reduce_single(uint64_t *w, uint64_t carry) {
+    // Reduce using 2^255 = 19 mod p
+    carry = ((carry << 1) | (w[3] >> 63)) * 19;
+    w[3] &= ~F25519_TOP;
+
+    for (size_t i = 0; i < 4; i++) {
+        f25519_u128 t = (f25519_u128) w[i] + carry;
+        w[i] = (uint64_t) t;
+        carry = (uint64_t) (t >> 64);
+    }
+}
+
+/** Split 256-bit number into 51-bit limbs, the top limb receives remaining 52 bits */
+static void f25519_unpack(uint64_t *l, const uint256_t &x) {
+    uint64_t w[4];
+    f25519_load64(w, x);
+
+    l[0] = w[0] & F25519_M51;
+    l[1] = ((w[0] >> 51) | (w[1] << 13)) & F25519_M51;
+    l[2] = ((w[1] >> 38) | (w[2] << 26)) & F25519_M51;
+    l[3] = ((w[2] >> 25) | (w[3] << 39)) & F25519_M51;
+    l[4] = w[3] >> 12;
+}
+
+/** Join carried limbs into 256-bit number */
+static void f25519_pack(uint256_t &x, const uint64_t *l) {
+    uint64_t w[4];
+    f25519_u128 acc = l[0] + ((f25519_u128) l[1] << 51);
+    w[0] = (uint64_t) acc; acc >>= 64;
+
+    acc += (f25519_u128) l[2] << 38;
+    w[1] = (uint64_t) acc; acc >>= 64;
+
+    acc += (f25519_u128) l[3] << 25;
+    w[2] = (uint64_t) acc; acc >>= 64;
+
+    acc += (f25519_u128) l[4] << 12;
+    w[3] = (uint64_t) acc;
+
+    f25519_store64(x, w);
+}
+
+void F25519::normalize(uint256_t &x) {
+    uint64_t w[4], m[4];
+    f25519_load64(w, x);
+    f25519_reduce_single(w, 0);
+
+    // The number is now less than 2^255 + 18, and therefore less than
+    // 2p. Try subtracting p, and conditionally load the subtracted
+    // value if underflow did not occur.
+    f25519_u128 c = 19;
+    for (size_t i = 0; i < 3; i++) {
+        c += w[i];
+        m[i] = (uint64_t) c;
+        c >>= 64;
+    }
+
+    m[3] = (uint64_t) c + w[3] - F25519_TOP;
+
+    uint64_t mask = (m[3] >> 63) - 1;    // no borrow -> 0xFF
+    for (size_t i = 0; i < 4; i++) {
+        w[i] ^= (w[i] ^ m[i]) & mask;
+    }
+
+    f25519_store64(x, w);
+    secureZero(m, sizeof(m));
+}
+
+void F25519::add(uint256_t &r, const uint256_t &a, const uint256_t &b) {
+    uint64_t x[4], y[4];
+    f25519_load64(x, a);
+    f25519_load64(y, b);
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < 4; i++) {
+        f25519_u128 t = (f25519_u128) x[i] + y[i] + carry;
+        x[i] = (uint64_t) t;
+        carry = (uint64_t) (t >> 64);
+    }
+
+    f25519_reduce_single(x, carry);
+    f25519_store64(r, x);
+}
+
+/** Compute `w = 2p + a - b` where `a` is given as words, `b` as a number. Result fits 257 bits, returns the top bit */
+static uint64_t f25519_sub2p(uint64_t *w, const uint64_t *a, const uint256_t &b) {
+    uint64_t y[4];
+    f25519_load64(y, b);
+
+    // 2p = 2^256 - 38, borrow is represented by carry going from 2^64 - 1 to 2^64 - 2 etc.
+    f25519_u128 c = 1;
+    for (size_t i = 0; i < 4; i++) {
+        c += (f25519_u128) a[i] + (i == 0 ? ~(uint64_t) 37 : ~(uint64_t) 0) + (uint64_t) ~y[i];
+        w[i] = (uint64_t) c;
+        c >>= 64;
+    }
+
+    // 2^256 + 2^256 - 38 - b was computed as the sum of complements, leaving extra 2^256 in carry
+    return (uint64_t) c - 1;
+}
+
+void F25519::sub(uint256_t &r, const uint256_t &a, const uint256_t &b) {
+    /* Calculate a + 2p - b, to avoid underflow */
+    uint64_t x[4];
+    f25519_load64(x, a);
+
+    uint64_t carry = f25519_sub2p(x, x, b);
+    f25519_reduce_single(x, carry);
+    f25519_store64(r, x);
+}
+
+void F25519::neg(uint256_t &r, const uint256_t &x) {
+    uint64_t w[4] = {};
+
+    uint64_t carry = f25519_sub2p(w, w, x);
+    f25519_reduce_single(w, carry);
+    f25519_store64(r, w);
+}
+
+/** Carry 51-bit columns of a product into limbs, folding the top carry with 2^255 = 19 mod p */
+static inline void f25519_carry(uint64_t *l, f25519_u128 *t) {
+    uint64_t c = 0;
+    for (size_t i = 0; i < 5; i++) {
+        t[i] += c;
+        l[i] = (uint64_t) t[i] & F25519_M51;
+        c = (uint64_t) (t[i] >> 51);
+    }
+
+    l[0] += c * 19;
+    l[1] += l[0] >> 51;
+    l[0] &= F25519_M51;
+}
+
+void F25519::mul(uint256_t &r, const uint256_t &a, const uint256_t &b) {
+    uint64_t x[5], y[5], y19[5];
+    f25519_unpack(x, a);
+    f25519_unpack(y, b);
+
+    for (size_t i = 1; i < 5; i++) {
+        y19[i] = y[i] * 19;
+    }
+
+    // limbs are below 2^52, so each column is below 2^110 and carries do not overflow
+    f25519_u128 t[5];
+    t[0] = (f25519_u128) x[0] * y[0] + (f25519_u128) x[1] * y19[4] + (f25519_u128) x[2] * y19[3]
+         + (f25519_u128) x[3] * y19[2] + (f25519_u128) x[4] * y19[1];
+    t[1] = (f25519_u128) x[0] * y[1] + (f25519_u128) x[1] * y[0] + (f25519_u128) x[2] * y19[4]
+         + (f25519_u128) x[3] * y19[3] + (f25519_u128) x[4] * y19[2];
+    t[2] = (f25519_u128) x[0] * y[2] + (f25519_u128) x[1] * y[1] + (f25519_u128) x[2] * y[0]
+         + (f25519_u128) x[3] * y19[4] + (f25519_u128) x[4] * y19[3];
+    t[3] = (f25519_u128) x[0] * y[3] + (f25519_u128) x[1] * y[2] + (f25519_u128) x[2] * y[1]
+         + (f25519_u128) x[3] * y[0] + (f25519_u128) x[4] * y19[4];
+    t[4] = (f25519_u128) x[0] * y[4] + (f25519_u128) x[1] * y[3] + (f25519_u128) x[2] * y[2]
+         + (f25519_u128) x[3] * y[1] + (f25519_u128) x[4] * y[0];
+
+    uint64_t l[5];
+    f25519_carry(l, t);
+    f25519_pack(r, l);
+}
+
+/** Compute `l = l^2` in place, limbs must be below 2^52 */
+static inline void f25519_sqr_limbs(uint64_t *l) {
+    // each cross product x[i] * x[j] appears twice, so one of the factors is doubled instead
+    uint64_t d0 = l[0] * 2, d1 = l[1] * 2, d2 = l[2] * 2, d3 = l[3] * 2;
+    uint64_t l19_3 = l[3] * 19, l19_4 = l[4] * 19;
+
+    f25519_u128 t[5];
+    t[0] = (f25519_u128) l[0] * l[0] + (f25519_u128) d1 * l19_4 + (f25519_u128) d2 * l19_3;
+    t[1] = (f25519_u128) d0 * l[1] + (f25519_u128) d2 * l19_4 + (f25519_u128) l[3] * l19_3;
+    t[2] = (f25519_u128) d0 * l[2] + (f25519_u128) l[1] * l[1] + (f25519_u128) d3 * l19_4;
+    t[3] = (f25519_u128) d0 * l[3] + (f25519_u128) d1 * l[2] + (f25519_u128) l[4] * l19_4;
+    t[4] = (f25519_u128) d0 * l[4] + (f25519_u128) d1 * l[3] + (f25519_u128) l[2] * l[2];
+
+    f25519_carry(l, t);
+}
+
+void F25519::sqr(uint256_t &r, const uint256_t &x) {
+    uint64_t l[5];
+    f25519_unpack(l, x);
+    f25519_sqr_limbs(l);
+    f25519_pack(r, l);
+}
+
+void F25519::sqrn(uint256_t &r, const uint256_t &x, size_t n) {
+    // carried limbs stay below 2^52, so they are squared again without packing
+    uint64_t l[5];
+    f25519_unpack(l, x);
+
+    for (size_t i = 0; i < n; i++) {
+        f25519_sqr_limbs(l);
+    }
+
+    f25519_pack(r, l);
+}
+#else
 static uint32_t u256_add_carry(const uint256_t &src, uint256_t &dst, size_t length, uint32_t carry) {
     uint64_t carry64 = carry;
 
@@ -126,22 +335,110 @@ void F25519::mul(uint256_t &r, const uint256_t &a, const uint256_t &b) {
     f25519_reduce_single(r, c1);
 }
 
+void F25519::sqr(uint256_t &r, const uint256_t &x) {
+    uint32_t t[2 * uint256_t::N_U32];
+    std::memset(t, 0, sizeof(t));
+
+    // Step 1. Sum of cross products x[i] * x[j] for i < j, each of them appears twice in the square
+    for (size_t i = 0; i + 1 < uint256_t::N_U32; i++) {
+        uint64_t c = 0;
+        for (size_t j = i + 1; j < uint256_t::N_U32; j++) {
+            c += (uint64_t) x.u32[i] * x.u32[j] + t[i + j];
+            t[i + j] = (uint32_t) c;
+            c >>= 32;
+        }
+
+        t[i + uint256_t::N_U32] = (uint32_t) c;
+    }
+
+    // Step 2. Double cross products and add squares x[i]^2
+    uint64_t c = 0;
+    uint32_t shift = 0;
+    for (size_t i = 0; i < uint256_t::N_U32; i++) {
+        uint64_t sq = (uint64_t) x.u32[i] * x.u32[i];
+
+        for (size_t h = 0; h < 2; h++) {
+            uint32_t w = t[2 * i + h];
+            c += (uint32_t) ((w << 1) | shift) + (uint64_t) (uint32_t) (sq >> (32 * h));
+            shift = w >> 31;
+            t[2 * i + h] = (uint32_t) c;
+            c >>= 32;
+        }
+    }
+
+    // Step 3. Reduce using 2^256 = 38 mod p
+    c = 0;
+    for (size_t i = 0; i < uint256_t::N_U32; i++) {
+        c += t[i] + (uint64_t) t[i + uint256_t::N_U32] * 38;
+        r.u32[i] = (uint32_t) c;
+        c >>= 32;
+    }
+
+    f25519_reduce_single(r, c);
+    secureZero(t, sizeof(t));
+}
+
+void F25519::sqrn(uint256_t &r, const uint256_t &x, size_t n) {
+    r = x;
+
+    for (size_t i = 0; i < n; i++) {
+        sqr(r, r);
+    }
+}
+
+#endif
+
+/** Compute `r = x^(2^250 - 1)` and `x11 = x^11`, shared by inversion and square root chains */
+static void f25519_pow22501(uint256_t &r, uint256_t &x11, const uint256_t &x) {
+    uint256_t t[3];
+
+    F25519::sqr(t[0], x);               // t[0]: x^2
+    F25519::sqrn(t[1], t[0], 2);        // t[1]: x^8
+    F25519::mul(t[2], t[1], x);         // t[2]: x^9
+    F25519::mul(x11, t[2], t[0]);       // x11:  x^11
+    F25519::sqr(t[1], x11);             // t[1]: x^22
+    F25519::mul(t[0], t[1], t[2]);      // t[0]: x^(2^5 - 1)
+
+    F25519::sqrn(t[2], t[0], 5);
+    F25519::mul(t[1], t[2], t[0]);      // t[1]: x^(2^10 - 1)
+    F25519::sqrn(t[2], t[1], 10);
+    F25519::mul(t[0], t[2], t[1]);      // t[0]: x^(2^20 - 1)
+    F25519::sqrn(t[2], t[0], 20);
+    F25519::mul(r, t[2], t[0]);         // r:    x^(2^40 - 1)
+    F25519::sqrn(t[2], r, 10);
+    F25519::mul(t[0], t[2], t[1]);      // t[0]: x^(2^50 - 1)
+    F25519::sqrn(t[2], t[0], 50);
+    F25519::mul(t[1], t[2], t[0]);      // t[1]: x^(2^100 - 1)
+    F25519::sqrn(t[2], t[1], 100);
+    F25519::mul(r, t[2], t[1]);         // r:    x^(2^200 - 1)
+    F25519::sqrn(t[2], r, 50);
+    F25519::mul(r, t[2], t[0]);         // r:    x^(2^250 - 1)
+
+    for (uint256_t &i: t) {
+        i.destroy();
+    }
+}
+
 void F25519::inv(uint256_t &r, const uint256_t &x) {
-    // Power opcodes for (q-2) = 2^255-21
-    static uint8_t powers[] = { 255, 245, 2, 3, 2, 5, 0 };
+    // (q-2) = 2^255-21 = (2^250 - 1) * 2^5 + 11: 254 squarings and 11 multiplications
+    uint256_t s, x11;
+    f25519_pow22501(s, x11, x);
 
-    uint256_t s;
-    bigint_pow_rle<F25519>(r, s, x, powers);
+    sqrn(s, s, 5);
+    mul(r, s, x11);
 
     s.destroy();
+    x11.destroy();
 }
 
 void F25519::pow58(uint256_t &r, const uint256_t &x) {
-    // Powers opcodes for (q-5)/8 = 2^252-3
-    static uint8_t powers2523[] = { 255, 245, 2, 3, 0 };
+    // (q-5)/8 = 2^252-3 = (2^250 - 1) * 2^2 + 1
+    uint256_t t, x11;
+    f25519_pow22501(t, x11, x);
 
-    uint256_t t;
-    bigint_pow_rle<F25519>(t, r, x, powers2523);
+    sqrn(t, t, 2);
+    mul(r, t, x);
 
     t.destroy();
+    x11.destroy();
 }
@@ -11,6 +11,17 @@
 
 #include "bigint.hpp"
 
+// Field arithmetic: five 51-bit limbs with 128-bit products on hosts, 32-bit words with 64-bit products otherwise.
+// Elements are stored as `uint256_t` in both cases, limbs are unpacked for each multiplication. Can be overridden by
+// defining UB_CRYPTO_F25519_64 to 0 (or to 1 when 128-bit integers are available).
+#if !defined(UB_CRYPTO_F25519_64)
+#if defined(__SIZEOF_INT128__)
+#define UB_CRYPTO_F25519_64         1
+#else
+#define UB_CRYPTO_F25519_64         0
+#endif
+#endif
+
 namespace ub::crypto::impl {
     /** Operations specific to `Fp(2**255 - 19)` */
     struct F25519 {
@@ -32,10 +43,16 @@ namespace ub::crypto::impl {
         /** Compute `r = a * b`. `r` must not point to `a` or `b` */
         static void mul(uint256_t &r, const uint256_t &a, const uint256_t &b);
 
+        /** Compute `r = x^2`, faster than `mul()` since symmetric products are computed once */
+        static void sqr(uint256_t &r, const uint256_t &x);
+
+        /** Compute `r = x^(2^n)` by squaring `n` times */
+        static void sqrn(uint256_t &r, const uint256_t &x, size_t n);
+
         /** Compute `r = x^-1 mod p`. `r` must not point to `x` */
         static void inv(uint256_t &r, const uint256_t &x);
 
-        /** Compute `r = x^((p-5)/8) mod p` */
+        /** Compute `r = x^((p-5)/8) mod p`. `r` must not point to `x` */
         static void pow58(uint256_t &r, const uint256_t &x);
     };
 }
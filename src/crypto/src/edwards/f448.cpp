@@ -96,6 +96,32 @@ void F448::neg(uint448_t &r, const uint448_t &x) {
     f448_reduce(r, 1 - borrow);
 }
 
+/** Reduce `2 * N_U32` words long product in `tmp` into `r`, erasing `tmp` */
+static void f448_reduce_wide(uint448_t &r, uint32_t *tmp) {
+    // Step 2. Do two 'big' modular reductions, where length of carry could be 448 and 224 bits at most.
+    for (size_t i = 0; i < 2; i++) {
+        // Copy overflow value to `r` and zero it in `tmp`
+        std::memcpy(r.u8, tmp + uint448_t::N_U32, uint448_t::N_U8);
+        std::memset(tmp + uint448_t::N_U32, 0, uint448_t::N_U8);
+
+        // Add overflow value to buffer:
+        uint32_t carry = f448_add_buffers(tmp, tmp, r.u32);
+        tmp[uint448_t::N_U32] = carry;
+
+        // Add overflow value to buffer at 2**224 position:
+        carry = f448_add_buffers(tmp + U32_224, tmp + U32_224, r.u32);
+        tmp[uint448_t::N_U32 + U32_224] = carry;
+    }
+
+    // Step 3. Copy result back and do 'small' modular reductions, where length of carry is 1 bit at most
+    std::memcpy(r.u8, tmp, uint448_t::N_U8);
+    uint32_t carry = tmp[uint448_t::N_U32];
+    carry = f448_reduce(r, carry);
+    f448_reduce(r, carry);
+
+    ub::crypto::secureZero(tmp, 2 * uint448_t::N_U8);
+}
+
 void F448::mul(uint448_t &r, const uint448_t &a, const uint448_t &b) {
     std::memset(r.u8, 0, uint448_t::N_U8);
     uint32_t tmp[2 * uint448_t::N_U32];
@@ -128,40 +154,93 @@ void F448::mul(uint448_t &r, const uint448_t &a, const uint448_t &b) {
         tmp[i] = d;
     }
 
-    // Step 2. Do two 'big' modular reductions, where length of carry could be 448 and 224 bits at most.
-    for (size_t i = 0; i < 2; i++) {
-        // Copy overflow value to `r` and zero it in `tmp`
-        std::memcpy(r.u8, tmp + uint448_t::N_U32, uint448_t::N_U8);
-        std::memset(tmp + uint448_t::N_U32, 0, uint448_t::N_U8);
+    f448_reduce_wide(r, tmp);
+}
 
-        // Add overflow value to buffer:
-        uint32_t carry = f448_add_buffers(tmp, tmp, r.u32);
-        tmp[uint448_t::N_U32] = carry;
+void F448::sqr(uint448_t &r, const uint448_t &x) {
+    uint32_t tmp[2 * uint448_t::N_U32];
+    std::memset(tmp, 0, sizeof(tmp));
+
+    // Step 1. Sum of cross products x[i] * x[j] for i < j, each of them appears twice in the square
+    for (size_t i = 0; i + 1 < uint448_t::N_U32; i++) {
+        uint64_t c = 0;
+        for (size_t j = i + 1; j < uint448_t::N_U32; j++) {
+            c += (uint64_t) x.u32[i] * x.u32[j] + tmp[i + j];
+            tmp[i + j] = (uint32_t) c;
+            c >>= 32;
+        }
 
-        // Add overflow value to buffer at 2**224 position:
-        carry = f448_add_buffers(tmp + U32_224, tmp + U32_224, r.u32);
-        tmp[uint448_t::N_U32 + U32_224] = carry;
+        tmp[i + uint448_t::N_U32] = (uint32_t) c;
     }
 
-    // Step 3. Copy result back and do 'small' modular reductions, where length of carry is 1 bit at most
-    std::memcpy(r.u8, tmp, uint448_t::N_U8);
-    uint32_t carry = tmp[uint448_t::N_U32];
-    carry = f448_reduce(r, carry);
-    f448_reduce(r, carry);
+    // Step 2. Double cross products and add squares x[i]^2
+    uint64_t c = 0;
+    uint32_t shift = 0;
+    for (size_t i = 0; i < uint448_t::N_U32; i++) {
+        uint64_t sq = (uint64_t) x.u32[i] * x.u32[i];
+
+        for (size_t h = 0; h < 2; h++) {
+            uint32_t w = tmp[2 * i + h];
+            c += (uint32_t) ((w << 1) | shift) + (uint64_t) (uint32_t) (sq >> (32 * h));
+            shift = w >> 31;
+            tmp[2 * i + h] = (uint32_t) c;
+            c >>= 32;
+        }
+    }
 
-    secureZero(tmp, sizeof(tmp));
+    f448_reduce_wide(r, tmp);
+}
+
+void F448::sqrn(uint448_t &r, const uint448_t &x, size_t n) {
+    r = x;
+
+    for (size_t i = 0; i < n; i++) {
+        sqr(r, r);
+    }
 }
 
 void F448::inv(uint448_t &r, const uint448_t &x) {
-    static const uint8_t powers[] = { 0xFF, 0xBF, 0x02, 0xFF, 0xBF, 0x02, 0x03, 0x00 };
+    // p-2 = 2^448 - 2^224 - 3 = ((p-3)/4) * 4 + 1
+    uint448_t t;
+    powP34(t, x);
+
+    sqrn(t, t, 2);
+    mul(r, t, x);
 
-    uint448_t s;
-    bigint_pow_rle<F448>(r, s, x, powers);
+    t.destroy();
 }
 
 void F448::powP34(uint448_t &r, const uint448_t &x) {
-    static const uint8_t powers[] = { 0xFF, 0xBF, 0x02, 0xFF, 0xBF, 0x00 };
-
-    uint448_t s;
-    bigint_pow_rle<F448>(s, r, x, powers);
+    // (p-3)/4 = 2^446 - 2^222 - 1 = (2^223 - 1) * 2^223 + (2^222 - 1): 445 squarings and 11 multiplications
+    uint448_t t, u, x6, x24;
+
+    sqr(t, x);
+    mul(u, t, x);                   // u:   x^(2^2 - 1)
+    sqr(t, u);
+    mul(u, t, x);                   // u:   x^(2^3 - 1)
+    sqrn(t, u, 3);
+    mul(x6, t, u);                  // x6:  x^(2^6 - 1)
+    sqrn(t, x6, 6);
+    mul(u, t, x6);                  // u:   x^(2^12 - 1)
+    sqrn(t, u, 12);
+    mul(x24, t, u);                 // x24: x^(2^24 - 1)
+    sqrn(t, x24, 24);
+    mul(u, t, x24);                 // u:   x^(2^48 - 1)
+    sqrn(t, u, 48);
+    mul(r, t, u);                   // r:   x^(2^96 - 1)
+    sqrn(t, r, 96);
+    mul(u, t, r);                   // u:   x^(2^192 - 1)
+    sqrn(t, u, 24);
+    mul(r, t, x24);                 // r:   x^(2^216 - 1)
+    sqrn(t, r, 6);
+    mul(u, t, x6);                  // u:   x^(2^222 - 1)
+    sqr(t, u);
+    mul(r, t, x);                   // r:   x^(2^223 - 1)
+    sqrn(t, r, 223);
+    mul(r, t, u);
+
+    t.destroy();
+    u.destroy();
+    x6.destroy();
+    x24.destroy();
 }
@@ -29,10 +29,16 @@ namespace ub::crypto::impl {
         /** Compute `r = a * b`. `r` must be distinct from `a` and `b`. */
         static void mul(uint448_t &r, const uint448_t &a, const uint448_t &b);
 
-        /** Compute `r = x^-1` */
+        /** Compute `r = x^2`, faster than `mul()` since symmetric products are computed once */
+        static void sqr(uint448_t &r, const uint448_t &x);
+
+        /** Compute `r = x^(2^n)` by squaring `n` times */
+        static void sqrn(uint448_t &r, const uint448_t &x, size_t n);
+
+        /** Compute `r = x^-1`. `r` must be distinct from `x`. */
         static void inv(uint448_t &r, const uint448_t &x);
 
-        /** Compute `r = x ^ ((p-3)/4)` */
+        /** Compute `r = x ^ ((p-3)/4)`. `r` must be distinct from `x`. */
         static void powP34(uint448_t &r, const uint448_t &x);
     };
 }
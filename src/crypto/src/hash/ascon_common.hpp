@@ -0,0 +1,29 @@
+#ifndef UB_SRC_CRYPTO_HASH_ASCON_COMMON_H
+#define UB_SRC_CRYPTO_HASH_ASCON_COMMON_H
+
+#include <ub/crypto/ascon.hpp>
+
+// Ascon permutation backend: native 64-bit words on 64-bit hosts, bit-interleaved 32-bit words (suitable for
+// Cortex-M) otherwise. Can be overridden by defining UB_CRYPTO_ASCON64 to 0 or 1. State representation in
+// `ascon320::state_t` depends on selected backend, so it must be accessed only through `ascon320` methods.
+#if !defined(UB_CRYPTO_ASCON64)
+#define UB_CRYPTO_ASCON64           (__SIZEOF_POINTER__ >= 8)
+#endif
+
+namespace ub::crypto::impl {
+    /** Ascon-p permutation operating on bit-interleaved words (pairs of even and odd bit 32-bit words) */
+    void ascon320Permute32(ascon320::state_t &state, uint32_t rounds);
+
+#if UB_CRYPTO_ASCON64
+    /** Ascon-p permutation operating on native 64-bit words */
+    void ascon320Permute64(ascon320::state_t &state, uint32_t rounds);
+#endif
+
+    /** Number of rounds of Ascon-p permutation applied on initialization and finalization */
+    constexpr uint8_t ASCON_ROUNDS_A = 12;
+
+    /** Number of rounds of Ascon-p permutation applied between blocks of Ascon-AEAD128 */
+    constexpr uint8_t ASCON_ROUNDS_B = 8;
+}
+
+#endif // UB_SRC_CRYPTO_HASH_ASCON_COMMON_H
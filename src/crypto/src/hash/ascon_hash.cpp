@@ -0,0 +1,52 @@
+#include <ub/crypto/ascon.hpp>
+
+#include "ascon_common.hpp"
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr uint64_t ASCON_HASH256_IV  = 0x0000080100CC0002;
+static constexpr uint64_t ASCON_XOF128_IV   = 0x0000080000CC0003;
+static constexpr uint8_t  ASCON_HASH_RATE   = 8;
+
+static void ascon_hash_init(ascon320 &a, uint64_t iv) {
+    a.reset();
+    a.rate = ASCON_HASH_RATE;
+    a.rounds = ASCON_ROUNDS_A;
+
+    a.xorWord(0, iv);
+    ascon320::apply(a.st, ASCON_ROUNDS_A);
+}
+
+void ascon_hash256::reset() {
+    ascon_hash_init(a, ASCON_HASH256_IV);
+}
+
+void ascon_hash256::finish(uint8_t *digest) {
+    a.finish();
+    a.produce(digest, OUTPUT);
+
+    reset();
+}
+
+void ascon_xof128::reset() {
+    ascon_hash_init(a, ASCON_XOF128_IV);
+    m_generating = false;
+}
+
+void ascon_xof128::update(const uint8_t *data, size_t length) {
+    if (m_generating) {
+        reset();
+    }
+
+    a.consume(data, length);
+}
+
+void ascon_xof128::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        a.finish();
+        m_generating = true;
+    }
+
+    a.produce(output, length);
+}
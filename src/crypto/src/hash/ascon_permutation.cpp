@@ -0,0 +1,220 @@
+#include <ub/crypto/ascon.hpp>
+
+#include "ascon_common.hpp"
+#include "sha3_common.hpp" // bit interleaving helpers
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Rotation amounts of the linear layer, two per state word
+static const uint8_t ascon320_rotations[] = { 19, 28, 61, 39, 1, 6, 10, 17, 7, 41 };
+
+// Round constants for bit-interleaved state: even bits in lower and odd bits in higher nibble
+static const uint8_t ascon320_rcon[] = {
+        0xCC, 0xC9, 0x9C, 0x99, 0xC6, 0xC3, 0x96, 0x93, 0x6C, 0x69, 0x3C, 0x39
+};
+
+static uint32_t ror32(uint32_t x, uint32_t i) {
+    return (x >> (i & 31)) | (x << (-i & 31));
+}
+
+/** 64-bit right rotation of bit-interleaved word, odd amount also swaps the halves */
+static void ascon320_ror(uint32_t *dst, const uint32_t *x, uint32_t r) {
+    if (r & 1) {
+        dst[0] = ror32(x[1], r >> 1);
+        dst[1] = ror32(x[0], (r >> 1) + 1);
+    } else {
+        dst[0] = ror32(x[0], r >> 1);
+        dst[1] = ror32(x[1], r >> 1);
+    }
+}
+
+/** Bitsliced 5-bit S-box, `x` points to the first word and words are `stride` elements apart */
+template <typename T>
+static void ascon320_sbox(T *x, size_t stride) {
+    T x0 = x[0], x1 = x[stride], x2 = x[2 * stride], x3 = x[3 * stride], x4 = x[4 * stride];
+
+    x0 ^= x4; x4 ^= x3; x2 ^= x1;
+
+    T t0 = ~x0 & x1, t1 = ~x1 & x2, t2 = ~x2 & x3, t3 = ~x3 & x4, t4 = ~x4 & x0;
+    x0 ^= t1; x1 ^= t2; x2 ^= t3; x3 ^= t4; x4 ^= t0;
+
+    x1 ^= x0; x0 ^= x4; x3 ^= x2; x2 = ~x2;
+
+    x[0] = x0; x[stride] = x1; x[2 * stride] = x2; x[3 * stride] = x3; x[4 * stride] = x4;
+}
+
+void ub::crypto::impl::ascon320Permute32(ascon320::state_t &state, uint32_t rounds) {
+    uint32_t *st = state.u32;
+
+    for (size_t i = ascon320::ROUNDS - rounds; i < ascon320::ROUNDS; i++) {
+        st[4] ^= ascon320_rcon[i] & 0xF;
+        st[5] ^= ascon320_rcon[i] >> 4;
+
+        // even and odd halves go through the S-box independently
+        ascon320_sbox(st, 2);
+        ascon320_sbox(st + 1, 2);
+
+        for (size_t j = 0; j < 10; j += 2) {
+            uint32_t a[2], b[2];
+            ascon320_ror(a, st + j, ascon320_rotations[j]);
+            ascon320_ror(b, st + j, ascon320_rotations[j + 1]);
+
+            st[j] ^= a[0] ^ b[0];
+            st[j + 1] ^= a[1] ^ b[1];
+        }
+    }
+}
+
+#if UB_CRYPTO_ASCON64
+static uint64_t ror64(uint64_t x, uint32_t i) {
+    return (x >> i) | (x << (64 - i));
+}
+
+void ub::crypto::impl::ascon320Permute64(ascon320::state_t &state, uint32_t rounds) {
+    uint64_t *st = state.u64;
+
+    for (uint64_t i = ascon320::ROUNDS - rounds; i < ascon320::ROUNDS; i++) {
+        st[2] ^= ((0xF - i) << 4) | i;
+
+        ascon320_sbox(st, 1);
+
+        st[0] ^= ror64(st[0], 19) ^ ror64(st[0], 28);
+        st[1] ^= ror64(st[1], 61) ^ ror64(st[1], 39);
+        st[2] ^= ror64(st[2], 1) ^ ror64(st[2], 6);
+        st[3] ^= ror64(st[3], 10) ^ ror64(st[3], 17);
+        st[4] ^= ror64(st[4], 7) ^ ror64(st[4], 41);
+    }
+}
+#endif
+
+void ascon320::apply(state_t &state, uint32_t rounds) {
+#if UB_CRYPTO_ASCON64
+    ascon320Permute64(state, rounds);
+#else
+    ascon320Permute32(state, rounds);
+#endif
+}
+
+void ascon320::xorWord(size_t index, uint64_t x) {
+#if UB_CRYPTO_ASCON64
+    st.u64[index] ^= x;
+#else
+    uint32_t y[2];
+    keccak1600Interleave(y, x);
+    st.u32[(index << 1) + 0] ^= y[0];
+    st.u32[(index << 1) + 1] ^= y[1];
+#endif
+}
+
+uint64_t ascon320::word(size_t index) const {
+#if UB_CRYPTO_ASCON64
+    return st.u64[index];
+#else
+    return keccak1600Deinterleave(st.u32 + (index << 1));
+#endif
+}
+
+void ascon320::consume(const uint8_t *buf, size_t length) {
+    while (length != 0) {
+        size_t offset = ptr & 7;
+        size_t ll = std::min(length, std::min((size_t) (rate - ptr), 8 - offset));
+
+        uint64_t x = 0;
+        if (ll == sizeof(x)) {
+            std::memcpy(&x, buf, sizeof(x)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                x |= (uint64_t) buf[i] << (i << 3);
+            }
+        }
+
+        xorWord(ptr >> 3, x << (offset << 3));
+
+        ptr += ll;
+        buf += ll;
+        length -= ll;
+
+        if (ptr == rate) {
+            apply(st, rounds);
+            ptr = 0;
+        }
+    }
+}
+
+void ascon320::finish() {
+    xorWord(ptr >> 3, 0x01ULL << ((ptr & 7) << 3));
+    apply(st, rounds);
+
+    ptr = 0;
+}
+
+void ascon320::produce(uint8_t *buf, size_t length) {
+    while (length != 0) {
+        // permutation is delayed until more output is requested, so the final block is not wasted
+        if (ptr == rate) {
+            apply(st, rounds);
+            ptr = 0;
+        }
+
+        size_t offset = ptr & 7;
+        size_t ll = std::min(length, std::min((size_t) (rate - ptr), 8 - offset));
+
+        uint64_t x = word(ptr >> 3) >> (offset << 3);
+        if (ll == sizeof(x)) {
+            std::memcpy(buf, &x, sizeof(x)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                buf[i] = (uint8_t) (x >> (i << 3));
+            }
+        }
+
+        ptr += ll;
+        buf += ll;
+        length -= ll;
+    }
+}
+
+void ascon320::duplex(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt) {
+    while (length != 0) {
+        size_t offset = ptr & 7;
+        size_t ll = std::min(length, std::min((size_t) (rate - ptr), 8 - offset));
+
+        uint64_t x = 0;
+        if (ll == sizeof(x)) {
+            std::memcpy(&x, src, sizeof(x)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                x |= (uint64_t) src[i] << (i << 3);
+            }
+        }
+
+        uint64_t y = x ^ (word(ptr >> 3) >> (offset << 3));
+        if (ll != sizeof(y)) {
+            y &= (1ULL << (ll << 3)) - 1;
+        }
+
+        xorWord(ptr >> 3, (decrypt ? y : x) << (offset << 3));
+
+        if (ll == sizeof(y)) {
+            std::memcpy(dst, &y, sizeof(y)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                dst[i] = (uint8_t) (y >> (i << 3));
+            }
+        }
+
+        ptr += ll;
+        src += ll;
+        dst += ll;
+        length -= ll;
+
+        if (ptr == rate) {
+            apply(st, rounds);
+            ptr = 0;
+        }
+    }
+}
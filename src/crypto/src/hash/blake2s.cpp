@@ -0,0 +1,96 @@
+#include <ub/crypto/blake2.hpp>
+
+#include "blake_common.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr size_t BLAKE2S_ROUNDS = 10;
+
+blake2s::blake2s(size_t digestLength): m_state {}, m_block {} {
+    m_digestLength = digestLength;
+    reset();
+}
+
+void blake2s::reset(size_t digestLength) {
+    init(nullptr, 0, digestLength != 0 ? digestLength : m_digestLength);
+}
+
+void blake2s::init(const uint8_t *key, size_t keyLength, size_t digestLength) {
+    m_digestLength = digestLength;
+
+    // parameter block: digest length, key length, fanout and depth of 1
+    std::memcpy(m_state, blake_iv, sizeof(m_state));
+    m_state[0] ^= 0x01010000 ^ (keyLength << 8) ^ digestLength;
+
+    secureZero(m_block, sizeof(m_block));
+    m_totalBytes = 0;
+    m_used = 0;
+
+    // key is padded to a full block, which is processed as the first block of input
+    if (keyLength != 0) {
+        std::memcpy(m_block, key, keyLength);
+        m_used = BLOCK;
+    }
+}
+
+void blake2s::update(const uint8_t *data, size_t length) {
+    while (length != 0) {
+        if (m_used == BLOCK) {
+            compress(m_block, BLOCK, false);
+            m_used = 0;
+        }
+
+        // compress full blocks directly from the input buffer, except the last one
+        if (m_used == 0 && length > BLOCK) {
+            compress(data, BLOCK, false);
+
+            data += BLOCK;
+            length -= BLOCK;
+            continue;
+        }
+
+        size_t ll = std::min(length, (size_t) (BLOCK - m_used));
+        std::memcpy(m_block + m_used, data, ll);
+
+        m_used += ll;
+        data += ll;
+        length -= ll;
+    }
+}
+
+void blake2s::finish(uint8_t *digest) {
+    std::memset(m_block + m_used, 0, BLOCK - m_used);
+    compress(m_block, m_used, true);
+
+    std::memcpy(digest, m_state, m_digestLength); // assume little-endian system
+    reset();
+}
+
+void blake2s::compress(const uint8_t *block, uint32_t length, bool last) {
+    m_totalBytes += length;
+
+    uint32_t m[16];
+    std::memcpy(m, block, sizeof(m)); // assume little-endian system
+
+    uint32_t v[16] = {
+            m_state[0], m_state[1], m_state[2], m_state[3], m_state[4], m_state[5], m_state[6], m_state[7],
+            blake_iv[0], blake_iv[1], blake_iv[2], blake_iv[3],
+            blake_iv[4] ^ (uint32_t) m_totalBytes, blake_iv[5] ^ (uint32_t) (m_totalBytes >> 32),
+            last ? ~blake_iv[6] : blake_iv[6], blake_iv[7]
+    };
+
+    for (size_t r = 0; r < BLAKE2S_ROUNDS; r++) {
+        blakeRound(v, m, blake2s_sigma[r]);
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+        m_state[i] ^= v[i] ^ v[i + 8];
+    }
+
+    secureZero(m, sizeof(m));
+    secureZero(v, sizeof(v));
+}
@@ -0,0 +1,283 @@
+#include <ub/crypto/blake3.hpp>
+
+#include "blake_common.hpp"
+#include "../parallel.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Number of chunks compressed by a single worker thread at once (subtree of 16 KiB)
+static constexpr size_t BLAKE3_GROUP = 16;
+
+// Largest subtree hashed by a single `update()` step, chaining values of its groups are buffered on stack
+#if UB_CRYPTO_THREADS
+static constexpr size_t BLAKE3_MAX_SUBTREE = 1024;
+#else
+static constexpr size_t BLAKE3_MAX_SUBTREE = BLAKE3_GROUP;
+#endif
+
+static constexpr size_t BLAKE3_CV = 32;
+
+/** Parameters of a subtree hashed by worker threads */
+struct blake3_subtree {
+    const uint32_t  *key;
+    uint8_t         flags;
+    const uint8_t   *data;
+    uint64_t        counter;    //! Counter of the first chunk
+    size_t          group;      //! Number of chunks in a group
+    uint8_t         *cvs;       //! Chaining values of groups
+};
+
+/** Reduce chaining values of `count` (a power of two) subtrees into chaining value of their parent */
+static void blake3_reduce(const uint32_t *key, uint8_t flags, uint8_t *cvs, size_t count) {
+    for (; count > 1; count >>= 1) {
+        blake3HashMany(cvs, count >> 1, 1, key, 0, false, flags | BLAKE3_PARENT, 0, 0, cvs);
+    }
+}
+
+static void blake3_subtree_range(void *ctx, size_t begin, size_t end) {
+    auto t = (const blake3_subtree *) ctx;
+    uint8_t cvs[BLAKE3_GROUP * BLAKE3_CV];
+
+    for (size_t g = begin; g < end; g++) {
+        blake3HashMany(t->data + g * t->group * blake3::CHUNK, t->group, blake3::CHUNK / blake3::BLOCK, t->key,
+                       t->counter + g * t->group, true, t->flags, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, cvs);
+
+        blake3_reduce(t->key, t->flags, cvs, t->group);
+        std::memcpy(t->cvs + g * BLAKE3_CV, cvs, BLAKE3_CV);
+    }
+
+    secureZero(cvs, sizeof(cvs));
+}
+
+static void blake3_store_words(uint8_t *dst, const uint32_t *src, size_t words) {
+    std::memcpy(dst, src, words * sizeof(uint32_t)); // assume little-endian system
+}
+
+blake3::blake3(): m_key {}, m_cv {}, m_block {}, m_stack {}, m_output {} {
+    init(blake_iv, 0);
+}
+
+void blake3::reset() {
+    init(blake_iv, 0);
+}
+
+void blake3::initKeyed(const uint8_t *key) {
+    uint32_t words[8];
+    std::memcpy(words, key, sizeof(words)); // assume little-endian system
+
+    init(words, BLAKE3_KEYED_HASH);
+    secureZero(words, sizeof(words));
+}
+
+void blake3::initDeriveKey(const uint8_t *context, size_t length) {
+    uint32_t words[8];
+
+    init(blake_iv, BLAKE3_DERIVE_KEY_CONTEXT);
+    update(context, length);
+    finish((uint8_t *) words); // assume little-endian system
+
+    init(words, BLAKE3_DERIVE_KEY_MATERIAL);
+    secureZero(words, sizeof(words));
+}
+
+void blake3::update(const uint8_t *data, size_t length) {
+    if (m_generating) {
+        restart();
+    }
+
+    while (length != 0) {
+        size_t chunkLength = m_blocks * BLOCK + m_blockLength;
+
+        // current chunk could be completed only when it is known that more input follows
+        if (chunkLength == CHUNK) {
+            pushChunk();
+            continue;
+        }
+
+        // whole chunks are hashed as subtrees directly from the input buffer, keeping input for the last chunk
+        if (chunkLength == 0 && length > CHUNK) {
+            size_t count = std::min((length - 1) / CHUNK, BLAKE3_MAX_SUBTREE);
+            uint32_t level = 31 - __builtin_clz((uint32_t) count);
+
+            if (m_chunks != 0) {
+                level = std::min(level, (uint32_t) __builtin_ctzll(m_chunks));
+            }
+
+            count = (size_t) 1 << level;
+            uint8_t cvs[BLAKE3_MAX_SUBTREE / BLAKE3_GROUP * BLAKE3_CV];
+
+            size_t group = std::min(count, BLAKE3_GROUP);
+            blake3_subtree subtree { m_key, m_flags, data, m_chunks, group, cvs };
+
+            parallelFor(count / group, 1, blake3_subtree_range, &subtree);
+            blake3_reduce(m_key, m_flags, cvs, count / group);
+
+            pushSubtree(cvs, level);
+            secureZero(cvs, sizeof(cvs));
+
+            data += count * CHUNK;
+            length -= count * CHUNK;
+            continue;
+        }
+
+        if (m_blockLength == BLOCK) {
+            compressBlock(m_block);
+            m_blockLength = 0;
+        }
+
+        // compress full blocks of the current chunk directly from the input buffer, except the last one
+        if (m_blockLength == 0 && length > BLOCK && chunkLength + BLOCK < CHUNK) {
+            compressBlock(data);
+
+            data += BLOCK;
+            length -= BLOCK;
+            continue;
+        }
+
+        size_t ll = std::min(length, BLOCK - m_blockLength);
+        std::memcpy(m_block + m_blockLength, data, ll);
+
+        m_blockLength += ll;
+        data += ll;
+        length -= ll;
+    }
+}
+
+void blake3::finish(uint8_t *digest) {
+    generate(digest, OUTPUT);
+    restart();
+}
+
+void blake3::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        finalize();
+    }
+
+    while (length != 0) {
+        if (m_outputUsed == BLOCK) {
+            uint32_t out[16];
+            blake3Compress(m_cv, m_block, m_outputBlock++, m_blockLength, m_rootFlags | BLAKE3_ROOT, out);
+
+            blake3_store_words(m_output, out, 16);
+            secureZero(out, sizeof(out));
+            m_outputUsed = 0;
+        }
+
+        size_t ll = std::min(length, (size_t) (BLOCK - m_outputUsed));
+        std::memcpy(output, m_output + m_outputUsed, ll);
+
+        m_outputUsed += ll;
+        output += ll;
+        length -= ll;
+    }
+}
+
+void blake3::restart() {
+    std::memcpy(m_cv, m_key, sizeof(m_cv));
+    secureZero(m_block, sizeof(m_block));
+    secureZero(m_stack, m_depth * sizeof(m_stack[0]));
+    secureZero(m_output, sizeof(m_output));
+
+    m_blockLength = 0;
+    m_blocks = 0;
+    m_rootFlags = 0;
+    m_chunks = 0;
+    m_depth = 0;
+    m_generating = false;
+    m_outputBlock = 0;
+    m_outputUsed = 0;
+}
+
+void blake3::init(const uint32_t *key, uint8_t flags) {
+    std::memcpy(m_key, key, sizeof(m_key));
+    m_flags = flags;
+    m_depth = MAX_DEPTH; // clear the whole stack
+
+    restart();
+}
+
+void blake3::compressBlock(const uint8_t *block) {
+    uint32_t out[16];
+    uint8_t flags = m_flags | (m_blocks == 0 ? BLAKE3_CHUNK_START : 0);
+
+    blake3Compress(m_cv, block, m_chunks, BLOCK, flags, out);
+    std::memcpy(m_cv, out, sizeof(m_cv));
+    secureZero(out, sizeof(out));
+
+    m_blocks++;
+}
+
+void blake3::pushChunk() {
+    uint32_t out[16];
+    uint8_t flags = m_flags | BLAKE3_CHUNK_END | (m_blocks == 0 ? BLAKE3_CHUNK_START : 0);
+
+    blake3Compress(m_cv, m_block, m_chunks, m_blockLength, flags, out);
+
+    uint8_t cv[BLAKE3_CV];
+    blake3_store_words(cv, out, 8);
+    pushSubtree(cv, 0);
+
+    std::memcpy(m_cv, m_key, sizeof(m_cv));
+    m_blockLength = 0;
+    m_blocks = 0;
+
+    secureZero(out, sizeof(out));
+    secureZero(cv, sizeof(cv));
+}
+
+void blake3::pushSubtree(const uint8_t *cv, uint32_t level) {
+    uint8_t block[BLOCK];
+    std::memcpy(block + BLAKE3_CV, cv, BLAKE3_CV);
+
+    // subtree is aligned to its size, so it is merged with all completed subtrees of the same height
+    m_chunks += (uint64_t) 1 << level;
+    for (uint64_t t = m_chunks >> level; (t & 1) == 0; t >>= 1) {
+        uint32_t out[16];
+
+        m_depth--;
+        blake3_store_words(block, m_stack[m_depth], 8);
+        secureZero(m_stack[m_depth], sizeof(m_stack[0]));
+
+        blake3Compress(m_key, block, 0, BLOCK, m_flags | BLAKE3_PARENT, out);
+        blake3_store_words(block + BLAKE3_CV, out, 8);
+    }
+
+    std::memcpy(m_stack[m_depth++], block + BLAKE3_CV, BLAKE3_CV); // assume little-endian system
+    secureZero(block, sizeof(block));
+}
+
+void blake3::finalize() {
+    uint8_t flags = m_flags | BLAKE3_CHUNK_END | (m_blocks == 0 ? BLAKE3_CHUNK_START : 0);
+    std::memset(m_block + m_blockLength, 0, BLOCK - m_blockLength);
+
+    if (m_depth == 0) {
+        // single chunk is the root node itself
+        m_rootFlags = flags;
+    } else {
+        uint32_t out[16];
+        blake3Compress(m_cv, m_block, m_chunks, m_blockLength, flags, out);
+
+        // merge chunk with subtrees from right to left, the last merge is the root node
+        for (size_t i = m_depth - 1; i != 0; i--) {
+            blake3_store_words(m_block, m_stack[i], 8);
+            blake3_store_words(m_block + BLAKE3_CV, out, 8);
+            blake3Compress(m_key, m_block, 0, BLOCK, m_flags | BLAKE3_PARENT, out);
+        }
+
+        blake3_store_words(m_block, m_stack[0], 8);
+        blake3_store_words(m_block + BLAKE3_CV, out, 8);
+        secureZero(out, sizeof(out));
+
+        std::memcpy(m_cv, m_key, sizeof(m_cv));
+        m_blockLength = BLOCK;
+        m_rootFlags = m_flags | BLAKE3_PARENT;
+    }
+
+    m_generating = true;
+    m_outputBlock = 0;
+    m_outputUsed = BLOCK;
+}
@@ -0,0 +1,245 @@
+#include "blake_common.hpp"
+
+#include <ub/crypto/utility.hpp>
+
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr size_t BLAKE3_BLOCK = 64;
+static constexpr size_t BLAKE3_ROUNDS = 7;
+
+static uint32_t blake3_load(const uint8_t *p) {
+    uint32_t x;
+    std::memcpy(&x, p, sizeof(x)); // assume little-endian system
+    return x;
+}
+
+void ub::crypto::impl::blake3Compress(const uint32_t *cv, const uint8_t *block, uint64_t counter,
+                                      uint32_t blockLength, uint32_t flags, uint32_t *out)
+{
+    uint32_t m[16];
+    for (size_t i = 0; i < 16; i++) {
+        m[i] = blake3_load(block + i * sizeof(uint32_t));
+    }
+
+    uint32_t v[16] = {
+            cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+            blake_iv[0], blake_iv[1], blake_iv[2], blake_iv[3],
+            (uint32_t) counter, (uint32_t) (counter >> 32), blockLength, flags
+    };
+
+    for (size_t r = 0; r < BLAKE3_ROUNDS; r++) {
+        blakeRound(v, m, blake3_sigma[r]);
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+        out[i + 8] = v[i + 8] ^ cv[i];
+        out[i] = v[i] ^ v[i + 8];
+    }
+
+    secureZero(m, sizeof(m));
+    secureZero(v, sizeof(v));
+}
+
+static void blake3_hash_one(const uint8_t *input, size_t blocks, const uint32_t *key, uint64_t counter,
+                            uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd, uint8_t *out)
+{
+    uint32_t cv[16];
+    std::memcpy(cv, key, 8 * sizeof(uint32_t));
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint8_t f = flags | (b == 0 ? flagsStart : 0) | (b == blocks - 1 ? flagsEnd : 0);
+        blake3Compress(cv, input + b * BLAKE3_BLOCK, counter, BLAKE3_BLOCK, f, cv);
+    }
+
+    std::memcpy(out, cv, 8 * sizeof(uint32_t)); // assume little-endian system
+    secureZero(cv, sizeof(cv));
+}
+
+static void blake3_hash_many_portable(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key,
+                                      uint64_t counter, bool increment, uint8_t flags, uint8_t flagsStart,
+                                      uint8_t flagsEnd, uint8_t *out)
+{
+    for (size_t i = 0; i < count; i++) {
+        blake3_hash_one(input + i * blocks * BLAKE3_BLOCK, blocks, key, counter + (increment ? i : 0), flags,
+                        flagsStart, flagsEnd, out + i * 32);
+    }
+}
+
+#if UB_CRYPTO_BLAKE3_SIMD
+
+// Vector types are lowered by compiler to SSE/AVX2 registers on x86 and to NEON registers on AArch64
+typedef uint32_t blake3_v4 __attribute__((vector_size(16)));
+typedef uint32_t blake3_v8 __attribute__((vector_size(32)));
+
+/** Transpose `N` vectors of `N` words, so word `i` of each input lane ends up in vector `i` */
+template <typename V>
+[[gnu::always_inline]] static inline void blake3_transpose(V *r) {
+    if constexpr (sizeof(V) == sizeof(blake3_v4)) {
+        V t0 = __builtin_shufflevector(r[0], r[1], 0, 4, 1, 5);
+        V t1 = __builtin_shufflevector(r[0], r[1], 2, 6, 3, 7);
+        V t2 = __builtin_shufflevector(r[2], r[3], 0, 4, 1, 5);
+        V t3 = __builtin_shufflevector(r[2], r[3], 2, 6, 3, 7);
+
+        r[0] = __builtin_shufflevector(t0, t2, 0, 1, 4, 5);
+        r[1] = __builtin_shufflevector(t0, t2, 2, 3, 6, 7);
+        r[2] = __builtin_shufflevector(t1, t3, 0, 1, 4, 5);
+        r[3] = __builtin_shufflevector(t1, t3, 2, 3, 6, 7);
+    } else {
+        // interleave 32-bit words and 64-bit pairs within 128-bit halves, then swap halves
+        V t[8], u[8];
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = __builtin_shufflevector(r[i], r[i + 1], 0, 8, 1, 9, 4, 12, 5, 13);
+            t[i + 1] = __builtin_shufflevector(r[i], r[i + 1], 2, 10, 3, 11, 6, 14, 7, 15);
+        }
+
+        for (size_t i = 0; i < 8; i += 4) {
+            u[i] = __builtin_shufflevector(t[i], t[i + 2], 0, 1, 8, 9, 4, 5, 12, 13);
+            u[i + 1] = __builtin_shufflevector(t[i], t[i + 2], 2, 3, 10, 11, 6, 7, 14, 15);
+            u[i + 2] = __builtin_shufflevector(t[i + 1], t[i + 3], 0, 1, 8, 9, 4, 5, 12, 13);
+            u[i + 3] = __builtin_shufflevector(t[i + 1], t[i + 3], 2, 3, 10, 11, 6, 7, 14, 15);
+        }
+
+        for (size_t i = 0; i < 4; i++) {
+            r[i] = __builtin_shufflevector(u[i], u[i + 4], 0, 1, 2, 3, 8, 9, 10, 11);
+            r[i + 4] = __builtin_shufflevector(u[i], u[i + 4], 4, 5, 6, 7, 12, 13, 14, 15);
+        }
+    }
+}
+
+/** Compress inputs in lanes of `V`, input `l` of the group is at `input + l * stride` */
+template <typename V>
+[[gnu::always_inline]] static inline void blake3_hash_lanes(const uint8_t *input, size_t stride, size_t blocks,
+                                                            const uint32_t *key, uint64_t counter, bool increment,
+                                                            uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd,
+                                                            uint8_t *out)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+
+    V h[8], m[16], v[16], ctrLow, ctrHigh;
+    for (size_t i = 0; i < 8; i++) {
+        h[i] = V {} + key[i];
+    }
+
+    for (size_t l = 0; l < N; l++) {
+        uint64_t c = counter + (increment ? l : 0);
+        ctrLow[l] = (uint32_t) c;
+        ctrHigh[l] = (uint32_t) (c >> 32);
+    }
+
+    for (size_t b = 0; b < blocks; b++) {
+        for (size_t i = 0; i < 16; i += N) {
+            for (size_t l = 0; l < N; l++) {
+                std::memcpy(&m[i + l], input + l * stride + b * BLAKE3_BLOCK + i * sizeof(uint32_t), sizeof(V));
+            }
+
+            blake3_transpose(m + i);
+        }
+
+        uint32_t f = flags | (b == 0 ? flagsStart : 0) | (b == blocks - 1 ? flagsEnd : 0);
+
+        for (size_t i = 0; i < 8; i++) {
+            v[i] = h[i];
+        }
+
+        v[8] = V {} + blake_iv[0];
+        v[9] = V {} + blake_iv[1];
+        v[10] = V {} + blake_iv[2];
+        v[11] = V {} + blake_iv[3];
+        v[12] = ctrLow;
+        v[13] = ctrHigh;
+        v[14] = V {} + (uint32_t) BLAKE3_BLOCK;
+        v[15] = V {} + f;
+
+#pragma GCC unroll 7
+        for (size_t r = 0; r < BLAKE3_ROUNDS; r++) {
+            blakeRound(v, m, blake3_sigma[r]);
+        }
+
+        for (size_t i = 0; i < 8; i++) {
+            h[i] = v[i] ^ v[i + 8];
+        }
+    }
+
+    for (size_t l = 0; l < N; l++) {
+        for (size_t i = 0; i < 8; i++) {
+            uint32_t x = h[i][l];
+            std::memcpy(out + l * 32 + i * sizeof(uint32_t), &x, sizeof(x));
+        }
+    }
+
+    secureZero(m, sizeof(m));
+    secureZero(v, sizeof(v));
+    secureZero(h, sizeof(h));
+}
+
+template <typename V>
+[[gnu::always_inline]] static inline void blake3_hash_many_v(const uint8_t *input, size_t count, size_t blocks,
+                                                             const uint32_t *key, uint64_t counter, bool increment,
+                                                             uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd,
+                                                             uint8_t *out)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+    size_t stride = blocks * BLAKE3_BLOCK;
+
+    for (; count >= N; count -= N) {
+        blake3_hash_lanes<V>(input, stride, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+
+        input += N * stride;
+        out += N * 32;
+        counter += increment ? N : 0;
+    }
+
+    blake3_hash_many_portable(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+}
+
+#if UB_CRYPTO_X86
+[[gnu::target("avx2")]]
+static void blake3_hash_many_avx2(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key,
+                                  uint64_t counter, bool increment, uint8_t flags, uint8_t flagsStart,
+                                  uint8_t flagsEnd, uint8_t *out)
+{
+    blake3_hash_many_v<blake3_v8>(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+}
+
+[[gnu::target("sse4.1")]]
+static void blake3_hash_many_sse41(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key,
+                                   uint64_t counter, bool increment, uint8_t flags, uint8_t flagsStart,
+                                   uint8_t flagsEnd, uint8_t *out)
+{
+    blake3_hash_many_v<blake3_v4>(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+}
+#else
+static void blake3_hash_many_neon(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key,
+                                  uint64_t counter, bool increment, uint8_t flags, uint8_t flagsStart,
+                                  uint8_t flagsEnd, uint8_t *out)
+{
+    blake3_hash_many_v<blake3_v4>(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+}
+#endif
+
+#endif // UB_CRYPTO_BLAKE3_SIMD
+
+void ub::crypto::impl::blake3HashMany(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key,
+                                      uint64_t counter, bool increment, uint8_t flags, uint8_t flagsStart,
+                                      uint8_t flagsEnd, uint8_t *out)
+{
+#if UB_CRYPTO_X86
+    if (cpuFeatures() & CPU_X86_AVX2) {
+        blake3_hash_many_avx2(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+        return;
+    }
+
+    if (cpuFeatures() & CPU_X86_SSE41) {
+        blake3_hash_many_sse41(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+        return;
+    }
+#elif UB_CRYPTO_ARM64
+    blake3_hash_many_neon(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+    return;
+#endif
+
+    blake3_hash_many_portable(input, count, blocks, key, counter, increment, flags, flagsStart, flagsEnd, out);
+}
@@ -0,0 +1,123 @@
+#ifndef UB_SRC_CRYPTO_HASH_BLAKE_COMMON_H
+#define UB_SRC_CRYPTO_HASH_BLAKE_COMMON_H
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "../cpu.hpp"
+
+// Multi-input BLAKE3 compression runs in SIMD lanes on hosted targets, microcontrollers use compact scalar code
+#if UB_CRYPTO_X86 || UB_CRYPTO_ARM64
+#define UB_CRYPTO_BLAKE3_SIMD       1
+#else
+#define UB_CRYPTO_BLAKE3_SIMD       0
+#endif
+
+namespace ub::crypto::impl {
+    /** Initialization vector shared by BLAKE2s and BLAKE3 (same as SHA-256 initial state) */
+    static constexpr uint32_t blake_iv[8] = {
+            0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+
+    /** BLAKE2s message schedule, 10 rounds */
+    static constexpr uint8_t blake2s_sigma[10][16] = {
+            {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+            { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+            { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+            {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+            {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+            {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+            { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+            { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+            {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+            { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+    };
+
+    /** BLAKE3 message schedule: message permutation applied 0..6 times, 7 rounds */
+    static constexpr uint8_t blake3_sigma[7][16] = {
+            {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+            {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+            {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+            { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+            { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+            {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+            { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+    };
+
+    /**
+     * Rotate `x ^ y` right by `N` bits, `T` is either `uint32_t` or a vector of 32-bit words. Vectors are passed by
+     * reference to keep the helpers ABI-neutral when they are inlined into functions with different target attributes.
+     */
+    template <int N, typename T>
+    [[gnu::always_inline]] inline void blakeXorRotate(T &x, const T &y) {
+        x ^= y;
+
+        if constexpr (sizeof(T) > sizeof(uint32_t) && N % 8 == 0) {
+            // byte-aligned rotation of vector lanes is a single byte shuffle
+            typedef uint8_t bytes16_t __attribute__((vector_size(16)));
+            typedef uint8_t bytes32_t __attribute__((vector_size(32)));
+            typedef std::conditional_t<sizeof(T) == 16, bytes16_t, bytes32_t> bytes_t;
+
+            bytes_t mask;
+            for (size_t i = 0; i < sizeof(T); i++) {
+                mask[i] = (i & ~3) | ((i + N / 8) & 3);
+            }
+
+            x = (T) __builtin_shuffle((bytes_t) x, mask);
+        } else {
+            x = (x >> N) | (x << (32 - N));
+        }
+    }
+
+    /** BLAKE2s/BLAKE3 quarter-round function */
+    template <typename T>
+    [[gnu::always_inline]] inline void blakeG(T *v, int a, int b, int c, int d, const T &x, const T &y) {
+        v[a] = v[a] + v[b] + x; blakeXorRotate<16>(v[d], v[a]);
+        v[c] = v[c] + v[d];     blakeXorRotate<12>(v[b], v[c]);
+        v[a] = v[a] + v[b] + y; blakeXorRotate<8>(v[d], v[a]);
+        v[c] = v[c] + v[d];     blakeXorRotate<7>(v[b], v[c]);
+    }
+
+    /** Single round of BLAKE2s/BLAKE3 over state `v` and message `m` with schedule row `s` */
+    template <typename T>
+    [[gnu::always_inline]] inline void blakeRound(T *v, const T *m, const uint8_t *s) {
+        blakeG(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+        blakeG(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+        blakeG(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+        blakeG(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+
+        blakeG(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+        blakeG(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        blakeG(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+        blakeG(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+    }
+
+    enum : uint8_t {
+        BLAKE3_CHUNK_START          = 1 << 0,
+        BLAKE3_CHUNK_END            = 1 << 1,
+        BLAKE3_PARENT               = 1 << 2,
+        BLAKE3_ROOT                 = 1 << 3,
+        BLAKE3_KEYED_HASH           = 1 << 4,
+        BLAKE3_DERIVE_KEY_CONTEXT   = 1 << 5,
+        BLAKE3_DERIVE_KEY_MATERIAL  = 1 << 6
+    };
+
+    /**
+     * BLAKE3 compression function. Produces full 16-word output, first 8 words are the chaining value. Input
+     * chaining value is consumed before it is overwritten, so `out` could alias `cv`.
+     */
+    void blake3Compress(const uint32_t *cv, const uint8_t *block, uint64_t counter, uint32_t blockLength,
+                        uint32_t flags, uint32_t *out);
+
+    /**
+     * Compute chaining values of `count` inputs of `blocks` full blocks each, stored consecutively in `input`.
+     * Counter of input `i` is `counter + i` if `increment` is set, and `counter` otherwise. The first block of
+     * every input gets additional `flagsStart` flags, and the last block gets `flagsEnd` flags. Chaining values
+     * are written consecutively into `out` as bytes, `out` could alias `input` if `blocks` is one.
+     */
+    void blake3HashMany(const uint8_t *input, size_t count, size_t blocks, const uint32_t *key, uint64_t counter,
+                        bool increment, uint8_t flags, uint8_t flagsStart, uint8_t flagsEnd, uint8_t *out);
+}
+
+#endif // UB_SRC_CRYPTO_HASH_BLAKE_COMMON_H
@@ -0,0 +1,53 @@
+#ifndef UB_SRC_CRYPTO_HASH_HASH_STATE_H
+#define UB_SRC_CRYPTO_HASH_HASH_STATE_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Exported hash midstate starts with format version and algorithm identifier, followed by algorithm-specific fields.
+// All multibyte fields are little-endian, so exported state could be restored on any platform and backend.
+
+namespace ub::crypto::impl {
+    /** Current version of exported midstate format */
+    constexpr uint8_t HASH_STATE_VERSION = 1;
+
+    /** Length of exported midstate header */
+    constexpr size_t HASH_STATE_HEADER = 2;
+
+    enum {
+        HASH_STATE_SHA256       = 1,
+        HASH_STATE_SHA512       = 2,
+        HASH_STATE_KECCAK1600   = 3
+    };
+
+    /** Write midstate header, returns number of bytes written */
+    inline size_t hashStateBegin(uint8_t *buf, uint8_t algorithm) {
+        buf[0] = HASH_STATE_VERSION;
+        buf[1] = algorithm;
+        return HASH_STATE_HEADER;
+    }
+
+    /** Check midstate header and minimal length */
+    inline bool hashStateCheck(const uint8_t *buf, size_t length, uint8_t algorithm, size_t minLength) {
+        return length >= minLength && buf[0] == HASH_STATE_VERSION && buf[1] == algorithm;
+    }
+
+    /** Store `bytes` low bytes of `x` into buffer, least significant byte first */
+    inline void hashStateStore(uint8_t *buf, uint64_t x, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++, x >>= 8) {
+            buf[i] = (uint8_t) x;
+        }
+    }
+
+    /** Load `bytes`-byte integer written with `hashStateStore()` */
+    inline uint64_t hashStateLoad(const uint8_t *buf, size_t bytes) {
+        uint64_t x = 0;
+        for (size_t i = bytes; i != 0; i--) {
+            x = (x << 8) | buf[i - 1];
+        }
+
+        return x;
+    }
+}
+
+#endif // UB_SRC_CRYPTO_HASH_HASH_STATE_H
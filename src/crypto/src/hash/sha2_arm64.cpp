@@ -0,0 +1,106 @@
+#include "sha2_common.hpp"
+
+#if UB_CRYPTO_SHA2_ARM64
+
+#include <ub/crypto/sha2.hpp>
+
+#include <arm_neon.h>
+
+#if defined(__clang__)
+#define TARGET_SHA2     [[gnu::target("sha2")]]
+#define TARGET_SHA512   [[gnu::target("sha3")]]
+#else
+#define TARGET_SHA2     [[gnu::target("+crypto")]]
+#define TARGET_SHA512   [[gnu::target("arch=armv8.2-a+sha3")]]
+#endif
+
+TARGET_SHA2
+void ub::crypto::impl::sha256CompressARMv8(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k) {
+    uint32x4_t s0 = vld1q_u32(state + 0);   // ABCD
+    uint32x4_t s1 = vld1q_u32(state + 4);   // EFGH
+
+    for (; blocks != 0; blocks--, block += sha256::BLOCK) {
+        uint32x4_t abcd = s0;
+        uint32x4_t efgh = s1;
+
+        uint32x4_t w[4];
+        for (uint32_t i = 0; i < 4; i++) {
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + 16 * i)));
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            uint32x4_t m = vaddq_u32(w[i & 3], vld1q_u32(k + 4 * i));
+            uint32x4_t t = s0;
+
+            if (i < 12) {
+                w[i & 3] = vsha256su1q_u32(vsha256su0q_u32(w[i & 3], w[(i + 1) & 3]), w[(i + 2) & 3], w[(i + 3) & 3]);
+            }
+
+            s0 = vsha256hq_u32(s0, s1, m);
+            s1 = vsha256h2q_u32(s1, t, m);
+        }
+
+        s0 = vaddq_u32(s0, abcd);
+        s1 = vaddq_u32(s1, efgh);
+    }
+
+    vst1q_u32(state + 0, s0);
+    vst1q_u32(state + 4, s1);
+}
+
+// Two rounds are performed per iteration with state rotated as (ab, cd, ef, gh) register quadruple,
+// following the instruction sequence recommended for ARMv8.2 SHA512 extensions.
+
+TARGET_SHA512
+void ub::crypto::impl::sha512CompressARMv8(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k) {
+    uint64x2_t ab = vld1q_u64(state + 0);
+    uint64x2_t cd = vld1q_u64(state + 2);
+    uint64x2_t ef = vld1q_u64(state + 4);
+    uint64x2_t gh = vld1q_u64(state + 6);
+
+    for (; blocks != 0; blocks--, block += sha512::BLOCK) {
+        uint64x2_t ab0 = ab, cd0 = cd, ef0 = ef, gh0 = gh;
+
+        uint64x2_t w[8];
+        for (uint32_t i = 0; i < 8; i++) {
+            w[i] = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(block + 16 * i)));
+        }
+
+        for (uint32_t i = 0; i < 40; i++) {
+            uint64x2_t m = vaddq_u64(w[i & 7], vld1q_u64(k + 2 * i));
+            uint64x2_t fg = vextq_u64(ef, gh, 1);
+            uint64x2_t de = vextq_u64(cd, ef, 1);
+
+            m = vextq_u64(m, m, 1);
+            gh = vaddq_u64(gh, m);
+
+            if (i < 32) {
+                uint64x2_t x = vextq_u64(w[(i + 4) & 7], w[(i + 5) & 7], 1);
+                w[i & 7] = vsha512su1q_u64(vsha512su0q_u64(w[i & 7], w[(i + 1) & 7]), w[(i + 7) & 7], x);
+            }
+
+            gh = vsha512hq_u64(gh, fg, de);
+            uint64x2_t x = vaddq_u64(cd, gh);
+            gh = vsha512h2q_u64(gh, cd, ab);
+
+            // rotate registers: new (ab, cd, ef, gh) = (gh, ab, cd + T1, ef)
+            uint64x2_t t = gh;
+            gh = ef;
+            ef = x;
+            cd = ab;
+            ab = t;
+        }
+
+        ab = vaddq_u64(ab, ab0);
+        cd = vaddq_u64(cd, cd0);
+        ef = vaddq_u64(ef, ef0);
+        gh = vaddq_u64(gh, gh0);
+    }
+
+    vst1q_u64(state + 0, ab);
+    vst1q_u64(state + 2, cd);
+    vst1q_u64(state + 4, ef);
+    vst1q_u64(state + 6, gh);
+}
+
+#endif // UB_CRYPTO_SHA2_ARM64
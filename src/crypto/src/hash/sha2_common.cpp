@@ -5,7 +5,7 @@
 constexpr static size_t BLOCK_SHA256 = 64;
 constexpr static size_t TRAILER_SHA256 = 8;
 
-bool ub::crypto::impl::writeSHA2Trailer(uint8_t *block, size_t used, size_t totalBytes, uint8_t k) {
+bool ub::crypto::impl::writeSHA2Trailer(uint8_t *block, size_t used, uint64_t totalBytes, uint8_t k) {
     size_t blockLength = BLOCK_SHA256 << k;
 
     memset(block + used, 0, blockLength - used);
@@ -13,9 +13,53 @@ bool ub::crypto::impl::writeSHA2Trailer(uint8_t *block, size_t used, size_t tota
         return false;
     }
 
-    // Support up to 4GB data length without integer overflow on 32-bit platforms:
-    block[blockLength - 1] = (uint8_t) (totalBytes << 3);
-    *((uint32_t *) (block + blockLength - 5)) = __builtin_bswap32(totalBytes >> 5);
+    // 64-bit message length in bits, upper half of SHA-512 128-bit length field stays zero
+    uint64_t totalBits = __builtin_bswap64(totalBytes << 3);
+    memcpy(block + blockLength - sizeof(totalBits), &totalBits, sizeof(totalBits));
 
     return true;
 }
+
+#if UB_CRYPTO_SHA2_DISPATCH
+using namespace ub::crypto::impl;
+
+// Compression functions are resolved on the first use, so hashing is safe even from static constructors
+
+static void sha256_compress_resolve(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k) {
+    sha256_compress_t fn = sha256CompressPortable;
+
+#if UB_CRYPTO_X86
+    if (cpuFeatures() & CPU_X86_SHA) {
+        fn = sha256CompressSHANI;
+    }
+#elif UB_CRYPTO_SHA2_ARM64
+    if (cpuFeatures() & CPU_ARM64_SHA2) {
+        fn = sha256CompressARMv8;
+    }
+#endif
+
+    sha256Compress.store(fn, std::memory_order_relaxed);
+    fn(state, block, blocks, k);
+}
+
+static void sha512_compress_resolve(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k) {
+    sha512_compress_t fn = sha512CompressPortable;
+
+#if UB_CRYPTO_SHA2_ARM64
+    if (cpuFeatures() & CPU_ARM64_SHA512) {
+        fn = sha512CompressARMv8;
+    }
+#endif
+
+    sha512Compress.store(fn, std::memory_order_relaxed);
+    fn(state, block, blocks, k);
+}
+
+std::atomic<sha256_compress_t> ub::crypto::impl::sha256Compress { sha256_compress_resolve };
+std::atomic<sha512_compress_t> ub::crypto::impl::sha512Compress { sha512_compress_resolve };
+
+void ub::crypto::impl::sha2ResetBackends() {
+    sha256Compress.store(sha256_compress_resolve, std::memory_order_relaxed);
+    sha512Compress.store(sha512_compress_resolve, std::memory_order_relaxed);
+}
+#endif
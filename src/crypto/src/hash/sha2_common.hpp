@@ -3,6 +3,23 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <atomic>
+
+#include "../cpu.hpp"
+
+// ARMv8 SHA2 and SHA512 compression functions have not been verified on AArch64 hardware yet, so they are built and
+// selected only when UB_CRYPTO_SHA2_ARM64 is defined to 1
+#if !defined(UB_CRYPTO_SHA2_ARM64) || !UB_CRYPTO_ARM64
+#undef UB_CRYPTO_SHA2_ARM64
+#define UB_CRYPTO_SHA2_ARM64        0
+#endif
+
+// Runtime selection of compression function is available only on targets with accelerated implementations
+#if UB_CRYPTO_X86 || UB_CRYPTO_SHA2_ARM64
+#define UB_CRYPTO_SHA2_DISPATCH 1
+#else
+#define UB_CRYPTO_SHA2_DISPATCH 0
+#endif
 
 namespace ub::crypto::impl {
     enum {
@@ -19,7 +36,46 @@ namespace ub::crypto::impl {
      * @param totalBytes Total number of processed bytes
      * @param k          Parameter to select between SHA-256 and SHA-512 trailers, must be given by K_SHAxxx constant.
      */
-    bool writeSHA2Trailer(uint8_t *block, size_t used, size_t totalBytes, uint8_t k);
+    bool writeSHA2Trailer(uint8_t *block, size_t used, uint64_t totalBytes, uint8_t k);
+
+    /** SHA-256 compression function: update `state` with consecutive `blocks` using round constants `k` */
+    typedef void (*sha256_compress_t)(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k);
+
+    /** SHA-512 compression function: update `state` with consecutive `blocks` using round constants `k` */
+    typedef void (*sha512_compress_t)(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k);
+
+    /** Portable SHA-256 compression function */
+    void sha256CompressPortable(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k);
+
+    /** Portable SHA-512 compression function */
+    void sha512CompressPortable(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k);
+
+#if UB_CRYPTO_X86
+    /** SHA-256 compression function using x86 SHA extensions */
+    void sha256CompressSHANI(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k);
+#endif
+
+#if UB_CRYPTO_SHA2_ARM64
+    /** SHA-256 compression function using ARMv8 SHA2 instructions */
+    void sha256CompressARMv8(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k);
+
+    /** SHA-512 compression function using ARMv8.2 SHA512 instructions */
+    void sha512CompressARMv8(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k);
+#endif
+
+#if UB_CRYPTO_SHA2_DISPATCH
+    /**
+     * SHA-256 compression function selected for the running processor. Could be resolved concurrently by several
+     * threads on the first use, all of them store the same value, so relaxed ordering is sufficient.
+     */
+    extern std::atomic<sha256_compress_t> sha256Compress;
+
+    /** SHA-512 compression function selected for the running processor, see `sha256Compress` */
+    extern std::atomic<sha512_compress_t> sha512Compress;
+
+    /** Forget selected compression functions, so they are selected again on next use (see `cpuRestrictFeatures()`) */
+    void sha2ResetBackends();
+#endif
 }
 
 #endif // UB_SRC_CRYPTO_HASH_SHA2_COMMON_H
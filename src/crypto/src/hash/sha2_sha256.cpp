@@ -2,6 +2,7 @@
 
 #include <ub/crypto/utility.hpp>
 #include "sha2_common.hpp"
+#include "hash_state.hpp"
 
 #include <cstring>
 #include <algorithm>
@@ -11,6 +12,9 @@
 using namespace ub::crypto;
 using namespace ub::crypto::impl;
 
+static constexpr size_t SHA256_BLOCK = sha256::BLOCK / sizeof(uint32_t);
+static constexpr size_t SHA256_ROUND = 64;
+
 const uint32_t sha256::initialState[] = {
         0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
 };
@@ -39,20 +43,39 @@ void sha256::reset() {
 }
 
 void sha256::update(const uint8_t *data, size_t length) {
-    while (length != 0) {
-        uint32_t used = m_totalBytes & (BLOCK - 1);
-        uint32_t len = std::min(length, (size_t) (BLOCK - used));
+    if (length == 0) {
+        return;
+    }
+
+    uint32_t used = m_totalBytes & (BLOCK - 1);
+    m_totalBytes += length;
 
+    // complete partially filled block first
+    if (used != 0) {
+        uint32_t len = std::min(length, (size_t) (BLOCK - used));
         std::memcpy(m_block + used, data, len);
 
         data += len;
         length -= len;
-        m_totalBytes += len;
 
-        if ((m_totalBytes & (BLOCK - 1)) == 0) {
-            processBlock();
+        if (used + len != BLOCK) {
+            return;
         }
+
+        processBlocks(m_block, 1);
+    }
+
+    // compress full blocks directly from the input buffer
+    size_t blocks = length / BLOCK;
+    if (blocks != 0) {
+        processBlocks(data, blocks);
+
+        data += blocks * BLOCK;
+        length -= blocks * BLOCK;
     }
+
+    // stash the tail for the next update
+    std::memcpy(m_block, data, length);
 }
 
 void sha256::finish(uint8_t *digest) {
@@ -61,11 +84,11 @@ void sha256::finish(uint8_t *digest) {
     m_block[used++] = 0x80; // terminate message with '1' bit
 
     if (!writeSHA2Trailer(m_block, used, m_totalBytes, K_SHA256)) {
-        processBlock();
+        processBlocks(m_block, 1);
         writeSHA2Trailer(m_block, 0, m_totalBytes, K_SHA256);
     }
 
-    processBlock();
+    processBlocks(m_block, 1);
 
     for (uint32_t i = 0; i < W_STATE; i++) {
         ((uint32_t *) digest)[i] = __builtin_bswap32(m_state[i]);
@@ -74,40 +97,90 @@ void sha256::finish(uint8_t *digest) {
     reset();
 }
 
-void sha256::processBlock() {
-    uint32_t w[W_ROUND];
+size_t sha256::exportState(uint8_t *buffer) const {
+    size_t used = m_totalBytes & (BLOCK - 1);
+    size_t p = hashStateBegin(buffer, HASH_STATE_SHA256);
+
+    hashStateStore(buffer + p, m_totalBytes, sizeof(m_totalBytes));
+    p += sizeof(m_totalBytes);
+
+    for (uint32_t i = 0; i < W_STATE; i++, p += sizeof(m_state[0])) {
+        hashStateStore(buffer + p, m_state[i], sizeof(m_state[i]));
+    }
+
+    std::memcpy(buffer + p, m_block, used);
+    return p + used;
+}
 
-    for (uint32_t i = 0; i < W_BLOCK; i++) {
-        uint32_t wi = ((uint32_t *) m_block)[i];
-        w[i] = __builtin_bswap32(wi); // assume little-endian system
+bool sha256::importState(const uint8_t *buffer, size_t length) {
+    constexpr size_t fixed = HASH_STATE_HEADER + sizeof(m_totalBytes) + sizeof(m_state);
+    if (!hashStateCheck(buffer, length, HASH_STATE_SHA256, fixed)) {
+        return false;
     }
 
-    for (uint32_t i = W_BLOCK; i < W_ROUND; i++) {
-        uint32_t w0 = w[i - 15];
-        uint32_t s0 = ROT(w0, 7) ^ ROT(w0, 18) ^ (w0 >> 3);
+    uint64_t totalBytes = hashStateLoad(buffer + HASH_STATE_HEADER, sizeof(m_totalBytes));
+    size_t used = totalBytes & (BLOCK - 1);
+    if (length != fixed + used) {
+        return false;
+    }
 
-        uint32_t w1 = w[i - 2];
-        uint32_t s1 = ROT(w1, 17) ^ ROT(w1, 19) ^ (w1 >> 10);
+    reset();
+    m_totalBytes = totalBytes;
 
-        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    size_t p = HASH_STATE_HEADER + sizeof(m_totalBytes);
+    for (uint32_t i = 0; i < W_STATE; i++, p += sizeof(m_state[0])) {
+        m_state[i] = hashStateLoad(buffer + p, sizeof(m_state[i]));
     }
 
-    uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
-    uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    std::memcpy(m_block, buffer + p, used);
+    return true;
+}
+
+void sha256::processBlocks(const uint8_t *data, size_t blocks) {
+#if UB_CRYPTO_SHA2_DISPATCH
+    sha256Compress.load(std::memory_order_relaxed)(m_state, data, blocks, roundConstants);
+#else
+    sha256CompressPortable(m_state, data, blocks, roundConstants);
+#endif
+}
+
+void ub::crypto::impl::sha256CompressPortable(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k) {
+    for (; blocks != 0; blocks--, block += sha256::BLOCK) {
+        uint32_t w[SHA256_ROUND];
 
-    for (uint32_t i = 0; i < W_ROUND; i++) {
-        uint32_t s1 = ROT(e, 6) ^ ROT(e, 11) ^ ROT(e, 25);
-        uint32_t ch = (e & f) ^ (~e & g);
-        uint32_t t1 = h + s1 + ch + roundConstants[i] + w[i];
+        for (uint32_t i = 0; i < SHA256_BLOCK; i++) {
+            uint32_t wi;
+            std::memcpy(&wi, block + i * sizeof(uint32_t), sizeof(wi));
+            w[i] = __builtin_bswap32(wi); // assume little-endian system
+        }
 
-        uint32_t s2 = ROT(a, 2) ^ ROT(a, 13) ^ ROT(a, 22);
-        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-        uint32_t t2 = s2 + maj;
+        for (uint32_t i = SHA256_BLOCK; i < SHA256_ROUND; i++) {
+            uint32_t w0 = w[i - 15];
+            uint32_t s0 = ROT(w0, 7) ^ ROT(w0, 18) ^ (w0 >> 3);
 
-        h = g; g = f; f = e; e = d + t1;
-        d = c; c = b; b = a; a = t1 + t2;
-    }
+            uint32_t w1 = w[i - 2];
+            uint32_t s1 = ROT(w1, 17) ^ ROT(w1, 19) ^ (w1 >> 10);
 
-    m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
-    m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (uint32_t i = 0; i < SHA256_ROUND; i++) {
+            uint32_t s1 = ROT(e, 6) ^ ROT(e, 11) ^ ROT(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + k[i] + w[i];
+
+            uint32_t s2 = ROT(a, 2) ^ ROT(a, 13) ^ ROT(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s2 + maj;
+
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
 }
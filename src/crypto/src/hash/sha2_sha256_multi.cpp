@@ -0,0 +1,211 @@
+#include <ub/crypto/sha2.hpp>
+
+#include <ub/crypto/utility.hpp>
+#include "sha2_common.hpp"
+#include "../cpu.hpp"
+
+#include <cstring>
+
+#define ROT(x, i)                   (((x) >> (i)) | ((x) << (32 - (i))))
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Vector types are lowered by compiler to SSE2/AVX2 registers on x86 and to generic scalar code on other targets
+typedef uint32_t sha256m_v4 __attribute__((vector_size(16)));
+typedef uint32_t sha256m_v8 __attribute__((vector_size(32)));
+
+static constexpr size_t SHA256M_STATE = sha256::OUTPUT / sizeof(uint32_t);
+static constexpr size_t SHA256M_BLOCK = sha256::BLOCK / sizeof(uint32_t);
+static constexpr size_t SHA256M_ROUND = 64;
+static constexpr size_t SHA256M_IDLE  = SIZE_MAX;
+
+/** SHA-256 constant tables, shared with scalar implementation */
+struct sha256m_tables {
+    const uint32_t *initialState;
+    const uint32_t *roundConstants;
+};
+
+/** State of a single lane of multi-buffer engine */
+struct sha256m_lane {
+    size_t        index;                        //! Index of message being hashed, or SHA256M_IDLE
+    const uint8_t *data;                        //! Message data
+    size_t        blocks;                       //! Number of full blocks in message data
+    size_t        totalBlocks;                  //! Number of full blocks plus padded tail blocks
+    size_t        next;                         //! Index of next block to process
+    uint8_t       tail[2 * sha256::BLOCK];      //! Message tail with padding and length trailer
+};
+
+static const uint8_t sha256m_idle_block[sha256::BLOCK] {};
+
+static void sha256m_load(sha256m_lane &lane, size_t index, const uint8_t *data, size_t length) {
+    lane.index = index;
+    lane.data = data;
+    lane.blocks = length / sha256::BLOCK;
+    lane.next = 0;
+
+    size_t used = length & (sha256::BLOCK - 1);
+    std::memcpy(lane.tail, data + lane.blocks * sha256::BLOCK, used);
+    lane.tail[used++] = 0x80; // terminate message with '1' bit
+
+    if (writeSHA2Trailer(lane.tail, used, length, K_SHA256)) {
+        lane.totalBlocks = lane.blocks + 1;
+    } else {
+        writeSHA2Trailer(lane.tail + sha256::BLOCK, 0, length, K_SHA256);
+        lane.totalBlocks = lane.blocks + 2;
+    }
+}
+
+static const uint8_t *sha256m_next_block(const sha256m_lane &lane) {
+    if (lane.index == SHA256M_IDLE) {
+        return sha256m_idle_block;
+    }
+
+    if (lane.next < lane.blocks) {
+        return lane.data + lane.next * sha256::BLOCK;
+    }
+
+    return lane.tail + (lane.next - lane.blocks) * sha256::BLOCK;
+}
+
+template <typename V>
+[[gnu::always_inline]] static inline void sha256m_compress(V *state, const uint8_t * const *blocks,
+                                                           const uint32_t *k)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+    V w[SHA256M_BLOCK];
+
+    for (size_t i = 0; i < SHA256M_BLOCK; i++) {
+        for (size_t l = 0; l < N; l++) {
+            uint32_t wi;
+            std::memcpy(&wi, blocks[l] + i * sizeof(uint32_t), sizeof(wi));
+            w[i][l] = __builtin_bswap32(wi); // assume little-endian system
+        }
+    }
+
+    V a = state[0], b = state[1], c = state[2], d = state[3];
+    V e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < SHA256M_ROUND; i++) {
+        // message schedule is kept in a rolling window of 16 words
+        if (i >= SHA256M_BLOCK) {
+            V w0 = w[(i - 15) & 15];
+            V s0 = ROT(w0, 7) ^ ROT(w0, 18) ^ (w0 >> 3);
+
+            V w1 = w[(i - 2) & 15];
+            V s1 = ROT(w1, 17) ^ ROT(w1, 19) ^ (w1 >> 10);
+
+            w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+        }
+
+        V s1 = ROT(e, 6) ^ ROT(e, 11) ^ ROT(e, 25);
+        V ch = (e & f) ^ (~e & g);
+        V t1 = h + s1 + ch + k[i] + w[i & 15];
+
+        V s2 = ROT(a, 2) ^ ROT(a, 13) ^ ROT(a, 22);
+        V maj = (a & b) ^ (a & c) ^ (b & c);
+        V t2 = s2 + maj;
+
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+template <typename V>
+[[gnu::always_inline]] static inline void sha256m_run(const sha256m_tables &t, uint8_t * const *digests,
+                                                      const uint8_t * const *messages, const size_t *lengths,
+                                                      size_t count)
+{
+    constexpr size_t N = sizeof(V) / sizeof(uint32_t);
+
+    sha256m_lane lanes[N];
+    const uint8_t *blocks[N];
+    V state[SHA256M_STATE];
+
+    size_t nextMessage = 0;
+    size_t active = 0;
+
+    for (size_t l = 0; l < N; l++) {
+        lanes[l].index = SHA256M_IDLE;
+
+        if (nextMessage < count) {
+            sha256m_load(lanes[l], nextMessage, messages[nextMessage], lengths[nextMessage]);
+            nextMessage++;
+            active++;
+        }
+
+        for (size_t i = 0; i < SHA256M_STATE; i++) {
+            state[i][l] = t.initialState[i];
+        }
+    }
+
+    while (active != 0) {
+        for (size_t l = 0; l < N; l++) {
+            blocks[l] = sha256m_next_block(lanes[l]);
+        }
+
+        sha256m_compress(state, blocks, t.roundConstants);
+
+        for (size_t l = 0; l < N; l++) {
+            sha256m_lane &lane = lanes[l];
+            if (lane.index == SHA256M_IDLE) {
+                continue;
+            }
+
+            lane.next++;
+            if (lane.next != lane.totalBlocks) {
+                continue;
+            }
+
+            for (size_t i = 0; i < SHA256M_STATE; i++) {
+                uint32_t v = __builtin_bswap32(state[i][l]);
+                std::memcpy(digests[lane.index] + i * sizeof(uint32_t), &v, sizeof(v));
+                state[i][l] = t.initialState[i];
+            }
+
+            if (nextMessage < count) {
+                sha256m_load(lane, nextMessage, messages[nextMessage], lengths[nextMessage]);
+                nextMessage++;
+            } else {
+                lane.index = SHA256M_IDLE;
+                active--;
+            }
+        }
+    }
+
+    secureZero(lanes, sizeof(lanes));
+    secureZero(state, sizeof(state));
+}
+
+#if UB_CRYPTO_X86
+[[gnu::target("avx2")]]
+static void sha256m_run_avx2(const sha256m_tables &t, uint8_t * const *digests, const uint8_t * const *messages,
+                             const size_t *lengths, size_t count)
+{
+    sha256m_run<sha256m_v8>(t, digests, messages, lengths, count);
+}
+#endif
+
+static void sha256m_run_generic(const sha256m_tables &t, uint8_t * const *digests, const uint8_t * const *messages,
+                                const size_t *lengths, size_t count)
+{
+    sha256m_run<sha256m_v4>(t, digests, messages, lengths, count);
+}
+
+void sha256_multi::hash(uint8_t * const *digests, const uint8_t * const *messages, const size_t *lengths,
+                        size_t count)
+{
+    const sha256m_tables t { sha256::initialState, sha256::roundConstants };
+
+#if UB_CRYPTO_X86
+    if (cpuFeatures() & CPU_X86_AVX2) {
+        sha256m_run_avx2(t, digests, messages, lengths, count);
+        return;
+    }
+#endif
+
+    sha256m_run_generic(t, digests, messages, lengths, count);
+}
@@ -2,7 +2,9 @@
 
 #include <ub/crypto/utility.hpp>
 #include "sha2_common.hpp"
+#include "hash_state.hpp"
 
+#include <cstring>
 #include <algorithm>
 
 #define ROT(x, i)                   (((x) >> (i)) | ((x) << (64 - (i))))
@@ -10,6 +12,9 @@
 using namespace ub::crypto;
 using namespace ub::crypto::impl;
 
+static constexpr size_t SHA512_BLOCK = sha512::BLOCK / sizeof(uint64_t);
+static constexpr size_t SHA512_ROUND = 80;
+
 const uint64_t sha512::initialState[] = {
         0x6A09E667F3BCC908, 0xBB67AE8584CAA73B, 0x3C6EF372FE94F82B, 0xA54FF53A5F1D36F1,
         0x510E527FADE682D1, 0x9B05688C2B3E6C1F, 0x1F83D9ABFB41BD6B, 0x5BE0CD19137E2179
@@ -47,20 +52,39 @@ void sha512::reset() {
 }
 
 void sha512::update(const uint8_t *data, size_t length) {
-    while (length != 0) {
-        uint32_t used = m_totalBytes & (BLOCK - 1);
-        uint32_t len = std::min(length, (size_t) (BLOCK - used));
+    if (length == 0) {
+        return;
+    }
+
+    uint32_t used = m_totalBytes & (BLOCK - 1);
+    m_totalBytes += length;
 
+    // complete partially filled block first
+    if (used != 0) {
+        uint32_t len = std::min(length, (size_t) (BLOCK - used));
         std::memcpy(m_block + used, data, len);
 
         data += len;
         length -= len;
-        m_totalBytes += len;
 
-        if ((m_totalBytes & (BLOCK - 1)) == 0) {
-            processBlock();
+        if (used + len != BLOCK) {
+            return;
         }
+
+        processBlocks(m_block, 1);
+    }
+
+    // compress full blocks directly from the input buffer
+    size_t blocks = length / BLOCK;
+    if (blocks != 0) {
+        processBlocks(data, blocks);
+
+        data += blocks * BLOCK;
+        length -= blocks * BLOCK;
     }
+
+    // stash the tail for the next update
+    std::memcpy(m_block, data, length);
 }
 
 void sha512::finish(uint8_t *digest) {
@@ -68,11 +92,11 @@ void sha512::finish(uint8_t *digest) {
     m_block[used++] = 0x80; // terminate message with '1' bit
 
     if (!writeSHA2Trailer(m_block, used, m_totalBytes, K_SHA512)) {
-        processBlock();
+        processBlocks(m_block, 1);
         writeSHA2Trailer(m_block, 0, m_totalBytes, K_SHA512);
     }
 
-    processBlock();
+    processBlocks(m_block, 1);
 
     for (uint32_t i = 0; i < W_STATE; i++) {
         ((uint64_t *) digest)[i] = __builtin_bswap64(m_state[i]);
@@ -81,40 +105,90 @@ void sha512::finish(uint8_t *digest) {
     reset();
 }
 
-void sha512::processBlock() {
-    uint64_t w[W_ROUND];
+size_t sha512::exportState(uint8_t *buffer) const {
+    size_t used = m_totalBytes & (BLOCK - 1);
+    size_t p = hashStateBegin(buffer, HASH_STATE_SHA512);
+
+    hashStateStore(buffer + p, m_totalBytes, sizeof(m_totalBytes));
+    p += sizeof(m_totalBytes);
+
+    for (uint32_t i = 0; i < W_STATE; i++, p += sizeof(m_state[0])) {
+        hashStateStore(buffer + p, m_state[i], sizeof(m_state[i]));
+    }
+
+    std::memcpy(buffer + p, m_block, used);
+    return p + used;
+}
 
-    for (uint32_t i = 0; i < W_BLOCK; i++) {
-        uint64_t wi = ((uint64_t *) m_block)[i];
-        w[i] = __builtin_bswap64(wi); // assume little-endian machine
+bool sha512::importState(const uint8_t *buffer, size_t length) {
+    constexpr size_t fixed = HASH_STATE_HEADER + sizeof(m_totalBytes) + sizeof(m_state);
+    if (!hashStateCheck(buffer, length, HASH_STATE_SHA512, fixed)) {
+        return false;
     }
 
-    for (uint32_t i = W_BLOCK; i < W_ROUND; i++) {
-        uint64_t w0 = w[i - 15];
-        uint64_t s0 = ROT(w0, 1) ^ ROT(w0, 8) ^ (w0 >> 7);
+    uint64_t totalBytes = hashStateLoad(buffer + HASH_STATE_HEADER, sizeof(m_totalBytes));
+    size_t used = totalBytes & (BLOCK - 1);
+    if (length != fixed + used) {
+        return false;
+    }
 
-        uint64_t w1 = w[i - 2];
-        uint64_t s1 = ROT(w1, 19) ^ ROT(w1, 61) ^ (w1 >> 6);
+    reset();
+    m_totalBytes = totalBytes;
 
-        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    size_t p = HASH_STATE_HEADER + sizeof(m_totalBytes);
+    for (uint32_t i = 0; i < W_STATE; i++, p += sizeof(m_state[0])) {
+        m_state[i] = hashStateLoad(buffer + p, sizeof(m_state[i]));
     }
 
-    uint64_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
-    uint64_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    std::memcpy(m_block, buffer + p, used);
+    return true;
+}
+
+void sha512::processBlocks(const uint8_t *data, size_t blocks) {
+#if UB_CRYPTO_SHA2_DISPATCH
+    sha512Compress.load(std::memory_order_relaxed)(m_state, data, blocks, roundConstants);
+#else
+    sha512CompressPortable(m_state, data, blocks, roundConstants);
+#endif
+}
+
+void ub::crypto::impl::sha512CompressPortable(uint64_t *state, const uint8_t *block, size_t blocks, const uint64_t *k) {
+    for (; blocks != 0; blocks--, block += sha512::BLOCK) {
+        uint64_t w[SHA512_ROUND];
 
-    for (uint32_t i = 0; i < W_ROUND; i++) {
-        uint64_t s1 = ROT(e, 14) ^ ROT(e, 18) ^ ROT(e, 41);
-        uint64_t ch = (e & f) ^ (~e & g);
-        uint64_t t1 = h + s1 + ch + roundConstants[i] + w[i];
+        for (uint32_t i = 0; i < SHA512_BLOCK; i++) {
+            uint64_t wi;
+            std::memcpy(&wi, block + i * sizeof(uint64_t), sizeof(wi));
+            w[i] = __builtin_bswap64(wi); // assume little-endian machine
+        }
 
-        uint64_t s2 = ROT(a, 28) ^ ROT(a, 34) ^ ROT(a, 39);
-        uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
-        uint64_t t2 = s2 + maj;
+        for (uint32_t i = SHA512_BLOCK; i < SHA512_ROUND; i++) {
+            uint64_t w0 = w[i - 15];
+            uint64_t s0 = ROT(w0, 1) ^ ROT(w0, 8) ^ (w0 >> 7);
 
-        h = g; g = f; f = e; e = d + t1;
-        d = c; c = b; b = a; a = t1 + t2;
-    }
+            uint64_t w1 = w[i - 2];
+            uint64_t s1 = ROT(w1, 19) ^ ROT(w1, 61) ^ (w1 >> 6);
 
-    m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
-    m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (uint32_t i = 0; i < SHA512_ROUND; i++) {
+            uint64_t s1 = ROT(e, 14) ^ ROT(e, 18) ^ ROT(e, 41);
+            uint64_t ch = (e & f) ^ (~e & g);
+            uint64_t t1 = h + s1 + ch + k[i] + w[i];
+
+            uint64_t s2 = ROT(a, 28) ^ ROT(a, 34) ^ ROT(a, 39);
+            uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint64_t t2 = s2 + maj;
+
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
 }
@@ -0,0 +1,278 @@
+#include <ub/crypto/sha2.hpp>
+
+#include <ub/crypto/utility.hpp>
+#include "../parallel.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr uint8_t TREE_LEAF_PREFIX = 0x00;
+static constexpr uint8_t TREE_NODE_PREFIX = 0x01;
+
+// Amount of input handed to each worker thread per batch, a batch is split into ranges of at least one per thread
+static constexpr size_t TREE_BATCH_INPUT = 262144;
+
+// Maximal number of whole leaves in a batch, leaf digests are buffered on stack
+#if UB_CRYPTO_THREADS
+static constexpr size_t TREE_BATCH_LEAVES = 512;
+#else
+static constexpr size_t TREE_BATCH_LEAVES = 1;
+#endif
+
+// Minimal amount of input processed by a worker thread at once
+static constexpr size_t TREE_GRAIN = 65536;
+
+static void tree_node(const uint8_t *left, const uint8_t *right, uint8_t *digest) {
+    sha256 h;
+    h.update(&TREE_NODE_PREFIX, 1);
+    h.update(left, sha256::OUTPUT);
+    h.update(right, sha256::OUTPUT);
+    h.finish(digest);
+}
+
+/** Fold roots of perfect subtrees (one per set bit of leaf `count`) from right to left into the tree root */
+static void tree_fold(const uint8_t (*stack)[sha256::OUTPUT], uint64_t count, uint8_t *root) {
+    bool first = true;
+    for (size_t j = 0; count != 0; j++, count >>= 1) {
+        if ((count & 1) == 0) {
+            continue;
+        }
+
+        if (first) {
+            std::memcpy(root, stack[j], sha256::OUTPUT);
+            first = false;
+        } else {
+            tree_node(stack[j], root, root);
+        }
+    }
+}
+
+/** Root of a subtree over `count` leaf digests, `count` must be non-zero */
+static void tree_root(const uint8_t *digests, size_t count, uint8_t *root) {
+    uint8_t stack[sizeof(size_t) * 8][sha256::OUTPUT];
+
+    // perfect subtrees are merged as soon as they have the same height, same as in sha256_tree::update()
+    for (size_t n = 0; n < count; n++) {
+        uint8_t *node = root;
+        std::memcpy(node, digests + n * sha256::OUTPUT, sha256::OUTPUT);
+
+        size_t j = 0;
+        for (size_t m = n; m & 1; m >>= 1, j++) {
+            tree_node(stack[j], node, node);
+        }
+
+        std::memcpy(stack[j], node, sha256::OUTPUT);
+    }
+
+    tree_fold(stack, count, root);
+    secureZero(stack, sizeof(stack));
+}
+
+/** Largest power of two less than `n`, `n` must be greater than one */
+static size_t tree_split(size_t n) {
+    size_t k = 1;
+    while ((k << 1) < n) {
+        k <<= 1;
+    }
+
+    return k;
+}
+
+/** Arguments of a `hashLeaves()` call, shared by all worker threads */
+struct tree_leaves {
+    size_t          leafSize;
+    const uint8_t   *data;
+    size_t          length;
+    uint8_t         *digests;
+};
+
+static void tree_leaf_range(void *ctx, size_t begin, size_t end) {
+    auto leaves = (const tree_leaves *) ctx;
+
+    for (size_t i = begin; i < end; i++) {
+        size_t offset = i * leaves->leafSize;
+        size_t length = std::min(leaves->leafSize, leaves->length - offset);
+
+        sha256_tree::hashLeaf(leaves->data + offset, length, leaves->digests + i * sha256::OUTPUT);
+    }
+}
+
+sha256_tree::sha256_tree(size_t leafSize): m_stack {} {
+    m_leafSize = std::max((size_t) 1, leafSize);
+    m_used = 0;
+    m_leaves = 0;
+}
+
+void sha256_tree::reset(size_t leafSize) {
+    if (leafSize != 0) {
+        m_leafSize = leafSize;
+    }
+
+    m_leaf.reset();
+    secureZero(m_stack, sizeof(m_stack));
+
+    m_used = 0;
+    m_leaves = 0;
+}
+
+void sha256_tree::update(const uint8_t *data, size_t length) {
+    while (length != 0) {
+        if (m_used == 0 && length >= m_leafSize) {
+            uint8_t digests[TREE_BATCH_LEAVES * OUTPUT];
+            size_t threads = parallelThreads();
+            size_t count = std::max(threads, TREE_BATCH_INPUT / m_leafSize * threads);
+            count = std::min({ length / m_leafSize, count, TREE_BATCH_LEAVES });
+
+            hashLeaves(m_leafSize, data, count * m_leafSize, digests);
+            pushLeaves(digests, count);
+
+            data += count * m_leafSize;
+            length -= count * m_leafSize;
+            continue;
+        }
+
+        if (m_used == 0) {
+            m_leaf.update(&TREE_LEAF_PREFIX, 1);
+        }
+
+        size_t ll = std::min(length, m_leafSize - m_used);
+        m_leaf.update(data, ll);
+
+        data += ll;
+        length -= ll;
+        m_used += ll;
+
+        if (m_used == m_leafSize) {
+            uint8_t digest[OUTPUT];
+            m_leaf.finish(digest);
+            pushLeaves(digest, 1);
+            m_used = 0;
+        }
+    }
+}
+
+void sha256_tree::finish(uint8_t *root) {
+    if (m_used != 0) {
+        uint8_t digest[OUTPUT];
+        m_leaf.finish(digest);
+        pushLeaves(digest, 1);
+        m_used = 0;
+    }
+
+    if (m_leaves == 0) {
+        m_leaf.finish(root);
+        reset();
+        return;
+    }
+
+    tree_fold(m_stack, m_leaves, root);
+    reset();
+}
+
+void sha256_tree::hashLeaf(const uint8_t *leaf, size_t length, uint8_t *digest) {
+    sha256 h;
+    h.update(&TREE_LEAF_PREFIX, 1);
+    h.update(leaf, length);
+    h.finish(digest);
+}
+
+void sha256_tree::hashLeaves(size_t leafSize, const uint8_t *data, size_t length, uint8_t *digests) {
+    leafSize = std::max((size_t) 1, leafSize);
+
+    tree_leaves leaves { leafSize, data, length, digests };
+    size_t count = (length + leafSize - 1) / leafSize;
+
+    // grain is capped by an even share of leaves, so that every worker thread gets at least one range
+    size_t threads = parallelThreads();
+    size_t grain = std::min(TREE_GRAIN / leafSize, (count + threads - 1) / threads);
+
+    parallelFor(count, std::max((size_t) 1, grain), tree_leaf_range, &leaves);
+}
+
+size_t sha256_tree::buildProof(const uint8_t *digests, size_t count, size_t index, uint8_t *proof) {
+    if (index >= count) {
+        return 0;
+    }
+
+    size_t length = 0;
+    for (size_t n = count, m = index; n > 1; length += OUTPUT) {
+        size_t k = tree_split(n);
+        if (m < k) {
+            n = k;
+        } else {
+            m -= k;
+            n -= k;
+        }
+    }
+
+    // siblings are found from the root down and written in reverse order, so proof starts at the leaf level
+    size_t p = length;
+    for (size_t n = count; n > 1;) {
+        size_t k = tree_split(n);
+        p -= OUTPUT;
+
+        if (index < k) {
+            tree_root(digests + k * OUTPUT, n - k, proof + p);
+            n = k;
+        } else {
+            tree_root(digests, k, proof + p);
+            digests += k * OUTPUT;
+            index -= k;
+            n -= k;
+        }
+    }
+
+    return length;
+}
+
+bool sha256_tree::verifyLeaf(const uint8_t *root, size_t count, size_t index, const uint8_t *leaf, size_t length,
+                             const uint8_t *proof, size_t proofLength)
+{
+    if (index >= count || proofLength % OUTPUT != 0) {
+        return false;
+    }
+
+    uint8_t digest[OUTPUT];
+    hashLeaf(leaf, length, digest);
+
+    // RFC 9162, section 2.1.3.2
+    size_t fn = index, sn = count - 1;
+    for (size_t p = 0; p < proofLength; p += OUTPUT) {
+        if (sn == 0) {
+            return false;
+        }
+
+        if ((fn & 1) != 0 || fn == sn) {
+            tree_node(proof + p, digest, digest);
+
+            while ((fn & 1) == 0 && fn != 0) {
+                fn >>= 1;
+                sn >>= 1;
+            }
+        } else {
+            tree_node(digest, proof + p, digest);
+        }
+
+        fn >>= 1;
+        sn >>= 1;
+    }
+
+    return sn == 0 && secureCompare(digest, root, OUTPUT);
+}
+
+void sha256_tree::pushLeaves(const uint8_t *digests, size_t count) {
+    for (size_t i = 0; i < count; i++, m_leaves++) {
+        uint8_t node[OUTPUT];
+        std::memcpy(node, digests + i * OUTPUT, OUTPUT);
+
+        size_t j = 0;
+        for (uint64_t m = m_leaves; m & 1; m >>= 1, j++) {
+            tree_node(m_stack[j], node, node);
+        }
+
+        std::memcpy(m_stack[j], node, OUTPUT);
+    }
+}
@@ -0,0 +1,61 @@
+#include "sha2_common.hpp"
+
+#if UB_CRYPTO_X86
+
+#include <ub/crypto/sha2.hpp>
+
+#include <immintrin.h>
+
+// Implementation follows the Intel SHA extensions reference code: state is kept as ABEF/CDGH register pair,
+// each `sha256rnds2` instruction performs two rounds and message schedule is computed four words at a time.
+
+[[gnu::target("sha,ssse3,sse4.1")]]
+void ub::crypto::impl::sha256CompressSHANI(uint32_t *state, const uint8_t *block, size_t blocks, const uint32_t *k) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    __m128i t = _mm_loadu_si128((const __m128i *) (state + 0));        // DCBA
+    __m128i s1 = _mm_loadu_si128((const __m128i *) (state + 4));       // HGFE
+
+    t = _mm_shuffle_epi32(t, 0xB1);                                     // CDAB
+    s1 = _mm_shuffle_epi32(s1, 0x1B);                                   // EFGH
+    __m128i s0 = _mm_alignr_epi8(t, s1, 8);                             // ABEF
+    s1 = _mm_blend_epi16(s1, t, 0xF0);                                  // CDGH
+
+    // state stays in registers across consecutive blocks
+    for (; blocks != 0; blocks--, block += sha256::BLOCK) {
+        __m128i abef = s0;
+        __m128i cdgh = s1;
+
+        __m128i w[4];
+        for (uint32_t i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (block + 16 * i)), byteSwap);
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            __m128i m = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i *) (k + 4 * i)));
+            s1 = _mm_sha256rnds2_epu32(s1, s0, m);
+            m = _mm_shuffle_epi32(m, 0x0E);
+            s0 = _mm_sha256rnds2_epu32(s0, s1, m);
+
+            if (i < 12) {
+                // W[i+4] = sigma1(W[i+3]) + W[i+2..i+3] + sigma0(W[i+1]) + W[i], four words at a time
+                __m128i x = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                x = _mm_add_epi32(x, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+                w[i & 3] = _mm_sha256msg2_epu32(x, w[(i + 3) & 3]);
+            }
+        }
+
+        s0 = _mm_add_epi32(s0, abef);
+        s1 = _mm_add_epi32(s1, cdgh);
+    }
+
+    t = _mm_shuffle_epi32(s0, 0x1B);                                    // FEBA
+    s1 = _mm_shuffle_epi32(s1, 0xB1);                                   // DCHG
+    s0 = _mm_blend_epi16(t, s1, 0xF0);                                  // DCBA
+    s1 = _mm_alignr_epi8(s1, t, 8);                                     // HGFE
+
+    _mm_storeu_si128((__m128i *) (state + 0), s0);
+    _mm_storeu_si128((__m128i *) (state + 4), s1);
+}
+
+#endif // UB_CRYPTO_X86
@@ -0,0 +1,121 @@
+#ifndef UB_SRC_CRYPTO_HASH_SHA3_COMMON_H
+#define UB_SRC_CRYPTO_HASH_SHA3_COMMON_H
+
+#include <ub/crypto/sha3.hpp>
+
+// Keccak permutation backend: 64-bit lanes on 64-bit hosts, bit-interleaved 32-bit words (suitable for Cortex-M)
+// otherwise. Can be overridden by defining UB_CRYPTO_KECCAK64 to 0 or 1. State representation in `keccak1600::state_t`
+// depends on selected backend, so it must be accessed only through `consume()` and `produce()`.
+#if !defined(UB_CRYPTO_KECCAK64)
+#define UB_CRYPTO_KECCAK64          (__SIZEOF_POINTER__ >= 8)
+#endif
+
+namespace ub::crypto::impl {
+    /** Keccak-f[1600] permutation operating on bit-interleaved lanes (pairs of even and odd bit 32-bit words) */
+    void keccak1600Permute32(keccak1600::state_t &state, uint32_t rounds);
+
+    /** Rearrange bits of 32-bit word, so even bits end up in lower and odd bits in higher 16 bits */
+    inline uint32_t keccak1600SplitBits(uint32_t x) {
+        uint32_t t;
+        t = (x ^ (x >> 1)) & 0x22222222; x ^= t ^ (t << 1);
+        t = (x ^ (x >> 2)) & 0x0C0C0C0C; x ^= t ^ (t << 2);
+        t = (x ^ (x >> 4)) & 0x00F000F0; x ^= t ^ (t << 4);
+        t = (x ^ (x >> 8)) & 0x0000FF00; x ^= t ^ (t << 8);
+        return x;
+    }
+
+    /** Inverse of `keccak1600SplitBits()` */
+    inline uint32_t keccak1600MergeBits(uint32_t x) {
+        uint32_t t;
+        t = (x ^ (x >> 8)) & 0x0000FF00; x ^= t ^ (t << 8);
+        t = (x ^ (x >> 4)) & 0x00F000F0; x ^= t ^ (t << 4);
+        t = (x ^ (x >> 2)) & 0x0C0C0C0C; x ^= t ^ (t << 2);
+        t = (x ^ (x >> 1)) & 0x22222222; x ^= t ^ (t << 1);
+        return x;
+    }
+
+    /** Convert 64-bit lane into bit-interleaved form: even bits into `dst[0]`, odd bits into `dst[1]` */
+    inline void keccak1600Interleave(uint32_t *dst, uint64_t lane) {
+        uint32_t lo = keccak1600SplitBits((uint32_t) lane);
+        uint32_t hi = keccak1600SplitBits((uint32_t) (lane >> 32));
+
+        dst[0] = (lo & 0xFFFF) | (hi << 16);
+        dst[1] = (lo >> 16) | (hi & 0xFFFF0000);
+    }
+
+    /** Convert bit-interleaved lane back to 64-bit form */
+    inline uint64_t keccak1600Deinterleave(const uint32_t *src) {
+        uint32_t lo = keccak1600MergeBits((src[0] & 0xFFFF) | (src[1] << 16));
+        uint32_t hi = keccak1600MergeBits((src[0] >> 16) | (src[1] & 0xFFFF0000));
+
+        return lo | ((uint64_t) hi << 32);
+    }
+
+    /** Maximum number of input segments of a single sponge job */
+    constexpr size_t KECCAK1600_JOB_SEGMENTS = 5;
+
+    /** Input and output of a single message processed by `keccak1600x4Sponge()` */
+    struct keccak1600_job {
+        const uint8_t *data[KECCAK1600_JOB_SEGMENTS];   //! Message is a concatenation of segments
+        size_t        length[KECCAK1600_JOB_SEGMENTS];  //! Segment lengths, unused segments must be empty
+        uint8_t       padded;                           //! Bit mask of segments followed by zero padding to the rate
+        uint8_t       *output;                          //! Output buffer
+        size_t        outputLength;                     //! Number of bytes to squeeze
+        uint8_t       scratch[32];                      //! Storage for short encoded fields referenced by segments
+    };
+
+    /** Callback filling sponge job for message `index` */
+    typedef void (*keccak1600_job_fn)(const void *ctx, size_t index, keccak1600_job &job);
+
+    /**
+     * Run `count` independent sponge computations with `rounds`-round permutation in lanes of `keccak1600x4`.
+     * Each job is padded with `trailer` followed by the final '1' bit, same as in `keccak1600::finish()`.
+     */
+    void keccak1600x4Sponge(uint8_t rate, uint8_t trailer, uint32_t rounds, size_t count, keccak1600_job_fn fn,
+                            const void *ctx);
+
+    /**
+     * Hash `count` consecutive leaves of `leafLength` bytes from `data` into `outputs`, `outputLength` bytes each.
+     * Leaves are spread over worker threads and `keccak1600x4` lanes, padding is the same as in `keccak1600x4Sponge()`.
+     */
+    void keccak1600HashLeaves(uint8_t rate, uint8_t trailer, uint32_t rounds, const uint8_t *data, size_t leafLength,
+                              size_t count, uint8_t *outputs, size_t outputLength);
+
+    /** Maximum length of SP 800-185 left_encode() and right_encode() output */
+    constexpr size_t CSHAKE_ENCODE_MAX = sizeof(uint64_t) + 1;
+
+    /** SP 800-185 left_encode(x), returns number of bytes written */
+    size_t cshakeLeftEncode(uint8_t *buf, uint64_t x);
+
+    /** SP 800-185 right_encode(x), returns number of bytes written */
+    size_t cshakeRightEncode(uint8_t *buf, uint64_t x);
+
+    /** Absorb SP 800-185 encode_string(s), string length is specified in bytes */
+    void cshakeEncodeString(keccak1600 &k, const uint8_t *s, size_t length);
+
+    /** Start SP 800-185 bytepad(..., rate): absorb left_encode(rate) */
+    void cshakeBytepadBegin(keccak1600 &k);
+
+    /** Finish SP 800-185 bytepad(..., rate): zero-pad absorbed data to the block boundary */
+    void cshakeBytepadEnd(keccak1600 &k);
+
+    /**
+     * Reset `k` and absorb cSHAKE prefix bytepad(encode_string(N) || encode_string(S), rate). Rate must be set
+     * before the call.
+     */
+    void cshakeInit(keccak1600 &k, const uint8_t *name, size_t nameLength, const uint8_t *custom,
+                    size_t customLength);
+
+    /** Padding trailer of cSHAKE: '00' suffix followed by '1' padding bit */
+    constexpr uint8_t CSHAKE_TRAILER = 0x04;
+
+    /** Padding trailer of SHAKE: '1111' suffix followed by '1' padding bit */
+    constexpr uint8_t SHAKE_TRAILER = 0x1F;
+
+#if UB_CRYPTO_KECCAK64
+    /** Keccak-f[1600] permutation operating on 64-bit lanes, fully unrolled round with lane complementing */
+    void keccak1600Permute64(keccak1600::state_t &state, uint32_t rounds);
+#endif
+}
+
+#endif // UB_SRC_CRYPTO_HASH_SHA3_COMMON_H
@@ -0,0 +1,159 @@
+#include <ub/crypto/cshake.hpp>
+
+#include "sha3_common.hpp"
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static uint32_t cshake_rate(uint32_t variant) {
+    return keccak1600::LENGTH - (32 << variant);
+}
+
+static uint8_t cshake_encoded_length(uint64_t x) {
+    x = x | 1;   // at least one byte must be serialized
+
+    uint8_t r = 0;
+    while (x != 0) {
+        r++;
+        x >>= 8;
+    }
+
+    return r;
+}
+
+size_t ub::crypto::impl::cshakeLeftEncode(uint8_t *buf, uint64_t x) {
+    size_t l = cshake_encoded_length(x);
+    buf[0] = l;
+
+    size_t i = l;
+    while (i != 0) {
+        buf[i] = (uint8_t) x;
+        i--;
+        x >>= 8;
+    }
+
+    return l + 1;
+}
+
+size_t ub::crypto::impl::cshakeRightEncode(uint8_t *buf, uint64_t x) {
+    size_t l = cshake_encoded_length(x);
+    buf[l] = l;
+
+    size_t i = l;
+    while (i != 0) {
+        i--;
+        buf[i] = (uint8_t) x;
+        x >>= 8;
+    }
+
+    return l + 1;
+}
+
+void ub::crypto::impl::cshakeEncodeString(keccak1600 &k, const uint8_t *s, size_t length) {
+    uint8_t buf[CSHAKE_ENCODE_MAX];
+    k.consume(buf, cshakeLeftEncode(buf, (uint64_t) length << 3));
+    k.consume(s, length);
+}
+
+void ub::crypto::impl::cshakeBytepadBegin(keccak1600 &k) {
+    uint8_t buf[CSHAKE_ENCODE_MAX];
+    k.consume(buf, cshakeLeftEncode(buf, k.rate));
+}
+
+void ub::crypto::impl::cshakeBytepadEnd(keccak1600 &k) {
+    if (k.ptr != 0) {
+        keccak1600::apply(k.st, k.rounds != 0 ? k.rounds : keccak1600::ROUNDS);
+        k.ptr = 0;
+    }
+}
+
+void ub::crypto::impl::cshakeInit(keccak1600 &k, const uint8_t *name, size_t nameLength, const uint8_t *custom,
+                                  size_t customLength)
+{
+    k.reset();
+
+    cshakeBytepadBegin(k);
+    cshakeEncodeString(k, name, nameLength);
+    cshakeEncodeString(k, custom, customLength);
+    cshakeBytepadEnd(k);
+}
+
+// cSHAKE -------------------------------------------------------------------------------------------------------------
+
+cshake::cshake(): k {} {
+    m_trailer = CSHAKE_TRAILER;
+    m_generating = false;
+}
+
+void cshake::reset() {
+    k.reset();
+    m_generating = false;
+}
+
+void cshake::init(uint32_t variant, const uint8_t *name, size_t nameLength, const uint8_t *custom,
+                  size_t customLength)
+{
+    k.rate = cshake_rate(variant);
+    m_generating = false;
+
+    if (nameLength == 0 && customLength == 0) {
+        k.reset();
+        m_trailer = SHAKE_TRAILER;
+    } else {
+        cshakeInit(k, name, nameLength, custom, customLength);
+        m_trailer = CSHAKE_TRAILER;
+    }
+}
+
+void cshake::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        k.finish(m_trailer);
+        m_generating = true;
+    }
+
+    k.produce(output, length);
+}
+
+// TupleHash ----------------------------------------------------------------------------------------------------------
+
+static const uint8_t TUPLEHASH_NAME[] = { 'T', 'u', 'p', 'l', 'e', 'H', 'a', 's', 'h' };
+
+tuplehash::tuplehash(): k {} {
+    m_outputLength = 0;
+    m_generating = false;
+}
+
+void tuplehash::reset() {
+    k.reset();
+    m_outputLength = 0;
+    m_generating = false;
+}
+
+void tuplehash::init(uint32_t variant, const uint8_t *custom, size_t customLength, size_t outputLength) {
+    k.rate = cshake_rate(variant);
+    cshakeInit(k, TUPLEHASH_NAME, sizeof(TUPLEHASH_NAME), custom, customLength);
+
+    m_outputLength = outputLength;
+    m_generating = false;
+}
+
+void tuplehash::add(const uint8_t *data, size_t length) {
+    cshakeEncodeString(k, data, length);
+}
+
+void tuplehash::finish(uint8_t *output) {
+    generate(output, m_outputLength);
+}
+
+void tuplehash::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        // right_encode(L), XOF variant encodes zero output length
+        uint8_t buf[CSHAKE_ENCODE_MAX];
+        k.consume(buf, cshakeRightEncode(buf, (uint64_t) m_outputLength << 3));
+
+        k.finish(CSHAKE_TRAILER);
+        m_generating = true;
+    }
+
+    k.produce(output, length);
+}
@@ -0,0 +1,158 @@
+#include <ub/crypto/kangarootwelve.hpp>
+
+#include "sha3_common.hpp"
+#include "../parallel.hpp" // UB_CRYPTO_THREADS
+
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr uint8_t KT_RATE            = keccak1600::LENGTH - 32;   // TurboSHAKE128
+static constexpr uint8_t KT_DOMAIN_SINGLE   = 0x07;                     // message fits into the first chunk
+static constexpr uint8_t KT_DOMAIN_FINAL    = 0x06;                     // final node of the tree
+static constexpr uint8_t KT_DOMAIN_LEAF     = 0x0B;                     // leaf producing chaining value
+
+// Number of whole chunks handed to worker threads at once, chaining values are buffered on stack
+#if UB_CRYPTO_THREADS
+static constexpr size_t KT_BATCH = 128;
+#else
+static constexpr size_t KT_BATCH = 4;
+#endif
+
+static size_t kt_length_encode(uint8_t *buf, uint64_t x) {
+    size_t l = 0;
+    for (uint64_t t = x; t != 0; t >>= 8) {
+        l++;
+    }
+
+    for (size_t i = 0; i < l; i++) {
+        buf[i] = (uint8_t) (x >> ((l - 1 - i) << 3));
+    }
+
+    buf[l] = l;
+    return l + 1;
+}
+
+static void kt_leaf_init(keccak1600 &k) {
+    k.reset();
+    k.rate = KT_RATE;
+    k.rounds = turboshake::ROUNDS;
+}
+
+kangarootwelve::kangarootwelve(): m_node {}, m_leaf {} {
+    reset();
+}
+
+void kangarootwelve::reset() {
+    kt_leaf_init(m_node);
+    kt_leaf_init(m_leaf);
+
+    m_length = 0;
+    m_leaves = 0;
+    m_generating = false;
+}
+
+void kangarootwelve::update(const uint8_t *data, size_t length) {
+    if (m_generating) {
+        reset();
+    }
+
+    while (length != 0) {
+        // first chunk goes directly into the final node
+        if (m_length < CHUNK) {
+            size_t ll = std::min(length, (size_t) (CHUNK - m_length));
+            m_node.consume(data, ll);
+
+            data += ll;
+            length -= ll;
+            m_length += ll;
+            continue;
+        }
+
+        if (m_length == CHUNK) {
+            static const uint8_t marker[8] = { 0x03 };
+            m_node.consume(marker, sizeof(marker));
+        }
+
+        size_t used = (m_length - CHUNK) % CHUNK;
+        if (used == 0 && length >= CHUNK) {
+            size_t count = std::min(length / CHUNK, KT_BATCH);
+            processLeaves(data, count);
+
+            data += count * CHUNK;
+            length -= count * CHUNK;
+            m_length += count * CHUNK;
+            continue;
+        }
+
+        size_t ll = std::min(length, CHUNK - used);
+        m_leaf.consume(data, ll);
+
+        data += ll;
+        length -= ll;
+        m_length += ll;
+
+        if (used + ll == CHUNK) {
+            finishLeaf();
+        }
+    }
+}
+
+void kangarootwelve::finish(const uint8_t *customization, size_t length) {
+    if (m_generating) {
+        return;
+    }
+
+    // S = M || C || length_encode(|C|)
+    uint8_t buf[sizeof(uint64_t) + 1];
+    update(customization, length);
+    update(buf, kt_length_encode(buf, length));
+
+    if (m_length <= CHUNK) {
+        m_node.finish(KT_DOMAIN_SINGLE);
+    } else {
+        if ((m_length - CHUNK) % CHUNK != 0) {
+            finishLeaf();
+        }
+
+        static const uint8_t trailer[2] = { 0xFF, 0xFF };
+
+        m_node.consume(buf, kt_length_encode(buf, m_leaves));
+        m_node.consume(trailer, sizeof(trailer));
+        m_node.finish(KT_DOMAIN_FINAL);
+    }
+
+    m_generating = true;
+}
+
+void kangarootwelve::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        finish();
+    }
+
+    m_node.produce(output, length);
+}
+
+void kangarootwelve::finishLeaf() {
+    uint8_t cv[CV];
+
+    m_leaf.finish(KT_DOMAIN_LEAF);
+    m_leaf.produce(cv, sizeof(cv));
+    kt_leaf_init(m_leaf);
+
+    m_node.consume(cv, sizeof(cv));
+    m_leaves++;
+
+    secureZero(cv, sizeof(cv));
+}
+
+void kangarootwelve::processLeaves(const uint8_t *data, size_t count) {
+    uint8_t cvs[KT_BATCH * CV];
+    keccak1600HashLeaves(KT_RATE, KT_DOMAIN_LEAF, turboshake::ROUNDS, data, CHUNK, count, cvs, CV);
+
+    m_node.consume(cvs, count * CV);
+    m_leaves += count;
+
+    secureZero(cvs, count * CV);
+}
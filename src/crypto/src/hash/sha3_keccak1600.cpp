@@ -1,10 +1,12 @@
 #include <ub/crypto/sha3.hpp>
 
+#include "sha3_common.hpp"
+#include "hash_state.hpp"
+
 #include <cstring>
 
 using namespace ub::crypto;
-
-enum { KECCAK1600_ROUNDS = 24 };
+using namespace ub::crypto::impl;
 
 static const uint8_t keccak1600_rotations[] = {
         1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
@@ -16,19 +18,18 @@ static const uint8_t keccak1600_permutation[] = {
         15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1
 };
 
-// Compressed round constants: 15, 31 and 63 bits are packed into high byte, low byte is applied directly
-static const uint16_t keccak1600_rcon[] = {
-        0x0001, 0x0182, 0x058A, 0x0700, 0x018B, 0x0201, 0x0781, 0x0509, 0x008A, 0x0088, 0x0309, 0x020A,
-        0x038B, 0x048B, 0x0589, 0x0503, 0x0502, 0x0480, 0x010A, 0x060A, 0x0781, 0x0580, 0x0201, 0x0708
+// Round constants for bit-interleaved state: bit 0 is applied to even word, bits 1..6 carry odd word bits 0, 1, 3, 7,
+// 15 and 31 (which correspond to lane bits 1, 3, 7, 15, 31 and 63)
+static const uint8_t keccak1600_rcon[] = {
+        0x01, 0x1A, 0x5E, 0x70, 0x1F, 0x21, 0x79, 0x55, 0x0E, 0x0C, 0x35, 0x26,
+        0x3F, 0x4F, 0x5D, 0x53, 0x52, 0x48, 0x16, 0x66, 0x79, 0x58, 0x21, 0x74
 };
 
-static uint64_t rot64(uint64_t x, uint32_t i) {
-    return (x << i) | (x >> (64 - i));
+static uint32_t rot32(uint32_t x, uint32_t i) {
+    return (x << (i & 31)) | (x >> (-i & 31));
 }
 
 static void keccak1600_theta(uint32_t *st) {
-    static const uint8_t selectors[5] = { 0x82, 0x04, 0x26, 0x48, 0x60 };
-
     uint32_t bc[10];
     for (size_t i = 0; i < 10; i++) {
         uint32_t t = 0;
@@ -40,30 +41,37 @@ static void keccak1600_theta(uint32_t *st) {
         bc[i] = t;
     }
 
-    for (size_t i = 0; i < 10; i++) {
-        uint32_t selector = selectors[i >> 1];
-        uint32_t s_u = (selector >> 4) ^ (i & 1);
-        uint32_t s_v = (selector & 0xF) ^ (i & 1);
+    // D[x] = C[x - 1] ^ rot(C[x + 1], 1), where rotation by 1 swaps even and odd halves
+    for (size_t x = 0, prev = 8, next = 2; x < 10; prev = x, x += 2, next = next == 8 ? 0 : next + 2) {
+        uint32_t d0 = bc[prev] ^ rot32(bc[next + 1], 1);
+        uint32_t d1 = bc[prev + 1] ^ bc[next];
 
-        uint32_t t = bc[s_u] ^ (bc[s_v] << 1) ^ (bc[s_v ^ 1] >> 31);
         for (size_t j = 0; j < 50; j += 10) {
-            st[i + j] ^= t;
+            st[x + j] ^= d0;
+            st[x + j + 1] ^= d1;
         }
     }
 }
 
 static void keccak1600_rho_pi(uint32_t *st) {
-    uint64_t t = st[2] | ((uint64_t) st[3] << 32);
+    uint32_t t0 = st[2], t1 = st[3];
 
     for (size_t i = 0; i < 24; i++) {
         uint32_t j = keccak1600_permutation[i] << 1;
-        uint64_t x = st[j] | ((uint64_t) st[j + 1] << 32);
-        uint64_t y = rot64(t, keccak1600_rotations[i]);
-
-        st[j] = y;
-        st[j + 1] = y >> 32;
+        uint32_t x0 = st[j], x1 = st[j + 1];
+
+        // 64-bit rotation of interleaved lane is a pair of 32-bit rotations, odd amount also swaps the halves
+        uint32_t r = keccak1600_rotations[i];
+        if (r & 1) {
+            st[j] = rot32(t1, (r >> 1) + 1);
+            st[j + 1] = rot32(t0, r >> 1);
+        } else {
+            st[j] = rot32(t0, r >> 1);
+            st[j + 1] = rot32(t1, r >> 1);
+        }
 
-        t = x;
+        t0 = x0;
+        t1 = x1;
     }
 }
 
@@ -87,18 +95,12 @@ static void keccak1600_chi(uint32_t *st) {
 }
 
 void keccak1600_iota(uint32_t *st, uint32_t rc) {
-    uint32_t iota0 = st[0];
-
-    iota0 ^= rc & 0xFF;
-    iota0 ^= (rc & 0x100) << 7;
-    iota0 ^= (rc & 0x200) << 22;
-    st[0] = iota0;
-
-    st[1] ^= (rc & 0x400) << 21;
+    st[0] ^= rc & 1;
+    st[1] ^= ((rc >> 1) & 0x3) | (rc & 0x08) | ((rc & 0x10) << 3) | ((rc & 0x20) << 10) | ((rc & 0x40) << 25);
 }
 
-void keccak1600::apply(state_t &state) {
-    for (size_t i = 0; i < KECCAK1600_ROUNDS; i++) {
+void ub::crypto::impl::keccak1600Permute32(keccak1600::state_t &state, uint32_t rounds) {
+    for (size_t i = keccak1600::ROUNDS - rounds; i < keccak1600::ROUNDS; i++) {
         keccak1600_theta(state.u32);
         keccak1600_rho_pi(state.u32);
         keccak1600_chi(state.u32);
@@ -106,42 +108,184 @@ void keccak1600::apply(state_t &state) {
     }
 }
 
+void keccak1600::apply(state_t &state, uint32_t rounds) {
+#if UB_CRYPTO_KECCAK64
+    keccak1600Permute64(state, rounds);
+#else
+    keccak1600Permute32(state, rounds);
+#endif
+}
+
+// Lanes are stored in native layout for 64-bit permutation and split into even and odd bit halves otherwise
+
+static void keccak1600_xor_lane(keccak1600::state_t &st, size_t lane, uint64_t x) {
+#if UB_CRYPTO_KECCAK64
+    uint64_t y;
+    std::memcpy(&y, st.u8 + (lane << 3), sizeof(y));
+    y ^= x;
+    std::memcpy(st.u8 + (lane << 3), &y, sizeof(y));
+#else
+    uint32_t y[2];
+    keccak1600Interleave(y, x);
+    st.u32[(lane << 1) + 0] ^= y[0];
+    st.u32[(lane << 1) + 1] ^= y[1];
+#endif
+}
+
+static uint64_t keccak1600_lane(const keccak1600::state_t &st, size_t lane) {
+#if UB_CRYPTO_KECCAK64
+    uint64_t x;
+    std::memcpy(&x, st.u8 + (lane << 3), sizeof(x));
+    return x;
+#else
+    return keccak1600Deinterleave(st.u32 + (lane << 1));
+#endif
+}
+
 void keccak1600::consume(const uint8_t *buf, size_t length) {
     while (length != 0) {
+        size_t offset = ptr & 7;
         size_t ll = std::min(length, (size_t) (rate - ptr));
-        exclusiveOr(st.u8 + ptr, buf, ll);
+
+        if (offset == 0 && ll >= 8) {
+            // absorb whole lanes
+            ll &= ~7;
+            for (size_t i = 0; i < ll; i += 8) {
+                uint64_t x;
+                std::memcpy(&x, buf + i, sizeof(x)); // assume little-endian system
+                keccak1600_xor_lane(st, (ptr + i) >> 3, x);
+            }
+        } else {
+            // absorb part of a single lane
+            ll = std::min(ll, 8 - offset);
+
+            uint64_t x = 0;
+            for (size_t i = 0; i < ll; i++) {
+                x |= (uint64_t) buf[i] << ((offset + i) << 3);
+            }
+
+            keccak1600_xor_lane(st, ptr >> 3, x);
+        }
 
         ptr += ll;
         buf += ll;
         length -= ll;
 
         if (ptr == rate) {
-            apply(st);
+            apply(st, rounds != 0 ? rounds : ROUNDS);
             ptr = 0;
         }
     }
 }
 
 void keccak1600::finish(uint8_t trailer) {
-    st.u8[ptr]      ^= trailer;     // function-specific trailer field
-    st.u8[rate - 1] ^= 0x80;        // final '1' padding bit
-    apply(st);
+    keccak1600_xor_lane(st, ptr >> 3, (uint64_t) trailer << ((ptr & 7) << 3));      // function-specific trailer field
+    keccak1600_xor_lane(st, (rate - 1) >> 3, 0x80ULL << (((rate - 1) & 7) << 3));   // final '1' padding bit
+    apply(st, rounds != 0 ? rounds : ROUNDS);
 
     ptr = 0;
 }
 
 void keccak1600::produce(uint8_t *buf, size_t length) {
     while (length != 0) {
-        size_t ll = std::min(length, (size_t) (rate - ptr));
-        std::memcpy(buf, st.u8 + ptr, ll);
+        size_t offset = ptr & 7;
+        size_t ll = std::min(length, std::min((size_t) (rate - ptr), 8 - offset));
+
+        uint64_t x = keccak1600_lane(st, ptr >> 3) >> (offset << 3);
+        if (ll == sizeof(x)) {
+            std::memcpy(buf, &x, sizeof(x)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                buf[i] = (uint8_t) (x >> (i << 3));
+            }
+        }
 
         ptr += ll;
         buf += ll;
         length -= ll;
 
         if (ptr == rate) {
-            apply(st);
+            apply(st, rounds != 0 ? rounds : ROUNDS);
             ptr = 0;
         }
     }
 }
+
+void keccak1600::duplex(uint8_t *dst, const uint8_t *src, size_t length, bool decrypt) {
+    while (length != 0) {
+        size_t offset = ptr & 7;
+        size_t ll = std::min(length, std::min((size_t) (rate - ptr), 8 - offset));
+
+        uint64_t x = 0;
+        if (ll == sizeof(x)) {
+            std::memcpy(&x, src, sizeof(x)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                x |= (uint64_t) src[i] << (i << 3);
+            }
+        }
+
+        uint64_t y = x ^ (keccak1600_lane(st, ptr >> 3) >> (offset << 3));
+        if (ll != sizeof(y)) {
+            y &= (1ULL << (ll << 3)) - 1;
+        }
+
+        keccak1600_xor_lane(st, ptr >> 3, (decrypt ? y : x) << (offset << 3));
+
+        if (ll == sizeof(y)) {
+            std::memcpy(dst, &y, sizeof(y)); // assume little-endian system
+        } else {
+            for (size_t i = 0; i < ll; i++) {
+                dst[i] = (uint8_t) (y >> (i << 3));
+            }
+        }
+
+        ptr += ll;
+        src += ll;
+        dst += ll;
+        length -= ll;
+
+        if (ptr == rate) {
+            apply(st, rounds != 0 ? rounds : ROUNDS);
+            ptr = 0;
+        }
+    }
+}
+
+size_t keccak1600::exportState(uint8_t *buffer) const {
+    size_t p = hashStateBegin(buffer, HASH_STATE_KECCAK1600);
+
+    buffer[p++] = rate;
+    buffer[p++] = rounds;
+    buffer[p++] = ptr;
+
+    for (size_t i = 0; i < LENGTH / sizeof(uint64_t); i++, p += sizeof(uint64_t)) {
+        hashStateStore(buffer + p, keccak1600_lane(st, i), sizeof(uint64_t));
+    }
+
+    return p;
+}
+
+bool keccak1600::importState(const uint8_t *buffer, size_t length) {
+    if (!hashStateCheck(buffer, length, HASH_STATE_KECCAK1600, STATE_LENGTH) || length != STATE_LENGTH) {
+        return false;
+    }
+
+    size_t p = HASH_STATE_HEADER;
+    uint8_t r = buffer[p++], n = buffer[p++], q = buffer[p++];
+
+    if (r == 0 || r >= LENGTH || (r & 7) != 0 || n > ROUNDS || q >= r) {
+        return false;
+    }
+
+    reset();
+    rate = r;
+    rounds = n;
+    ptr = q;
+
+    for (size_t i = 0; i < LENGTH / sizeof(uint64_t); i++, p += sizeof(uint64_t)) {
+        keccak1600_xor_lane(st, i, hashStateLoad(buffer + p, sizeof(uint64_t)));
+    }
+
+    return true;
+}
@@ -0,0 +1,47 @@
+#include "sha3_common.hpp"
+
+#if UB_CRYPTO_KECCAK64
+
+#include "sha3_keccak1600_round.hpp"
+
+#include <cstring>
+
+using namespace ub::crypto;
+
+void ub::crypto::impl::keccak1600Permute64(keccak1600::state_t &state, uint32_t rounds) {
+    uint64_t lanes[25];
+    std::memcpy(lanes, state.u8, sizeof(lanes)); // assume little-endian system
+
+    for (uint8_t i : keccak1600_complemented) {
+        lanes[i] = ~lanes[i];
+    }
+
+    uint64_t KECCAK1600_LANES(A);
+    uint64_t KECCAK1600_LANES(E);
+
+    KECCAK1600_LOAD(A, lanes);
+
+    size_t i = keccak1600::ROUNDS - rounds;
+    if (rounds & 1) {
+        KECCAK1600_ROUND(uint64_t, A, E, keccak1600_rcon64[i]);
+        KECCAK1600_STORE(E, lanes);
+        KECCAK1600_LOAD(A, lanes);
+        i++;
+    }
+
+    for (; i < keccak1600::ROUNDS; i += 2) {
+        KECCAK1600_ROUND(uint64_t, A, E, keccak1600_rcon64[i]);
+        KECCAK1600_ROUND(uint64_t, E, A, keccak1600_rcon64[i + 1]);
+    }
+
+    KECCAK1600_STORE(A, lanes);
+
+    for (uint8_t i : keccak1600_complemented) {
+        lanes[i] = ~lanes[i];
+    }
+
+    std::memcpy(state.u8, lanes, sizeof(lanes));
+    secureZero(lanes, sizeof(lanes));
+}
+
+#endif // UB_CRYPTO_KECCAK64
@@ -0,0 +1,119 @@
+#ifndef UB_SRC_CRYPTO_HASH_SHA3_KECCAK1600_ROUND_H
+#define UB_SRC_CRYPTO_HASH_SHA3_KECCAK1600_ROUND_H
+
+#include <cstdint>
+
+// Lanes are named after their (x, y) coordinates as in the Keccak reference code: first letter (b, g, k, m, s)
+// selects a row y = 0..4, second letter (a, e, i, o, u) selects a column x = 0..4.
+//
+// Lane complementing transform: lanes (1, 0), (2, 0), (3, 1), (2, 2), (2, 3) and (0, 4) are kept inverted during
+// the permutation, which replaces most of NOT operations in chi step with a mix of AND and OR operations.
+
+static constexpr uint64_t keccak1600_rcon64[] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+        0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+        0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static constexpr uint8_t keccak1600_complemented[] = { 1, 2, 8, 12, 17, 20 };
+
+#define ROL64(x, i)                 (((x) << (i)) | ((x) >> (64 - (i))))
+
+// Single Keccak round reading lanes `A..` and writing lanes `E..`, lanes and temporaries have type `T`
+#define KECCAK1600_ROUND(T, A, E, rc)                                                                               \
+    do {                                                                                                            \
+        T Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa;                                                               \
+        T Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se;                                                               \
+        T Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si;                                                               \
+        T Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so;                                                               \
+        T Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su;                                                               \
+                                                                                                                    \
+        T Da = Cu ^ ROL64(Ce, 1);                                                                                   \
+        T De = Ca ^ ROL64(Ci, 1);                                                                                   \
+        T Di = Ce ^ ROL64(Co, 1);                                                                                   \
+        T Do = Ci ^ ROL64(Cu, 1);                                                                                   \
+        T Du = Co ^ ROL64(Ca, 1);                                                                                   \
+                                                                                                                    \
+        T Ba = A##ba ^ Da;                                                                                          \
+        T Be = A##ge ^ De; Be = ROL64(Be, 44);                                                                      \
+        T Bi = A##ki ^ Di; Bi = ROL64(Bi, 43);                                                                      \
+        T Bo = A##mo ^ Do; Bo = ROL64(Bo, 21);                                                                      \
+        T Bu = A##su ^ Du; Bu = ROL64(Bu, 14);                                                                      \
+        E##ba = Ba ^ (Be | Bi) ^ (rc);                                                                              \
+        E##be = Be ^ (~Bi | Bo);                                                                                    \
+        E##bi = Bi ^ (Bo & Bu);                                                                                     \
+        E##bo = Bo ^ (Bu | Ba);                                                                                     \
+        E##bu = Bu ^ (Ba & Be);                                                                                     \
+                                                                                                                    \
+        Ba = A##bo ^ Do; Ba = ROL64(Ba, 28);                                                                        \
+        Be = A##gu ^ Du; Be = ROL64(Be, 20);                                                                        \
+        Bi = A##ka ^ Da; Bi = ROL64(Bi, 3);                                                                         \
+        Bo = A##me ^ De; Bo = ROL64(Bo, 45);                                                                        \
+        Bu = A##si ^ Di; Bu = ROL64(Bu, 61);                                                                        \
+        E##ga = Ba ^ (Be | Bi);                                                                                     \
+        E##ge = Be ^ (Bi & Bo);                                                                                     \
+        E##gi = Bi ^ (Bo | ~Bu);                                                                                    \
+        E##go = Bo ^ (Bu | Ba);                                                                                     \
+        E##gu = Bu ^ (Ba & Be);                                                                                     \
+                                                                                                                    \
+        Ba = A##be ^ De; Ba = ROL64(Ba, 1);                                                                         \
+        Be = A##gi ^ Di; Be = ROL64(Be, 6);                                                                         \
+        Bi = A##ko ^ Do; Bi = ROL64(Bi, 25);                                                                        \
+        Bo = A##mu ^ Du; Bo = ROL64(Bo, 8);                                                                         \
+        Bu = A##sa ^ Da; Bu = ROL64(Bu, 18);                                                                        \
+        E##ka = Ba ^ (Be | Bi);                                                                                     \
+        E##ke = Be ^ (Bi & Bo);                                                                                     \
+        E##ki = Bi ^ (~Bo & Bu);                                                                                    \
+        E##ko = ~Bo ^ (Bu | Ba);                                                                                    \
+        E##ku = Bu ^ (Ba & Be);                                                                                     \
+                                                                                                                    \
+        Ba = A##bu ^ Du; Ba = ROL64(Ba, 27);                                                                        \
+        Be = A##ga ^ Da; Be = ROL64(Be, 36);                                                                        \
+        Bi = A##ke ^ De; Bi = ROL64(Bi, 10);                                                                        \
+        Bo = A##mi ^ Di; Bo = ROL64(Bo, 15);                                                                        \
+        Bu = A##so ^ Do; Bu = ROL64(Bu, 56);                                                                        \
+        E##ma = Ba ^ (Be & Bi);                                                                                     \
+        E##me = Be ^ (Bi | Bo);                                                                                     \
+        E##mi = Bi ^ (~Bo | Bu);                                                                                    \
+        E##mo = ~Bo ^ (Bu & Ba);                                                                                    \
+        E##mu = Bu ^ (Ba | Be);                                                                                     \
+                                                                                                                    \
+        Ba = A##bi ^ Di; Ba = ROL64(Ba, 62);                                                                        \
+        Be = A##go ^ Do; Be = ROL64(Be, 55);                                                                        \
+        Bi = A##ku ^ Du; Bi = ROL64(Bi, 39);                                                                        \
+        Bo = A##ma ^ Da; Bo = ROL64(Bo, 41);                                                                        \
+        Bu = A##se ^ De; Bu = ROL64(Bu, 2);                                                                         \
+        E##sa = Ba ^ (~Be & Bi);                                                                                    \
+        E##se = ~Be ^ (Bi | Bo);                                                                                    \
+        E##si = Bi ^ (Bo & Bu);                                                                                     \
+        E##so = Bo ^ (Bu | Ba);                                                                                     \
+        E##su = Bu ^ (Ba & Be);                                                                                     \
+    } while (0)
+
+#define KECCAK1600_LANES(X)                                                                                         \
+    X##ba, X##be, X##bi, X##bo, X##bu,                                                                              \
+    X##ga, X##ge, X##gi, X##go, X##gu,                                                                              \
+    X##ka, X##ke, X##ki, X##ko, X##ku,                                                                              \
+    X##ma, X##me, X##mi, X##mo, X##mu,                                                                              \
+    X##sa, X##se, X##si, X##so, X##su
+
+// Load lanes `A..` from array `src` of 25 lanes
+#define KECCAK1600_LOAD(A, src)                                                                                     \
+    A##ba = (src)[ 0]; A##be = (src)[ 1]; A##bi = (src)[ 2]; A##bo = (src)[ 3]; A##bu = (src)[ 4];                  \
+    A##ga = (src)[ 5]; A##ge = (src)[ 6]; A##gi = (src)[ 7]; A##go = (src)[ 8]; A##gu = (src)[ 9];                  \
+    A##ka = (src)[10]; A##ke = (src)[11]; A##ki = (src)[12]; A##ko = (src)[13]; A##ku = (src)[14];                  \
+    A##ma = (src)[15]; A##me = (src)[16]; A##mi = (src)[17]; A##mo = (src)[18]; A##mu = (src)[19];                  \
+    A##sa = (src)[20]; A##se = (src)[21]; A##si = (src)[22]; A##so = (src)[23]; A##su = (src)[24];
+
+// Store lanes `A..` into array `dst` of 25 lanes
+#define KECCAK1600_STORE(A, dst)                                                                                    \
+    (dst)[ 0] = A##ba; (dst)[ 1] = A##be; (dst)[ 2] = A##bi; (dst)[ 3] = A##bo; (dst)[ 4] = A##bu;                  \
+    (dst)[ 5] = A##ga; (dst)[ 6] = A##ge; (dst)[ 7] = A##gi; (dst)[ 8] = A##go; (dst)[ 9] = A##gu;                  \
+    (dst)[10] = A##ka; (dst)[11] = A##ke; (dst)[12] = A##ki; (dst)[13] = A##ko; (dst)[14] = A##ku;                  \
+    (dst)[15] = A##ma; (dst)[16] = A##me; (dst)[17] = A##mi; (dst)[18] = A##mo; (dst)[19] = A##mu;                  \
+    (dst)[20] = A##sa; (dst)[21] = A##se; (dst)[22] = A##si; (dst)[23] = A##so; (dst)[24] = A##su;
+
+#endif // UB_SRC_CRYPTO_HASH_SHA3_KECCAK1600_ROUND_H
@@ -0,0 +1,210 @@
+#include <ub/crypto/sha3.hpp>
+
+#include "sha3_common.hpp"
+#include "sha3_keccak1600_round.hpp"
+#include "../cpu.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+// Vector type is lowered by compiler to AVX2 registers, pairs of SSE2/NEON registers or scalar code
+typedef uint64_t keccak1600x4_v __attribute__((vector_size(32)));
+
+static constexpr size_t KECCAK1600X4_LANES     = keccak1600x4::LANES;
+static constexpr size_t KECCAK1600X4_IDLE      = SIZE_MAX;
+static constexpr size_t KECCAK1600X4_SQUEEZING = KECCAK1600_JOB_SEGMENTS + 1;
+
+template <typename V>
+[[gnu::always_inline]] static inline void keccak1600x4_permute(keccak1600x4::state_t &state, uint32_t rounds) {
+    V lanes[25];
+    std::memcpy(lanes, state.u64, sizeof(lanes));
+
+    for (uint8_t i : keccak1600_complemented) {
+        lanes[i] = ~lanes[i];
+    }
+
+    V KECCAK1600_LANES(A);
+    V KECCAK1600_LANES(E);
+
+    KECCAK1600_LOAD(A, lanes);
+
+    size_t i = keccak1600::ROUNDS - rounds;
+    if (rounds & 1) {
+        KECCAK1600_ROUND(V, A, E, keccak1600_rcon64[i]);
+        KECCAK1600_STORE(E, lanes);
+        KECCAK1600_LOAD(A, lanes);
+        i++;
+    }
+
+    for (; i < keccak1600::ROUNDS; i += 2) {
+        KECCAK1600_ROUND(V, A, E, keccak1600_rcon64[i]);
+        KECCAK1600_ROUND(V, E, A, keccak1600_rcon64[i + 1]);
+    }
+
+    KECCAK1600_STORE(A, lanes);
+
+    for (uint8_t i : keccak1600_complemented) {
+        lanes[i] = ~lanes[i];
+    }
+
+    std::memcpy(state.u64, lanes, sizeof(lanes));
+}
+
+#if UB_CRYPTO_X86
+[[gnu::target("avx2")]]
+static void keccak1600x4_permute_avx2(keccak1600x4::state_t &state, uint32_t rounds) {
+    keccak1600x4_permute<keccak1600x4_v>(state, rounds);
+}
+#endif
+
+static void keccak1600x4_permute_generic(keccak1600x4::state_t &state, uint32_t rounds) {
+    keccak1600x4_permute<keccak1600x4_v>(state, rounds);
+}
+
+void keccak1600x4::apply(state_t &state, uint32_t rounds) {
+#if UB_CRYPTO_X86
+    if (cpuFeatures() & CPU_X86_AVX2) {
+        keccak1600x4_permute_avx2(state, rounds);
+        return;
+    }
+#endif
+
+    keccak1600x4_permute_generic(state, rounds);
+}
+
+/** State of a single lane of the sponge engine */
+struct keccak1600x4_lane {
+    size_t          index;      //! Index of message being processed, or KECCAK1600X4_IDLE
+    size_t          segment;    //! Index of segment being absorbed, or KECCAK1600X4_SQUEEZING
+    size_t          offset;     //! Offset in the current segment
+    keccak1600_job  job;
+};
+
+static void keccak1600x4_load(keccak1600x4_lane &lane, size_t index, keccak1600_job_fn fn, const void *ctx) {
+    lane.job = {};
+    fn(ctx, index, lane.job);
+
+    lane.index = index;
+    lane.segment = 0;
+    lane.offset = 0;
+}
+
+/** Fill next input block of the lane, returns true if the block was padded and the lane switches to squeezing */
+static bool keccak1600x4_fill(keccak1600x4_lane &lane, uint8_t *block, uint8_t rate, uint8_t trailer) {
+    keccak1600_job &job = lane.job;
+    size_t used = 0;
+
+    std::memset(block, 0, keccak1600::LENGTH);
+
+    while (used < rate && lane.segment < KECCAK1600_JOB_SEGMENTS) {
+        size_t s = lane.segment;
+
+        if (lane.offset == job.length[s]) {
+            // zero padding is already in place, just close the block
+            if ((job.padded & (1 << s)) && used != 0) {
+                used = rate;
+            }
+
+            lane.segment++;
+            lane.offset = 0;
+            continue;
+        }
+
+        size_t ll = std::min(job.length[s] - lane.offset, (size_t) (rate - used));
+        std::memcpy(block + used, job.data[s] + lane.offset, ll);
+
+        used += ll;
+        lane.offset += ll;
+    }
+
+    if (used == rate) {
+        return false;
+    }
+
+    block[used] ^= trailer;             // function-specific trailer field
+    block[rate - 1] ^= 0x80;            // final '1' padding bit
+    return true;
+}
+
+void ub::crypto::impl::keccak1600x4Sponge(uint8_t rate, uint8_t trailer, uint32_t rounds, size_t count,
+                                          keccak1600_job_fn fn, const void *ctx)
+{
+    keccak1600x4::state_t state {};
+    keccak1600x4_lane lanes[KECCAK1600X4_LANES];
+    uint8_t block[keccak1600::LENGTH];
+
+    size_t nextMessage = 0;
+    size_t active = 0;
+
+    for (keccak1600x4_lane &lane : lanes) {
+        lane.index = KECCAK1600X4_IDLE;
+
+        if (nextMessage < count) {
+            keccak1600x4_load(lane, nextMessage++, fn, ctx);
+            active++;
+        }
+    }
+
+    while (active != 0) {
+        // absorb next block into every absorbing lane
+        for (size_t l = 0; l < KECCAK1600X4_LANES; l++) {
+            keccak1600x4_lane &lane = lanes[l];
+            if (lane.index == KECCAK1600X4_IDLE || lane.segment == KECCAK1600X4_SQUEEZING) {
+                continue;
+            }
+
+            if (keccak1600x4_fill(lane, block, rate, trailer)) {
+                lane.segment = KECCAK1600X4_SQUEEZING;
+            }
+
+            for (size_t i = 0; i < (rate + 7u) / 8; i++) {
+                uint64_t x;
+                std::memcpy(&x, block + 8 * i, sizeof(x)); // assume little-endian system
+                state.u64[i * KECCAK1600X4_LANES + l] ^= x;
+            }
+        }
+
+        keccak1600x4::apply(state, rounds);
+
+        // squeeze output from lanes which have absorbed the final block
+        for (size_t l = 0; l < KECCAK1600X4_LANES; l++) {
+            keccak1600x4_lane &lane = lanes[l];
+            if (lane.index == KECCAK1600X4_IDLE || lane.segment != KECCAK1600X4_SQUEEZING) {
+                continue;
+            }
+
+            for (size_t i = 0; i < (rate + 7u) / 8; i++) {
+                std::memcpy(block + 8 * i, &state.u64[i * KECCAK1600X4_LANES + l], sizeof(uint64_t));
+            }
+
+            keccak1600_job &job = lane.job;
+            size_t ll = std::min(job.outputLength, (size_t) rate);
+            std::memcpy(job.output, block, ll);
+
+            job.output += ll;
+            job.outputLength -= ll;
+
+            if (job.outputLength != 0) {
+                continue;
+            }
+
+            for (size_t i = 0; i < 25; i++) {
+                state.u64[i * KECCAK1600X4_LANES + l] = 0;
+            }
+
+            if (nextMessage < count) {
+                keccak1600x4_load(lane, nextMessage++, fn, ctx);
+            } else {
+                lane.index = KECCAK1600X4_IDLE;
+                active--;
+            }
+        }
+    }
+
+    secureZero(&state, sizeof(state));
+    secureZero(lanes, sizeof(lanes));
+    secureZero(block, sizeof(block));
+}
@@ -1,6 +1,11 @@
 #include <ub/crypto/kmac.hpp>
 
+#include "sha3_common.hpp"
+
+#include <cstring>
+
 using namespace ub::crypto;
+using namespace ub::crypto::impl;
 
 // bytepad(encode_string(N) || encode_string(S), rate) with rate left as zero byte, N='KMAC', S=''
 static const uint8_t KMAC_PREFIX[] = {
@@ -16,88 +21,93 @@ kmac::kmac(): k {} {
     m_macLength = 0;
 }
 
-static void kmac_push_rate(keccak1600 &k) {
-    uint8_t buf[2] {
-        0x01,
-        k.rate
-    };
-
-    k.consume(buf, sizeof(buf));
-}
-
-static uint8_t kmac_encoded_length(size_t x) {
-    x = x | 1;   // at least one byte must be serialized
+static void kmac_absorb_key(keccak1600 &k, uint32_t variant, const uint8_t *key, size_t keyLength) {
+    k.rate = kmac_rate(variant);
+    k.reset();
 
-    uint8_t r = 0;
-    while (x != 0) {
-        r++;
-        x >>= 8;
-    }
+    // cSHAKE step: add bytepad(encode_string(N) || encode_string(S), rate) prefix
+    cshakeBytepadBegin(k);
+    k.consume(KMAC_PREFIX, sizeof(KMAC_PREFIX));
+    cshakeBytepadEnd(k);
 
-    return r;
+    // KMAC step: add bytepad(encode_string(K), rate)
+    cshakeBytepadBegin(k);
+    cshakeEncodeString(k, key, keyLength);
+    cshakeBytepadEnd(k);
 }
 
-static void kmac_left_encode(keccak1600 &k, size_t x) {
-    uint8_t buf[sizeof(size_t) + 1];
+void kmac_key::init(uint32_t variant, const uint8_t *key, size_t keyLength) {
+    kmac_absorb_key(k, variant, key, keyLength);
+}
 
-    size_t l = kmac_encoded_length(x);
-    buf[0] = l;
+void kmac::init(uint32_t variant, const uint8_t *key, size_t keyLength, size_t macLength) {
+    kmac_absorb_key(k, variant, key, keyLength);
+    m_macLength = macLength;
+}
 
-    size_t i = l;
-    while (i != 0) {
-        buf[i] = (uint8_t) x;
-        i--;
-        x >>= 8;
-    }
+void kmac::finish(uint8_t *mac) {
+    // KMAC step: add right_encode(L)
+    uint8_t buf[CSHAKE_ENCODE_MAX];
+    k.consume(buf, cshakeRightEncode(buf, (uint64_t) m_macLength << 3));
 
-    k.consume(buf, l + 1);
+    k.finish(CSHAKE_TRAILER);
+    k.produce(mac, m_macLength);
 }
 
-static void kmac_right_encode(keccak1600 &k, size_t x) {
-    uint8_t buf[sizeof(size_t) + 1];
-
-    size_t l = kmac_encoded_length(x);
-    buf[l] = l;
+/** Arguments of a batch KMAC call, shared by all jobs */
+struct kmac_batch {
+    uint8_t         rate;
+    uint8_t * const *macs;
+    size_t          macLength;
+    const uint8_t * const *keys;
+    const size_t    *keyLengths;
+    const uint8_t * const *messages;
+    const size_t    *lengths;
+};
 
-    size_t i = l;
-    while (i != 0) {
-        i--;
-        buf[i] = (uint8_t) x;
-        x >>= 8;
-    }
+static void kmac_job(const void *ctx, size_t index, keccak1600_job &job) {
+    auto batch = (const kmac_batch *) ctx;
+    uint8_t *p = job.scratch;
 
-    k.consume(buf, l + 1);
-}
+    // bytepad(encode_string(N) || encode_string(S), rate)
+    p[0] = 0x01;
+    p[1] = batch->rate;
+    std::memcpy(p + 2, KMAC_PREFIX, sizeof(KMAC_PREFIX));
 
-void kmac::init(uint32_t variant, const uint8_t *key, size_t keyLength, size_t macLength) {
-    k.rate = kmac_rate(variant);
-    k.reset();
+    job.data[0] = p;
+    job.length[0] = 2 + sizeof(KMAC_PREFIX);
+    p += job.length[0];
 
-    // cSHAKE step: add bytepad(encode_string(N) || encode_string(S), rate) prefix
-    kmac_push_rate(k);
-    k.consume(KMAC_PREFIX, sizeof(KMAC_PREFIX));
+    // bytepad(encode_string(K), rate)
+    p[0] = 0x01;
+    p[1] = batch->rate;
 
-    keccak1600::apply(k.st);
-    k.ptr = 0;
+    job.data[1] = p;
+    job.length[1] = 2 + cshakeLeftEncode(p + 2, (uint64_t) batch->keyLengths[index] << 3);
+    p += job.length[1];
 
-    // KMAC step: add bytepad(encode_string(K), rate)
+    job.data[2] = batch->keys[index];
+    job.length[2] = batch->keyLengths[index];
+    job.padded = (1 << 0) | (1 << 2);
 
-    kmac_push_rate(k);
-    kmac_left_encode(k, keyLength << 3);
-    k.consume(key, keyLength);
+    // message || right_encode(L)
+    job.data[3] = batch->messages[index];
+    job.length[3] = batch->lengths[index];
 
-    if (k.ptr != 0) {
-        keccak1600::apply(k.st);
-        k.ptr = 0;
-    }
+    job.data[4] = p;
+    job.length[4] = cshakeRightEncode(p, (uint64_t) batch->macLength << 3);
 
-    m_macLength = macLength;
+    job.output = batch->macs[index];
+    job.outputLength = batch->macLength;
 }
 
-void kmac::finish(uint8_t *mac) {
-    // KMAC step: add right_encode(L)
-    kmac_right_encode(k, m_macLength << 3);
+void kmac_multi::compute(uint32_t variant, uint8_t * const *macs, size_t macLength, const uint8_t * const *keys,
+                         const size_t *keyLengths, const uint8_t * const *messages, const size_t *lengths,
+                         size_t count)
+{
+    const kmac_batch batch {
+        (uint8_t) kmac_rate(variant), macs, macLength, keys, keyLengths, messages, lengths
+    };
 
-    k.finish(0x04); // cSHAKE suffix '00' followed by '1' padding bit
-    k.produce(mac, m_macLength);
+    keccak1600x4Sponge(batch.rate, CSHAKE_TRAILER, keccak1600::ROUNDS, count, kmac_job, &batch);
 }
@@ -0,0 +1,69 @@
+#include "sha3_common.hpp"
+#include "../parallel.hpp"
+
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static constexpr size_t KECCAK1600_LEAVES_GRAIN = 16384;
+
+/** Arguments of a `keccak1600HashLeaves()` call, shared by all worker threads */
+struct keccak1600_leaves {
+    uint8_t         rate;
+    uint8_t         trailer;
+    uint32_t        rounds;
+    const uint8_t   *data;
+    size_t          leafLength;
+    uint8_t         *outputs;
+    size_t          outputLength;
+};
+
+#if UB_CRYPTO_KECCAK64
+static void keccak1600_leaf_job(const void *ctx, size_t index, keccak1600_job &job) {
+    auto leaves = (const keccak1600_leaves *) ctx;
+
+    job.data[0] = leaves->data + index * leaves->leafLength;
+    job.length[0] = leaves->leafLength;
+    job.output = leaves->outputs + index * leaves->outputLength;
+    job.outputLength = leaves->outputLength;
+}
+#endif
+
+static void keccak1600_leaf_range(void *ctx, size_t begin, size_t end) {
+    auto leaves = (const keccak1600_leaves *) ctx;
+
+    keccak1600_leaves range = *leaves;
+    range.data += begin * range.leafLength;
+    range.outputs += begin * range.outputLength;
+
+#if UB_CRYPTO_KECCAK64
+    keccak1600x4Sponge(range.rate, range.trailer, range.rounds, end - begin, keccak1600_leaf_job, &range);
+#else
+    // multi-state permutation is not worth it without native 64-bit lanes
+    keccak1600 k {};
+    k.rate = range.rate;
+    k.rounds = range.rounds;
+
+    for (size_t i = 0; i < end - begin; i++) {
+        k.consume(range.data + i * range.leafLength, range.leafLength);
+        k.finish(range.trailer);
+        k.produce(range.outputs + i * range.outputLength, range.outputLength);
+        k.reset();
+    }
+#endif
+}
+
+void ub::crypto::impl::keccak1600HashLeaves(uint8_t rate, uint8_t trailer, uint32_t rounds, const uint8_t *data,
+                                            size_t leafLength, size_t count, uint8_t *outputs, size_t outputLength)
+{
+    keccak1600_leaves leaves { rate, trailer, rounds, data, leafLength, outputs, outputLength };
+
+    // short leaves are grouped, so each range handed to a worker thread is worth at least a few kilobytes of input,
+    // unless there would be fewer ranges than threads
+    size_t threads = parallelThreads();
+    size_t share = ((count + threads - 1) / threads + keccak1600x4::LANES - 1) & -keccak1600x4::LANES;
+    size_t grain = (KECCAK1600_LEAVES_GRAIN / leafLength) & -keccak1600x4::LANES;
+    grain = std::max(keccak1600x4::LANES, std::min(grain, share));
+    parallelFor(count, grain, keccak1600_leaf_range, &leaves);
+}
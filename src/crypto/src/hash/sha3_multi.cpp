@@ -0,0 +1,41 @@
+#include <ub/crypto/sha3.hpp>
+
+#include "sha3_common.hpp"
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+/** Arguments of a batch hashing call, shared by all jobs */
+struct sha3m_batch {
+    uint8_t * const *outputs;
+    size_t          outputLength;
+    const uint8_t * const *messages;
+    const size_t    *lengths;
+};
+
+static void sha3m_job(const void *ctx, size_t index, keccak1600_job &job) {
+    auto batch = (const sha3m_batch *) ctx;
+
+    job.data[0] = batch->messages[index];
+    job.length[0] = batch->lengths[index];
+    job.output = batch->outputs[index];
+    job.outputLength = batch->outputLength;
+}
+
+void sha3_multi::hash(uint32_t digestLength, uint8_t * const *digests, const uint8_t * const *messages,
+                      const size_t *lengths, size_t count)
+{
+    const sha3m_batch batch { digests, digestLength, messages, lengths };
+    uint8_t rate = keccak1600::LENGTH - (digestLength << 1);
+
+    keccak1600x4Sponge(rate, 0x06, keccak1600::ROUNDS, count, sha3m_job, &batch); // SHA-3 suffix '01' followed by '1' padding bit
+}
+
+void shake_multi::generate(uint32_t variant, uint8_t * const *outputs, size_t outputLength,
+                           const uint8_t * const *messages, const size_t *lengths, size_t count)
+{
+    const sha3m_batch batch { outputs, outputLength, messages, lengths };
+    uint8_t rate = keccak1600::LENGTH - (16 << variant);
+
+    keccak1600x4Sponge(rate, 0x1F, keccak1600::ROUNDS, count, sha3m_job, &batch); // SHAKE suffix '1111' followed by '1' padding bit
+}
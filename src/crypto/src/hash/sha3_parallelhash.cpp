@@ -0,0 +1,143 @@
+#include <ub/crypto/cshake.hpp>
+
+#include "sha3_common.hpp"
+#include "../parallel.hpp"
+
+#include <algorithm>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static const uint8_t PARALLELHASH_NAME[] = { 'P', 'a', 'r', 'a', 'l', 'l', 'e', 'l', 'H', 'a', 's', 'h' };
+
+// Chaining values of whole blocks handed to worker threads at once are buffered on stack. A batch covers at least
+// PARALLELHASH_BATCH_INPUT bytes and four blocks per thread, as long as chaining values fit the buffer.
+#if UB_CRYPTO_THREADS
+static constexpr size_t PARALLELHASH_BATCH_OUTPUT = 16384;
+static constexpr size_t PARALLELHASH_BATCH_INPUT = 1 << 20;
+#else
+static constexpr size_t PARALLELHASH_BATCH_OUTPUT = 4 * 64;
+static constexpr size_t PARALLELHASH_BATCH_INPUT = 0;
+#endif
+
+/** Length of a chaining value of a single block: twice the security level */
+static size_t parallelhash_cv_length(const keccak1600 &k) {
+    return keccak1600::LENGTH - k.rate;
+}
+
+parallelhash::parallelhash(): m_node {}, m_leaf {} {
+    m_blockSize = 0;
+    m_used = 0;
+    m_blocks = 0;
+    m_outputLength = 0;
+    m_generating = false;
+}
+
+void parallelhash::reset() {
+    m_node.reset();
+    m_leaf.reset();
+
+    m_blockSize = 0;
+    m_used = 0;
+    m_blocks = 0;
+    m_outputLength = 0;
+    m_generating = false;
+}
+
+void parallelhash::init(uint32_t variant, size_t blockSize, const uint8_t *custom, size_t customLength,
+                        size_t outputLength)
+{
+    m_node.rate = keccak1600::LENGTH - (32 << variant);
+    cshakeInit(m_node, PARALLELHASH_NAME, sizeof(PARALLELHASH_NAME), custom, customLength);
+
+    // left_encode(B)
+    uint8_t buf[CSHAKE_ENCODE_MAX];
+    m_node.consume(buf, cshakeLeftEncode(buf, blockSize));
+
+    m_leaf.rate = m_node.rate;
+    m_leaf.reset();
+
+    m_blockSize = blockSize;
+    m_used = 0;
+    m_blocks = 0;
+    m_outputLength = outputLength;
+    m_generating = false;
+}
+
+void parallelhash::update(const uint8_t *data, size_t length) {
+    if (m_blockSize == 0) {
+        // not initialized
+        return;
+    }
+
+    size_t cvLength = parallelhash_cv_length(m_node);
+
+    while (length != 0) {
+        if (m_used == 0 && length >= m_blockSize) {
+            uint8_t cvs[PARALLELHASH_BATCH_OUTPUT];
+
+            size_t count = std::max(PARALLELHASH_BATCH_INPUT / m_blockSize, parallelThreads() * keccak1600x4::LANES);
+            count = std::min(std::min(count, length / m_blockSize), sizeof(cvs) / cvLength);
+
+            // each block is hashed with cSHAKE(X, L, "", ""), which is SHAKE with the same capacity
+            keccak1600HashLeaves(m_leaf.rate, SHAKE_TRAILER, keccak1600::ROUNDS, data, m_blockSize, count, cvs,
+                                 cvLength);
+
+            m_node.consume(cvs, count * cvLength);
+            secureZero(cvs, count * cvLength);
+
+            data += count * m_blockSize;
+            length -= count * m_blockSize;
+            m_blocks += count;
+            continue;
+        }
+
+        size_t ll = std::min(length, m_blockSize - m_used);
+        m_leaf.consume(data, ll);
+
+        data += ll;
+        length -= ll;
+        m_used += ll;
+
+        if (m_used == m_blockSize) {
+            finishLeaf();
+        }
+    }
+}
+
+void parallelhash::finish(uint8_t *output) {
+    generate(output, m_outputLength);
+}
+
+void parallelhash::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        if (m_used != 0) {
+            finishLeaf();
+        }
+
+        // right_encode(n) || right_encode(L), XOF variant encodes zero output length
+        uint8_t buf[CSHAKE_ENCODE_MAX];
+        m_node.consume(buf, cshakeRightEncode(buf, m_blocks));
+        m_node.consume(buf, cshakeRightEncode(buf, (uint64_t) m_outputLength << 3));
+
+        m_node.finish(CSHAKE_TRAILER);
+        m_generating = true;
+    }
+
+    m_node.produce(output, length);
+}
+
+void parallelhash::finishLeaf() {
+    uint8_t cv[keccak1600::LENGTH / 2];
+    size_t cvLength = parallelhash_cv_length(m_node);
+
+    m_leaf.finish(SHAKE_TRAILER);
+    m_leaf.produce(cv, cvLength);
+    m_leaf.reset();
+
+    m_node.consume(cv, cvLength);
+    secureZero(cv, cvLength);
+
+    m_used = 0;
+    m_blocks++;
+}
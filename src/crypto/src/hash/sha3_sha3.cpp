@@ -1,7 +1,5 @@
 #include <ub/crypto/sha3.hpp>
 
-#include <cstring>
-
 using namespace ub::crypto;
 
 static uint8_t sha3_rate(uint32_t digestLength) {
@@ -32,7 +30,18 @@ void sha3::finish(uint8_t *digest) {
     k.finish(0x06); // SHA-3 suffix '01' followed by '1' padding bit
 
     uint32_t digestLen = (keccak1600::LENGTH - k.rate) >> 1;
-    memcpy(digest, k.st.u8, digestLen);
+    k.produce(digest, digestLen);
 
     reset();
 }
+
+bool sha3::importState(const uint8_t *buffer, size_t length) {
+    keccak1600 t {};
+    if (!t.importState(buffer, length) || t.rounds != 0 || ((keccak1600::LENGTH - t.rate) & 1) != 0) {
+        return false;
+    }
+
+    k = t;
+    t.reset();
+    return true;
+}
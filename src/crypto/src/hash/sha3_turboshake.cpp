@@ -0,0 +1,48 @@
+#include <ub/crypto/sha3.hpp>
+
+using namespace ub::crypto;
+
+static uint32_t turboshake_rate(uint32_t variant) {
+    if (variant == 0) {
+        return 0;
+    }
+
+    return keccak1600::LENGTH - (16 << variant);
+}
+
+turboshake::turboshake(uint32_t variant, uint8_t domain): k {} {
+    k.rate = turboshake_rate(variant);
+    k.rounds = ROUNDS;
+    m_domain = domain;
+    m_generating = false;
+}
+
+void turboshake::reset(uint32_t variant, uint8_t domain) {
+    if (variant != 0) {
+        k.rate = turboshake_rate(variant);
+    }
+
+    if (domain != 0) {
+        m_domain = domain;
+    }
+
+    k.reset();
+    m_generating = false;
+}
+
+void turboshake::update(const uint8_t *data, size_t length) {
+    if (m_generating) {
+        reset();
+    }
+
+    k.consume(data, length);
+}
+
+void turboshake::generate(uint8_t *output, size_t length) {
+    if (!m_generating) {
+        k.finish(m_domain); // domain separation byte already includes the first padding bit
+        m_generating = true;
+    }
+
+    k.produce(output, length);
+}
@@ -0,0 +1,168 @@
+#include <ub/crypto/utility.hpp>
+
+#include "parallel.hpp"
+
+#if UB_CRYPTO_THREADS
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+#if UB_CRYPTO_THREADS
+
+static std::atomic<size_t> parallel_max_threads { 0 };
+static thread_local bool parallel_nested = false;
+
+/** Lazily started pool of worker threads, executing a single `parallelFor()` call at a time */
+class parallel_pool {
+public:
+    ~parallel_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+        for (std::thread &t : m_workers) {
+            t.join();
+        }
+    }
+
+    void run(size_t threads, size_t count, size_t grain, parallel_fn fn, void *ctx) {
+        std::lock_guard<std::mutex> call(m_call);
+
+        // workers are started with generation of the previous call, so they are guaranteed to pick up this one
+        while (m_workers.size() < threads - 1) {
+            m_workers.emplace_back(&parallel_pool::loop, this, m_workers.size(), m_generation);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fn = fn;
+            m_ctx = ctx;
+            m_count = count;
+            m_grain = grain;
+            m_next = 0;
+            m_participants = threads - 1;
+            m_busy = threads - 1;
+            m_generation++;
+        }
+
+        m_wake.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+    }
+
+private:
+    std::mutex                  m_call;             //! Serializes concurrent `parallelFor()` calls
+    std::mutex                  m_mutex;            //! Protects job description and worker state
+    std::condition_variable     m_wake;             //! Signals new job or shutdown to workers
+    std::condition_variable     m_done;             //! Signals completion of the last busy worker
+    std::vector<std::thread>    m_workers;
+
+    parallel_fn                 m_fn = nullptr;
+    void                        *m_ctx = nullptr;
+    size_t                      m_count = 0;
+    size_t                      m_grain = 0;
+    std::atomic<size_t>         m_next { 0 };       //! First item of the next unclaimed range
+    size_t                      m_participants = 0; //! Number of workers taking part in the current job
+    size_t                      m_busy = 0;         //! Number of workers still processing the current job
+    uint64_t                    m_generation = 0;   //! Incremented for every job
+    bool                        m_stop = false;
+
+    void work() {
+        parallel_nested = true;
+
+        for (;;) {
+            size_t begin = m_next.fetch_add(m_grain);
+            if (begin >= m_count) {
+                break;
+            }
+
+            m_fn(m_ctx, begin, std::min(begin + m_grain, m_count));
+        }
+
+        parallel_nested = false;
+    }
+
+    void loop(size_t index, uint64_t generation) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+
+                if (m_stop) {
+                    return;
+                }
+
+                generation = m_generation;
+                if (index >= m_participants) {
+                    continue;
+                }
+            }
+
+            work();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+};
+
+void ub::crypto::setMaxThreads(size_t threads) {
+    parallel_max_threads = threads;
+}
+
+size_t ub::crypto::impl::parallelThreads() {
+    size_t threads = parallel_max_threads;
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    return threads != 0 ? threads : 1;
+}
+
+void ub::crypto::impl::parallelFor(size_t count, size_t grain, parallel_fn fn, void *ctx) {
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    size_t threads = std::min(parallelThreads(), (count + grain - 1) / grain);
+    if (threads <= 1 || parallel_nested) {
+        if (count != 0) {
+            fn(ctx, 0, count);
+        }
+
+        return;
+    }
+
+    static parallel_pool pool;
+    pool.run(threads, count, grain, fn, ctx);
+}
+
+#else
+
+void ub::crypto::setMaxThreads(size_t) {
+}
+
+size_t ub::crypto::impl::parallelThreads() {
+    return 1;
+}
+
+void ub::crypto::impl::parallelFor(size_t count, size_t, parallel_fn fn, void *ctx) {
+    if (count != 0) {
+        fn(ctx, 0, count);
+    }
+}
+
+#endif // UB_CRYPTO_THREADS
@@ -0,0 +1,31 @@
+#ifndef UB_SRC_CRYPTO_PARALLEL_H
+#define UB_SRC_CRYPTO_PARALLEL_H
+
+#include <cstddef>
+
+// Worker threads are available only on hosted targets, microcontroller builds process everything on caller's thread.
+// Can be overridden by defining UB_CRYPTO_THREADS to 0 or 1.
+#if !defined(UB_CRYPTO_THREADS)
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+#define UB_CRYPTO_THREADS           1
+#else
+#define UB_CRYPTO_THREADS           0
+#endif
+#endif
+
+namespace ub::crypto::impl {
+    /** Work function processing items in range [begin, end) */
+    typedef void (*parallel_fn)(void *ctx, size_t begin, size_t end);
+
+    /**
+     * Process `count` items with `fn`, splitting them into ranges of `grain` items which are distributed between
+     * caller's thread and a lazily started pool of worker threads. Returns after all items are processed. Nested
+     * calls from within a work function, as well as builds without threads, process all items on the calling thread.
+     */
+    void parallelFor(size_t count, size_t grain, parallel_fn fn, void *ctx);
+
+    /** Number of threads (including the caller's one) `parallelFor()` will use */
+    size_t parallelThreads();
+}
+
+#endif // UB_SRC_CRYPTO_PARALLEL_H
@@ -0,0 +1,23 @@
+#ifndef UB_TEST_CRYPTO_CIPHER_AEAD_TEST_DATA_H
+#define UB_TEST_CRYPTO_CIPHER_AEAD_TEST_DATA_H
+
+#include <cstdint>
+#include <cstddef>
+
+/** AEAD test: message is `i % 251` byte pattern, associated data is `(i * 7 + 1) % 256` byte pattern */
+struct cipher_aead_test {
+    uint8_t k[32];      //! Key data, only the first `kl` bytes are used
+    size_t  kl;         //! Key length in bytes
+    uint8_t n[16];      //! Nonce data
+    size_t  al;         //! Associated data length in bytes
+    size_t  ml;         //! Message length in bytes
+    uint8_t c[1024];    //! Expected ciphertext
+    uint8_t t[16];      //! Expected authentication tag
+};
+
+extern const cipher_aead_test * const keccak_aead_tests[];
+extern const cipher_aead_test * const ascon_aead_tests[];
+extern const cipher_aead_test * const aes_gcm_aead_tests[];
+extern const cipher_aead_test * const chacha20_poly1305_aead_tests[];
+
+#endif // UB_TEST_CRYPTO_CIPHER_AEAD_TEST_DATA_H
@@ -0,0 +1,242 @@
+import sys
+from typing import NamedTuple, List, Tuple
+
+from testgen.utils import random_bytes, print_buffer
+from testgen import ascon_ref
+
+
+class AEADTest(NamedTuple):
+    key: bytes
+    nonce: bytes
+    ad_len: int
+    ciphertext: bytes
+    tag: bytes
+
+
+AD_LENGTHS = [0, 1, 166, 167, 168, 400]
+MESSAGE_LENGTHS = [0, 1, 7, 8, 9, 166, 167, 168, 334, 335, 500, 1024]
+
+
+def pattern(length: int) -> bytes:
+    return bytes(i % 251 for i in range(length))
+
+
+def ad_pattern(length: int) -> bytes:
+    return bytes((i * 7 + 1) % 256 for i in range(length))
+
+
+# Keccak-p[1600, n] reference permutation, state is a list of 25 lanes
+KECCAK_RC = [
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808A, 0x8000000080008000, 0x000000000000808B,
+    0x0000000080000001, 0x8000000080008081, 0x8000000000008009, 0x000000000000008A, 0x0000000000000088,
+    0x0000000080008009, 0x000000008000000A, 0x000000008000808B, 0x800000000000008B, 0x8000000000008089,
+    0x8000000000008003, 0x8000000000008002, 0x8000000000000080, 0x000000000000800A, 0x800000008000000A,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008
+]
+KECCAK_ROT = [
+    [0, 36, 3, 41, 18], [1, 44, 10, 45, 2], [62, 6, 43, 15, 61], [28, 55, 25, 21, 56], [27, 20, 39, 8, 14]
+]
+MASK64 = (1 << 64) - 1
+
+
+def rol64(x: int, n: int) -> int:
+    return ((x << n) | (x >> (64 - n))) & MASK64 if n else x
+
+
+def keccak_p(a: List[int], rounds: int):
+    for rc in KECCAK_RC[24 - rounds:]:
+        c = [a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20] for x in range(5)]
+        d = [c[(x - 1) % 5] ^ rol64(c[(x + 1) % 5], 1) for x in range(5)]
+        a[:] = [a[i] ^ d[i % 5] for i in range(25)]
+
+        b = [0] * 25
+        for x in range(5):
+            for y in range(5):
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = rol64(a[x + 5 * y], KECCAK_ROT[x][y])
+
+        a[:] = [b[i] ^ (~b[(i + 1) % 5 + 5 * (i // 5)] & b[(i + 2) % 5 + 5 * (i // 5)]) for i in range(25)]
+        a[0] ^= rc
+
+
+class KeccakState:
+    def __init__(self, rounds: int):
+        self.lanes = [0] * 25
+        self.rounds = rounds
+
+    def get(self, length: int) -> bytes:
+        return b''.join(x.to_bytes(8, 'little') for x in self.lanes)[:length]
+
+    def xor(self, data: bytes, offset: int = 0):
+        b = bytearray(b''.join(x.to_bytes(8, 'little') for x in self.lanes))
+        for i, x in enumerate(data):
+            b[offset + i] ^= x
+        self.lanes = [int.from_bytes(b[i:i + 8], 'little') for i in range(0, 200, 8)]
+
+    def permute(self):
+        keccak_p(self.lanes, self.rounds)
+
+
+def turboshake128(data: bytes, domain: int, length: int) -> bytes:
+    """ TurboSHAKE128 over the reference permutation, used to cross-check it against pycryptodome """
+    k = KeccakState(12)
+    data += bytes([domain])
+    data += b'\0' * (-len(data) % 168)
+    for i in range(0, len(data), 168):
+        k.xor(data[i:i + 168])
+        if i + 168 == len(data):
+            k.xor(b'\x80', 167)
+        k.permute()
+
+    return k.get(length)
+
+
+# Keccak duplex AEAD: 168 bytes rate, 167 data bytes per block, 12 rounds
+KECCAK_AEAD_DATA_RATE = 167
+KECCAK_AEAD_KEY, KECCAK_AEAD_AD, KECCAK_AEAD_MSG = 0, 1, 2
+
+
+def keccak_aead_blocks(data: bytes) -> List[Tuple[bytes, bool]]:
+    blocks = [data[i:i + KECCAK_AEAD_DATA_RATE] for i in range(0, len(data), KECCAK_AEAD_DATA_RATE)] or [b'']
+    return [(b, i == len(blocks) - 1) for i, b in enumerate(blocks)]
+
+
+def keccak_aead_pad(k: KeccakState, length: int, block_type: int, last: bool):
+    k.xor(bytes([0x08 | (block_type << 1) | (1 if last else 0)]), length)
+    k.xor(b'\x80', KECCAK_AEAD_DATA_RATE)
+    k.permute()
+
+
+def keccak_aead_encrypt(key: bytes, nonce: bytes, ad: bytes, message: bytes) -> Tuple[bytes, bytes]:
+    k = KeccakState(12)
+    k.xor(key + nonce)
+    keccak_aead_pad(k, len(key + nonce), KECCAK_AEAD_KEY, True)
+
+    for b, last in keccak_aead_blocks(ad):
+        k.xor(b)
+        keccak_aead_pad(k, len(b), KECCAK_AEAD_AD, last)
+
+    ciphertext = b''
+    for b, last in keccak_aead_blocks(message):
+        ciphertext += bytes(x ^ y for x, y in zip(b, k.get(len(b))))
+        k.xor(b)
+        keccak_aead_pad(k, len(b), KECCAK_AEAD_MSG, last)
+
+    return ciphertext, k.get(16)
+
+
+def generate_keccak() -> List[AEADTest]:
+    from Crypto.Hash import TurboSHAKE128
+    for ll in (0, 1, 167, 168, 500):
+        expected = TurboSHAKE128.new(domain=0x1F).update(pattern(ll)).read(300)
+        if turboshake128(pattern(ll), 0x1F, 168) != expected[:168]:
+            raise RuntimeError('Keccak-p reference permutation mismatch')
+
+    ret = []
+    for ad_len in AD_LENGTHS:
+        for ll in MESSAGE_LENGTHS:
+            key = random_bytes(32, 'keccak_aead_key')
+            nonce = random_bytes(16, 'keccak_aead_nonce')
+            ciphertext, tag = keccak_aead_encrypt(key, nonce, ad_pattern(ad_len), pattern(ll))
+            ret.append(AEADTest(key, nonce, ad_len, ciphertext, tag))
+
+    return ret
+
+
+ASCON_AD_LENGTHS = [0, 1, 15, 16, 17, 400]
+ASCON_MESSAGE_LENGTHS = [0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 500, 1024]
+
+
+def generate_ascon() -> List[AEADTest]:
+    ret = []
+    for ad_len in ASCON_AD_LENGTHS:
+        for ll in ASCON_MESSAGE_LENGTHS:
+            key = random_bytes(16, 'ascon_aead_key')
+            nonce = random_bytes(16, 'ascon_aead_nonce')
+            ciphertext, tag = ascon_ref.aead128_encrypt(key, nonce, ad_pattern(ad_len), pattern(ll))
+            ret.append(AEADTest(key, nonce, ad_len, ciphertext, tag))
+
+    return ret
+
+
+GCM_AD_LENGTHS = [0, 1, 15, 16, 17, 400]
+GCM_MESSAGE_LENGTHS = [0, 1, 15, 16, 17, 63, 64, 65, 127, 128, 129, 500, 1024]
+
+
+def generate_aes_gcm() -> List[AEADTest]:
+    from Crypto.Cipher import AES
+
+    ret = []
+    for ad_len in GCM_AD_LENGTHS:
+        for ll in GCM_MESSAGE_LENGTHS:
+            key = random_bytes(AES.key_size[len(ret) % 3], 'aes_gcm_key')
+            nonce = random_bytes(12, 'aes_gcm_nonce')
+            ciphertext, tag = AES.new(key, AES.MODE_GCM, nonce=nonce).update(ad_pattern(ad_len)) \
+                .encrypt_and_digest(pattern(ll))
+            ret.append(AEADTest(key, nonce, ad_len, ciphertext, tag))
+
+    return ret
+
+
+def generate_chacha20_poly1305() -> List[AEADTest]:
+    from Crypto.Cipher import ChaCha20_Poly1305
+
+    ret = []
+    for ad_len in GCM_AD_LENGTHS:
+        for ll in GCM_MESSAGE_LENGTHS:
+            key = random_bytes(32, 'chacha20_poly1305_key')
+            nonce = random_bytes(12, 'chacha20_poly1305_nonce')
+            cipher = ChaCha20_Poly1305.new(key=key, nonce=nonce)
+            cipher.update(ad_pattern(ad_len))
+            ciphertext, tag = cipher.encrypt_and_digest(pattern(ll))
+            ret.append(AEADTest(key, nonce, ad_len, ciphertext, tag))
+
+    return ret
+
+
+def run():
+    if len(sys.argv) < 2:
+        raise RuntimeError('cipher name is not set')
+
+    cipher_name = sys.argv[1]
+    match cipher_name:
+        case 'keccak': tests = generate_keccak()
+        case 'ascon': tests = generate_ascon()
+        case 'aes_gcm': tests = generate_aes_gcm()
+        case 'chacha20_poly1305': tests = generate_chacha20_poly1305()
+        case _: raise RuntimeError('unknown cipher name: %s' % cipher_name)
+
+    out = sys.stdout
+    close_out = False
+    if len(sys.argv) > 2:
+        out = open(sys.argv[2], 'w', encoding='utf8')
+        close_out = True
+
+    out.write('#include <cipher/aead_test_data.hpp>\n')
+
+    out.write('\nconst cipher_aead_test * const %s_aead_tests[] = {\n' % cipher_name)
+    for i, t in enumerate(tests):
+        out.write('  /* %03d */ (const cipher_aead_test []) {{\n' % i)
+        out.write('    .k = {\n')
+        print_buffer(t.key, out, '      ')
+        out.write('    },\n')
+        out.write('    .kl = %d,\n' % len(t.key))
+        out.write('    .n = {\n')
+        print_buffer(t.nonce, out, '      ')
+        out.write('    },\n')
+        out.write('    .al = %d,\n' % t.ad_len)
+        out.write('    .ml = %d,\n' % len(t.ciphertext))
+        out.write('    .c = {\n')
+        print_buffer(t.ciphertext, out, '      ')
+        out.write('    },\n')
+        out.write('    .t = {\n')
+        print_buffer(t.tag, out, '      ')
+        out.write('    },\n')
+        out.write('  }},\n')
+    out.write('  nullptr\n};\n')
+
+    if close_out:
+        out.close()
+
+
+if __name__ == '__main__':
+    run()
@@ -1,14 +1,44 @@
 #include "block_test_data.hpp"
+#include "stream_test_data.hpp"
 
 #include <ub/crypto/aes.hpp>
+#include <cipher/aes_common.hpp>
 
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <iterator>
 
 using namespace ub::crypto;
+using namespace ub::crypto::impl;
 
-int main() {
+static const size_t chunks[] = { 1, 15, 16, 17, 64, 3, 100, 40, 256, 130 };
+
+static void testCtr(const char *name, const cipher_stream_test * const *tests, bool counter32) {
+    for (size_t i = 0; tests[i] != nullptr; i++) {
+        const cipher_stream_test *t = tests[i];
+
+        aes_ctr ctx;
+        ctx.init(t->k, t->n, t->kl, counter32);
+
+        uint8_t output[sizeof(t->s)];
+        std::memset(output, 0, t->sl);
+
+        for (size_t offset = 0, c = i; offset < t->sl; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->sl - offset);
+            ctx.process(output + offset, output + offset, len);
+            offset += len;
+        }
+
+        if (std::memcmp(output, t->s, t->sl) != 0) {
+            fprintf(stderr, "%s test failed at sample %zd\n", name, i);
+            exit(1);
+        }
+    }
+}
+
+static void testBackend() {
     aes aes;
 
     for (size_t i = 0; aes_block_tests[i] != nullptr; i++) {
@@ -25,7 +55,38 @@ int main() {
             fprintf(stderr, "aes::encrypt test failed at sample %zd\n", i);
             exit(1);
         }
+
+        // the same block in every position of a multi-block batch
+        uint8_t blocks[(aes::PARALLEL + 3) * aes::BLOCK];
+        size_t count = 1 + i % (aes::PARALLEL + 3);
+
+        for (size_t j = 0; j < count; j++) {
+            std::memcpy(blocks + j * aes::BLOCK, t->i, aes::BLOCK);
+        }
+
+        aes.encryptBlocks(blocks, count);
+
+        for (size_t j = 0; j < count; j++) {
+            if (std::memcmp(blocks + j * aes::BLOCK, t->o, aes::BLOCK) != 0) {
+                fprintf(stderr, "aes::encryptBlocks test failed at sample %zd\n", i);
+                exit(1);
+            }
+        }
     }
 
+    testCtr("aes_ctr", aes_ctr_tests, false);
+    testCtr("aes_ctr (32-bit counter)", aes_ctr32_tests, true);
+}
+
+int main() {
+    // hardware backend (if available), then bitsliced one
+    testBackend();
+
+#if UB_CRYPTO_AES_DISPATCH
+    cpuRestrictFeatures(0);
+    aesResetBackends();
+    testBackend();
+#endif
+
     return 0;
-}
\ No newline at end of file
+}
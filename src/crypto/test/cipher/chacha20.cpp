@@ -1,29 +1,138 @@
 #include "stream_test_data.hpp"
 
 #include <ub/crypto/chacha20.hpp>
+#include <ub/crypto/utility.hpp>
+#include <cpu.hpp>
 
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 using namespace ub::crypto;
+using namespace ub::crypto::impl;
 
-int main() {
-    for (size_t i = 0; chacha20_tests[i] != nullptr; i++) {
-        const cipher_stream_test *t = chacha20_tests[i];
+static const size_t chunks[] = { 1, 63, 512, 3, 64, 17, 300, 256, 5 };
 
-        chacha20 ctx;
+static void fail(const char *name, const char *what, size_t i) {
+    fprintf(stderr, "%s %s failure on sample %zd\n", name, what, i);
+    exit(1);
+}
+
+static void init(chacha20 &ctx, const cipher_stream_test *t) {
+    if (t->nl == chacha20::NONCE64_LENGTH) {
+        ctx.init64(t->k, t->n);
+    } else {
         ctx.init(t->k, t->n);
+    }
+
+    if (t->o != 0) {
+        ctx.seek(t->o);
+    }
+}
+
+static void runTests(const char *name, const cipher_stream_test * const *tests) {
+    size_t i;
+    for (i = 0; tests[i] != nullptr; i++) {
+        const cipher_stream_test *t = tests[i];
+
+        chacha20 ctx;
+        init(ctx, t);
 
         uint8_t output[t->sl];
         std::memset(output, 0, t->sl);
         ctx.process(output, output, t->sl);
 
         if (std::memcmp(output, t->s, t->sl) != 0) {
-            fprintf(stderr, "chacha20 test failed at sample %zd\n", i);
+            fail(name, "output", i);
+        }
+
+        init(ctx, t);
+        std::memset(output, 0, t->sl);
+
+        for (size_t offset = 0, c = i; offset < t->sl; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->sl - offset);
+            ctx.process(output + offset, output + offset, len);
+            offset += len;
+        }
+
+        if (std::memcmp(output, t->s, t->sl) != 0) {
+            fail(name, "chunked", i);
+        }
+
+        // seeking in the middle of the expected key stream
+        size_t skip = (i * 37) % t->sl;
+        ctx.seek(t->o + skip);
+        std::memset(output, 0, t->sl - skip);
+        ctx.process(output, output, t->sl - skip);
+
+        if (std::memcmp(output, t->s + skip, t->sl - skip) != 0) {
+            fail(name, "seek", i);
+        }
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+static void runTests(const char *name) {
+    char buffer[64];
+    runTests(name, chacha20_tests);
+
+    snprintf(buffer, sizeof(buffer), "%s djb", name);
+    runTests(buffer, chacha20_djb_tests);
+}
+
+/** Large buffers split between threads must match sequential processing in small pieces */
+static void testParallel(const char *name, const cipher_stream_test *t) {
+    std::vector<uint8_t> expected(5 << 20), output(expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = i % 251;
+    }
+
+    output = expected;
+
+    chacha20 ctx;
+    init(ctx, t);
+
+    for (size_t offset = 0; offset < expected.size(); offset += 4096) {
+        ctx.process(expected.data() + offset, expected.data() + offset, 4096);
+    }
+
+    for (size_t threads: { 1, 4 }) {
+        setMaxThreads(threads);
+
+        std::vector<uint8_t> buffer = output;
+        init(ctx, t);
+
+        // unaligned start, so the parallel part begins with a partially used block
+        ctx.process(buffer.data(), buffer.data(), 5);
+        ctx.process(buffer.data() + 5, buffer.data() + 5, buffer.size() - 5);
+
+        if (buffer != expected) {
+            fprintf(stderr, "%s parallel (%zd threads) failure\n", name, threads);
             exit(1);
         }
     }
 
+    setMaxThreads(0);
+    printf("%s parallel test ok\n", name);
+}
+
+int main() {
+    runTests("chacha20");
+
+    // 64-bit counter crosses 2^32 blocks inside the buffer
+    testParallel("chacha20", chacha20_tests[1]);
+    testParallel("chacha20 djb", chacha20_djb_tests[2]);
+
+    cpuRestrictFeatures(CPU_X86_SSE2);
+    runTests("chacha20 (sse2)");
+
+    cpuRestrictFeatures(0);
+    runTests("chacha20 (generic)");
+    testParallel("chacha20 (generic) djb", chacha20_djb_tests[2]);
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,121 @@
+#include "aead_test_data.hpp"
+
+#include <ub/crypto/keccak_aead.hpp>
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ub::crypto;
+
+static const size_t chunks[] = { 1, 166, 3, 167, 8, 200, 17, 168 };
+
+static uint8_t message[1024];
+static uint8_t ad[512];
+
+static void fail(const char *what, size_t i) {
+    fprintf(stderr, "keccak_aead %s failure on sample %zd\n", what, i);
+    exit(1);
+}
+
+/** Process buffer in chunks of varying size with `fn` member of AEAD instance */
+static void chunked(keccak_aead &ctx, void (keccak_aead::*fn)(uint8_t *, const uint8_t *, size_t), uint8_t *dst,
+                    const uint8_t *src, size_t length)
+{
+    for (size_t offset = 0, c = 0; offset < length; c++) {
+        size_t len = std::min(chunks[c % std::size(chunks)], length - offset);
+        (ctx.*fn)(dst + offset, src + offset, len);
+        offset += len;
+    }
+}
+
+int main() {
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = i % 251;
+    }
+
+    for (size_t i = 0; i < sizeof(ad); i++) {
+        ad[i] = (i * 7 + 1) % 256;
+    }
+
+    keccak_aead ctx;
+    uint8_t buffer[sizeof(message)];
+    uint8_t tag[keccak_aead::TAG_LENGTH];
+
+    size_t i = 0;
+    for (; keccak_aead_tests[i] != nullptr; i++) {
+        const cipher_aead_test *t = keccak_aead_tests[i];
+
+        ctx.init(t->k, t->n);
+        ctx.authenticate(ad, t->al);
+        ctx.encrypt(buffer, message, t->ml);
+        if (t->ml != 0) {
+            // associated data after message data is ignored
+            ctx.authenticate(ad, 5);
+        }
+        ctx.finish(tag);
+
+        if (memcmp(buffer, t->c, t->ml) != 0 || memcmp(tag, t->t, sizeof(tag)) != 0) {
+            fail("encryption", i);
+        }
+
+        ctx.init(t->k, t->n);
+        for (size_t offset = 0, c = 0; offset < t->al; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->al - offset);
+            ctx.authenticate(ad + offset, len);
+            offset += len;
+        }
+
+        memcpy(buffer, message, t->ml);
+        chunked(ctx, &keccak_aead::encrypt, buffer, buffer, t->ml);
+        ctx.finish(tag);
+
+        if (memcmp(buffer, t->c, t->ml) != 0 || memcmp(tag, t->t, sizeof(tag)) != 0) {
+            fail("chunked encryption", i);
+        }
+
+        ctx.init(t->k, t->n);
+        ctx.authenticate(ad, t->al);
+        chunked(ctx, &keccak_aead::decrypt, buffer, buffer, t->ml);
+
+        if (!ctx.verify(t->t) || memcmp(buffer, message, t->ml) != 0) {
+            fail("decryption", i);
+        }
+
+        // any modification of associated data, ciphertext or tag must be detected
+        memcpy(tag, t->t, sizeof(tag));
+        tag[i % sizeof(tag)] ^= 0x01;
+
+        ctx.init(t->k, t->n);
+        ctx.authenticate(ad, t->al);
+        ctx.decrypt(buffer, t->c, t->ml);
+
+        if (ctx.verify(tag)) {
+            fail("tag forgery", i);
+        }
+
+        if (t->ml != 0) {
+            memcpy(buffer, t->c, t->ml);
+            buffer[i % t->ml] ^= 0x80;
+
+            ctx.init(t->k, t->n);
+            ctx.authenticate(ad, t->al);
+            ctx.decrypt(buffer, buffer, t->ml);
+
+            if (ctx.verify(t->t)) {
+                fail("ciphertext forgery", i);
+            }
+        }
+
+        ctx.init(t->k, t->n);
+        ctx.authenticate(ad, t->al + 1);
+        ctx.decrypt(buffer, t->c, t->ml);
+
+        if (ctx.verify(t->t)) {
+            fail("associated data forgery", i);
+        }
+    }
+
+    printf("keccak_aead test ok: %zd samples\n", i);
+    return 0;
+}
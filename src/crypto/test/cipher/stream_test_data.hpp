@@ -9,10 +9,14 @@ struct cipher_stream_test {
     uint8_t k[32];  //! Key data
     size_t  nl;     //! Nonce length in bytes
     uint8_t n[32];  //! Nonce data
+    uint64_t o;     //! Key stream offset in bytes
     size_t  sl;     //! Key stream length in bytes
-    uint8_t s[256]; //! Expected key stream
+    uint8_t s[1024];//! Expected key stream
 };
 
 extern const cipher_stream_test * const chacha20_tests[];
+extern const cipher_stream_test * const chacha20_djb_tests[];
+extern const cipher_stream_test * const aes_ctr_tests[];
+extern const cipher_stream_test * const aes_ctr32_tests[];
 
 #endif // UB_TEST_CRYPTO_CIPHER_STREAM_TEST_DATA_H
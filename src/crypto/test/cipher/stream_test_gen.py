@@ -1,26 +1,48 @@
 import sys
-from typing import NamedTuple, Any
-from Crypto.Cipher import ChaCha20
+from typing import NamedTuple
+from Crypto.Cipher import AES, ChaCha20
+from Crypto.Util import Counter
 
-from testgen.utils import random_bytes, print_buffer
-
-
-class CipherDefn(NamedTuple):
-    cipher: Any
-    nonce_len: int
+from testgen.utils import random_bytes, print_buffer, random_number
 
 
 class StreamTest(NamedTuple):
     key: bytes
     nonce: bytes
     output: bytes
+    offset: int = 0
+
+
+def generate_chacha20_test(name: str, i: int, nonce_len: int) -> StreamTest:
+    key = random_bytes(32, f'stream_key_{name}')
+    nonce = random_bytes(nonce_len, f'stream_nonce_{name}')
+
+    # key stream starting at arbitrary offsets, including the ones crossing 2^32 blocks with 64-bit counter
+    match i % 4:
+        case 0: offset = 0
+        case 1: offset = random_number(1 << 30, f'stream_offset_{name}')
+        case 2 if nonce_len == 8: offset = (1 << 38) - random_number(1024, f'stream_offset_{name}')
+        case _: offset = random_number((1 << (50 if nonce_len == 8 else 38)) - 2048, f'stream_offset_{name}')
 
+    cipher = ChaCha20.new(key=key, nonce=nonce)
+    cipher.seek(offset)
+    return StreamTest(key, nonce, cipher.encrypt(b'\x00' * 1024), offset)
 
-def generate_stream_test(name: str, cipher: CipherDefn) -> StreamTest:
-    key = random_bytes(cipher.cipher.key_size, f'stream_key_{name}')
-    nonce = random_bytes(cipher.nonce_len, f'stream_nonce_{name}')
-    data = cipher.cipher.new(key=key, nonce=nonce).encrypt(b'\x00' * 256)
-    return StreamTest(key, nonce, data)
+
+def generate_aes_ctr_test(name: str, i: int, counter_bits: int) -> StreamTest:
+    key = random_bytes(AES.key_size[i % 3], f'stream_key_{name}')
+    nonce = bytearray(random_bytes(16, f'stream_nonce_{name}'))
+
+    # exercise carries out of the low 32 and 64 bits of the counter
+    match i % 4:
+        case 1: nonce[12:16] = b'\xFF\xFF\xFF\xFD'
+        case 2: nonce[8:16] = b'\xFF' * 7 + b'\xF0'
+
+    prefix = bytes(nonce[:16 - counter_bits // 8])
+    counter = Counter.new(counter_bits, prefix=prefix, allow_wraparound=True,
+                          initial_value=int.from_bytes(nonce[len(prefix):], 'big'))
+    data = AES.new(key, AES.MODE_CTR, counter=counter).encrypt(b'\x00' * 256)
+    return StreamTest(key, bytes(nonce), data)
 
 
 def run():
@@ -29,11 +51,12 @@ def run():
 
     cipher_name = sys.argv[1]
     match cipher_name:
-        case 'chacha20': cipher = CipherDefn(ChaCha20, 12)
+        case 'chacha20': tests = [generate_chacha20_test(cipher_name, i, 12) for i in range(100)]
+        case 'chacha20_djb': tests = [generate_chacha20_test(cipher_name, i, 8) for i in range(100)]
+        case 'aes_ctr': tests = [generate_aes_ctr_test(cipher_name, i, 128) for i in range(100)]
+        case 'aes_ctr32': tests = [generate_aes_ctr_test(cipher_name, i, 32) for i in range(100)]
         case _: raise RuntimeError('unknown cipher name: %s' % cipher_name)
 
-    tests = [generate_stream_test(cipher_name, cipher) for _ in range(100)]
-
     out = sys.stdout
     close_out = False
     if len(sys.argv) > 2:
@@ -53,6 +76,7 @@ def run():
         out.write('    .n = {\n')
         print_buffer(t.nonce, out, '      ')
         out.write('    },\n')
+        out.write('    .o = %d,\n' % t.offset)
         out.write('    .sl = %d,\n' % len(t.output))
         out.write('    .s = {\n')
         print_buffer(t.output, out, '      ')
@@ -0,0 +1,14 @@
+#include <device_test.hpp>
+
+#include <ub/crypto/ascon.hpp>
+using namespace ub::crypto;
+
+TEST_IO_VARIABLE(uint8_t message[32768]);
+TEST_IO_VARIABLE(size_t  messageLen);
+TEST_IO_VARIABLE(uint8_t digest[ascon_hash256::OUTPUT]);
+
+TEST_MAIN (void) {
+    ascon_hash256 ctx;
+    ctx.update(message, messageLen);
+    ctx.finish(digest);
+}
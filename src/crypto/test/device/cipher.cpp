@@ -2,6 +2,7 @@
 
 #include <ub/crypto/aes.hpp>
 #include <ub/crypto/chacha20.hpp>
+#include <ub/crypto/ascon.hpp>
 
 using namespace ub::crypto;
 
@@ -10,6 +11,7 @@ TEST_IO_VARIABLE(size_t  keyLength);
 TEST_IO_VARIABLE(uint8_t nonce[16]);
 TEST_IO_VARIABLE(uint8_t message[1024]);
 TEST_IO_VARIABLE(size_t  messageLength);
+TEST_IO_VARIABLE(uint8_t tag[16]);
 
 TEST_MAIN (void) {
 #if defined(TEST_AES) && TEST_AES
@@ -23,4 +25,11 @@ TEST_MAIN (void) {
     ctx.init(key, nonce);
     ctx.process(message, message, messageLength);
 #endif
+
+#if defined(TEST_ASCON) && TEST_ASCON
+    ascon_aead128 ctx;
+    ctx.init(key, nonce);
+    ctx.encrypt(message, message, messageLength);
+    ctx.finish(tag);
+#endif
 }
@@ -4,13 +4,15 @@ from Crypto.Util import Counter
 
 from devtest.runner import TestRunner
 from testgen.utils import random_bytes
+from testgen import ascon_ref
 
 
 class CipherDefn(NamedTuple):
     key_length: int
     nonce_length: int
-    encrypt: Callable[[bytes, bytes, bytes], bytes]  # (key, nonce, message) -> ciphertext
+    encrypt: Callable[[bytes, bytes, bytes], bytes]  # (key, nonce, message) -> ciphertext || tag
     fixed_key_length: bool
+    tag_length: int = 0
 
 
 def aes_encrypt(key: bytes, nonce: bytes, message: bytes) -> bytes:
@@ -22,6 +24,11 @@ def chacha20_encrypt(key: bytes, nonce: bytes, message: bytes) -> bytes:
     return ChaCha20.new(key=key, nonce=nonce).encrypt(message)
 
 
+def ascon_aead128_encrypt(key: bytes, nonce: bytes, message: bytes) -> bytes:
+    ciphertext, tag = ascon_ref.aead128_encrypt(key, nonce, b'', message)
+    return ciphertext + tag
+
+
 class TestRunnerImpl(TestRunner):
     def run(self):
         env = self._env
@@ -30,6 +37,7 @@ class TestRunnerImpl(TestRunner):
         match cipher_name:
             case 'aes': cipher = CipherDefn(32, 16, aes_encrypt, False)
             case 'chacha20': cipher = CipherDefn(32, 12, chacha20_encrypt, True)
+            case 'ascon_aead128': cipher = CipherDefn(16, 16, ascon_aead128_encrypt, True, 16)
             case _: raise RuntimeError('unknown cipher: %s' % cipher_name)
 
         key = random_bytes(cipher.key_length, f'dev_cipher_key_{cipher_name}')
@@ -48,6 +56,9 @@ class TestRunnerImpl(TestRunner):
         env.run()
 
         r_message = env.read('message', len(message))
+        if cipher.tag_length != 0:
+            r_message += env.read('tag', cipher.tag_length)
+
         c_message = cipher.encrypt(key, nonce, message)
 
         if r_message != c_message:
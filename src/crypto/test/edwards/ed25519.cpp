@@ -61,6 +61,19 @@ int main() {
         assertEquals(r, t->xr, t->yr, i, "mul");
     }
 
+    for (size_t i = 0; ed25519_mul_base_tests[i] != nullptr; i++) {
+        const ed25519_mul_base_test *t = ed25519_mul_base_tests[i];
+
+        ed25519_pt r;
+        uint256_t k;
+
+        memcpy(k.u8, t->k, uint256_t::N_U8);
+
+        ED25519::mulBase(r, k);
+
+        assertEquals(r, t->xr, t->yr, i, "mulBase");
+    }
+
     for (size_t i = 0; ed25519_load_tests[i] != nullptr; i++) {
         const ed25519_load_test *t = ed25519_load_tests[i];
 
@@ -20,6 +20,12 @@ struct ed25519_mul_test {
     uint8_t yr[32]; //! Y coord of product
 };
 
+struct ed25519_mul_base_test {
+    uint8_t k[32];  //! Scalar multiplier
+    uint8_t xr[32]; //! X coord of product
+    uint8_t yr[32]; //! Y coord of product
+};
+
 struct ed25519_load_test {
     uint8_t b[32];  //! Packed point
     bool valid;     //! Whether packed point is valid
@@ -29,6 +35,7 @@ struct ed25519_load_test {
 
 extern const ed25519_add_test * const ed25519_add_tests[];
 extern const ed25519_mul_test * const ed25519_mul_tests[];
+extern const ed25519_mul_base_test * const ed25519_mul_base_tests[];
 extern const ed25519_load_test * const ed25519_load_tests[];
 
 #endif // UB_TEST_CRYPTO_EDWARDS_ED25519_TEST_DATA_H
@@ -98,6 +98,8 @@ def run():
         random_points
     )
 
+    mul_base_samples = [random_number(kL) for _ in range(20)] + [0, 1, kL - 1]
+
     load_samples = itertools.chain(
         map(lambda xx: encode_point(xx[0], xx[1]), random_points),
         map(lambda xx: xx.to_bytes(32, 'little'), random_numbers)
@@ -133,6 +135,16 @@ def run():
         out.write('  }},\n')
     out.write('  nullptr\n};\n')
 
+    out.write('\nconst ed25519_mul_base_test * const ed25519_mul_base_tests[] = {\n')
+    for i, k in enumerate(mul_base_samples):
+        (rx, ry) = scalar_mult(Bx, By, k)
+        out.write('  /* %03d */ (const ed25519_mul_base_test []) {{\n' % i)
+        out.write('    .k  = %s,\n' % number_to_c(k))
+        out.write('    .xr = %s,\n' % number_to_c(rx))
+        out.write('    .yr = %s,\n' % number_to_c(ry))
+        out.write('  }},\n')
+    out.write('  nullptr\n};\n')
+
     out.write('\nconst ed25519_load_test * const ed25519_load_tests[] = {\n')
     for i, b in enumerate(load_samples):
         r = decode_point(b)
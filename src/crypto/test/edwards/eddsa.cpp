@@ -58,6 +58,92 @@ int main() {
         }
     }
 
+    // batch of all samples goes through individual verification, batch of valid ones passes combined check
+    for (int validOnly = 0; validOnly < 2; validOnly++) {
+        const uint8_t *keys[64], *sigs[64], *msgs[64];
+        size_t lengths[64], count = 0;
+        bool expected[64], valid[64], allValid = true;
+
+        for (size_t i = 0; eddsa25519_verify_tests[i] != nullptr && count < 64; i++) {
+            const eddsa_verify_test *t = eddsa25519_verify_tests[i];
+            if (t->len == MSG_LEN_PREHASH || (validOnly && !t->valid)) {
+                continue;
+            }
+
+            keys[count] = t->key;
+            sigs[count] = t->sig;
+            msgs[count] = t->msg;
+            lengths[count] = t->len;
+            expected[count] = t->valid;
+            allValid = allValid && t->valid;
+            count++;
+        }
+
+        bool ok = ed25519::verifyBatch(keys, sigs, msgs, lengths, count, valid);
+        if (ok != allValid || ok != ed25519::verifyBatch(keys, sigs, msgs, lengths, count)) {
+            fprintf(stderr, "ed25519::verifyBatch test failed for %zd samples\n", count);
+            exit(1);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (valid[i] != expected[i]) {
+                fprintf(stderr, "ed25519::verifyBatch test failed at batch sample %zd\n", i);
+                exit(1);
+            }
+        }
+    }
+
+    // signatures under keys with small order component are rejected by verify(), but accepted by verifyBatch()
+    // regardless of other signatures in the batch or the batch size
+    for (size_t i = 0; eddsa25519_torsion_tests[i] != nullptr; i++) {
+        const eddsa_verify_test *t = eddsa25519_torsion_tests[i];
+
+        if (ed25519::verify(t->key, t->sig, t->msg, t->len) != t->valid) {
+            fprintf(stderr, "ed25519::verify torsion test failed at sample %zd\n", i);
+            exit(1);
+        }
+
+        // sample followed by three valid signatures and optionally one invalid, or alone
+        const uint8_t *keys[5] = { t->key }, *sigs[5] = { t->sig }, *msgs[5] = { t->msg };
+        size_t lengths[5] = { t->len };
+        bool expected[5] = { true };
+        size_t count = 1;
+
+        for (size_t j = 0; eddsa25519_verify_tests[j] != nullptr && count < 5; j++) {
+            const eddsa_verify_test *v = eddsa25519_verify_tests[j];
+            if (v->len == MSG_LEN_PREHASH || (count == 4 && v->valid) || (count < 4 && !v->valid)) {
+                continue;
+            }
+
+            keys[count] = v->key;
+            sigs[count] = v->sig;
+            msgs[count] = v->msg;
+            lengths[count] = v->len;
+            expected[count] = v->valid;
+            count++;
+        }
+
+        // single signatures, combined check, and combined check failing because of the invalid signature
+        static const size_t sizes[] = { 1, 3, 4, 5 };
+        for (size_t n : sizes) {
+            bool valid[5];
+            bool ok = ed25519::verifyBatch(keys, sigs, msgs, lengths, n, valid);
+
+            if (ok != (n < 5)) {
+                fprintf(stderr, "ed25519::verifyBatch torsion test failed at sample %zd for %zd signatures\n", i, n);
+                exit(1);
+            }
+
+            for (size_t j = 0; j < n; j++) {
+                if (valid[j] != expected[j]) {
+                    fprintf(stderr, "ed25519::verifyBatch torsion test failed at sample %zd, batch sample %zd\n",
+                            i, j);
+                    exit(1);
+                }
+            }
+        }
+    }
+
     for (size_t i = 0; eddsa448_public_key_tests[i] != nullptr; i++) {
         const eddsa_public_key_test *t = eddsa448_public_key_tests[i];
 
@@ -31,6 +31,9 @@ struct eddsa_verify_test {
 extern const eddsa_public_key_test * const eddsa25519_public_key_tests[];
 extern const eddsa_sign_test * const eddsa25519_sign_tests[];
 extern const eddsa_verify_test * const eddsa25519_verify_tests[];
+
+/** Ed25519 signatures under keys with small order component, only valid with cofactored equation */
+extern const eddsa_verify_test * const eddsa25519_torsion_tests[];
 extern const eddsa_public_key_test * const eddsa448_public_key_tests[];
 extern const eddsa_sign_test * const eddsa448_sign_tests[];
 extern const eddsa_verify_test * const eddsa448_verify_tests[];
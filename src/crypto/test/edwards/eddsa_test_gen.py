@@ -2,7 +2,7 @@ import sys
 from typing import NamedTuple, Union, Callable
 import hashlib
 
-from testgen.rfc8032_ref import PureEdDSA, pEd25519, pEd448, pEd25519ctx, ed448ph_prehash
+from testgen.rfc8032_ref import PureEdDSA, pEd25519, pEd448, pEd25519ctx, ed448ph_prehash, Edwards25519Point, from_le
 from testgen.utils import random_bytes, random_number, bytes_to_c, print_buffer
 
 
@@ -55,11 +55,57 @@ def generate_sign_test(scheme: EdDSAScheme) -> SignTest:
     return SignTest(key, is_hash, data, sig)
 
 
+def flip_bit(data: bytes, label: str) -> bytes:
+    bit = random_number(8 * len(data), label)
+    out = bytearray(data)
+    out[bit // 8] ^= 1 << (bit % 8)
+    return bytes(out)
+
+
 def generate_verify_test(scheme: EdDSAScheme) -> VerifyTest:
     s = generate_sign_test(scheme)
+    pubkey = to_public_key(scheme.pure, s.key)
     valid = random_number(2, 'verify_valid') != 0
-    sig = s.sig if valid else random_bytes(64, 'verify_fake_sig')
-    return VerifyTest(to_public_key(scheme.pure, s.key), s.hash, s.data, sig, valid)
+    if valid:
+        return VerifyTest(pubkey, s.hash, s.data, s.sig, True)
+
+    # random signature, or a single bit flipped in R, in low half of S or in the message
+    half = len(s.sig) // 2
+    kind = random_number(4, 'verify_fake_kind')
+    if kind == 0:
+        return VerifyTest(pubkey, s.hash, s.data, random_bytes(len(s.sig), 'verify_fake_sig'), False)
+    elif kind == 1 or len(s.data) == 0:
+        return VerifyTest(pubkey, s.hash, s.data, flip_bit(s.sig[:half], 'verify_fake_r') + s.sig[half:], False)
+    elif kind == 2:
+        s_low = flip_bit(s.sig[half:half + 16], 'verify_fake_s')
+        return VerifyTest(pubkey, s.hash, s.data, s.sig[:half] + s_low + s.sig[half + 16:], False)
+    else:
+        return VerifyTest(pubkey, s.hash, flip_bit(s.data, 'verify_fake_msg'), s.sig, False)
+
+
+def generate_torsion_test(i: int) -> VerifyTest:
+    """
+    Ed25519 signature under public key aB + T, where T has order 2, with odd k. Then sB - kA = R + T, so it is rejected
+    by cofactorless verification, but accepted by cofactored one.
+    """
+    B = pEd25519.B
+    T = Edwards25519Point(B.f0, -B.f1)
+
+    a = random_number(B.l(), f'torsion_a_{i}')
+    pubkey = (B * a + T).encode()
+
+    while True:
+        data = random_bytes(32, f'torsion_msg_{i}')
+        r = random_number(B.l(), f'torsion_r_{i}')
+        R = (B * r).encode()
+        k = from_le(hashlib.sha512(R + pubkey + data).digest()) % B.l()
+        if k % 2 == 1:
+            break
+
+    sig = R + ((r + k * a) % B.l()).to_bytes(32, byteorder='little')
+    assert pEd25519.verify(pubkey, data, sig, None, False)
+
+    return VerifyTest(pubkey, False, data, sig, False)
 
 
 def write_test(out, scheme: PureEdDSA, t: Union[SignTest, VerifyTest], last: bool):
@@ -126,6 +172,14 @@ def run():
     ed25519 = EdDSAScheme(pEd25519, pEd25519ctx, lambda x: hashlib.sha512(x).digest())
     generate_eddsa_tests(out, ed25519, 'eddsa25519')
 
+    out.write('\nconst eddsa_verify_test * const eddsa25519_torsion_tests[] = {\n')
+    for i in range(4):
+        out.write('  /* %03d */ (const eddsa_verify_test []) {{\n' % i)
+        write_test(out, pEd25519, generate_torsion_test(i), False)
+        out.write('    .valid = false\n')
+        out.write('  }},\n')
+    out.write('  nullptr\n};\n')
+
     ed448 = EdDSAScheme(pEd448, pEd448, lambda x: ed448ph_prehash(x, b''))
     generate_eddsa_tests(out, ed448, 'eddsa448')
 
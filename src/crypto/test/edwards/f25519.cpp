@@ -93,6 +93,16 @@ int main() {
 
         F25519::inv(r, x);
         assertEquals(r, t->i, i, "inv");
+
+        F25519::sqr(r, x);
+        assertEquals(r, t->s, i, "sqr");
+
+        F25519::sqrn(r, x, 13);
+        assertEquals(r, t->t, i, "sqrn");
+
+        r = x;
+        F25519::sqr(r, r);
+        assertEquals(r, t->s, i, "sqr (in place)");
     }
 
     return 0;
@@ -16,6 +16,8 @@ struct f25519_unary_test {
     uint8_t x[32];  //! Input
     uint8_t n[32];  //! `-x`
     uint8_t i[32];  //! `x^(-1) mod p`
+    uint8_t s[32];  //! `x^2 mod p`
+    uint8_t t[32];  //! `x^(2^13) mod p`
     bool    re;     //! Whether square root of `x` exists
     uint8_t r[32];  //! `sqrt(x)`
 };
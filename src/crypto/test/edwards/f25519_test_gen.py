@@ -70,6 +70,8 @@ def run():
         out.write('    .x = ' + number_to_c(x) + ',\n')
         out.write('    .n = ' + number_to_c(q - x % q) + ',\n')
         out.write('    .i = ' + number_to_c(pow(x, q - 2, q)) + ',\n')
+        out.write('    .s = ' + number_to_c(pow(x, 2, q)) + ',\n')
+        out.write('    .t = ' + number_to_c(pow(x, 2 ** 13, q)) + ',\n')
         if r != 0:
             out.write('    .re = true,\n')
             out.write('    .r = ' + number_to_c(r) + '\n')
@@ -95,5 +95,15 @@ int main() {
 
         F448::powP34(r, x);
         assertEquals(r, t->q, i, "powP34");
+
+        F448::sqr(r, x);
+        assertEquals(r, t->s, i, "sqr");
+
+        F448::sqrn(r, x, 13);
+        assertEquals(r, t->t, i, "sqrn");
+
+        r = x;
+        F448::sqr(r, r);
+        assertEquals(r, t->s, i, "sqr (in place)");
     }
 }
@@ -15,6 +15,8 @@ struct f448_unary_test {
     uint8_t n[56];  //! `p - x`
     uint8_t i[56];  //! `x^-1`
     uint8_t q[56];  //! `x^((p-3)//4)`
+    uint8_t s[56];  //! `x^2`
+    uint8_t t[56];  //! `x^(2^13)`
 };
 
 struct f448_binary_test {
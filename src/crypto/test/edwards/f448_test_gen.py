@@ -66,6 +66,8 @@ def run():
         print_number(out, 'n', (Q - x) % Q)
         print_number(out, 'i', pow(x, Q - 2, Q))
         print_number(out, 'q', pow(x, (Q - 3) // 4, Q))
+        print_number(out, 's', pow(x, 2, Q))
+        print_number(out, 't', pow(x, 2 ** 13, Q))
         out.write('  }},\n')
     out.write('  nullptr\n};\n')
 
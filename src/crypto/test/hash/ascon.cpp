@@ -0,0 +1,109 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/ascon.hpp>
+#include <hash/ascon_common.hpp>
+#include <hash/sha3_common.hpp>
+
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static const size_t chunks[] = { 1, 3, 8, 17, 200, 16, 5, 1000 };
+
+static void fail(const char *what, size_t i) {
+    fprintf(stderr, "ascon %s failure on sample %zd\n", what, i);
+    exit(1);
+}
+
+#if UB_CRYPTO_ASCON64
+/** Cross-check 64-bit permutation against bit-interleaved one on a chain of pseudo-random states */
+static void testPermutations() {
+    ascon320::state_t a {}, b {};
+    uint32_t x = 0x12345678;
+
+    for (size_t i = 0; i < 100; i++) {
+        for (uint32_t &w : a.u32) {
+            x = x * 1103515245 + 12345;
+            w ^= x;
+        }
+
+        for (size_t j = 0; j < 5; j++) {
+            keccak1600Interleave(b.u32 + 2 * j, a.u64[j]);
+        }
+
+        static const uint32_t rounds[] = { ascon320::ROUNDS, ASCON_ROUNDS_B, 6, 1 };
+        uint32_t r = rounds[i % 4];
+
+        ascon320Permute32(b, r);
+        ascon320Permute64(a, r);
+
+        for (size_t j = 0; j < 5; j++) {
+            if (keccak1600Deinterleave(b.u32 + 2 * j) != a.u64[j]) {
+                fail("permutation", i);
+            }
+        }
+    }
+
+    printf("ascon320 permutation test ok\n");
+}
+#endif
+
+int main() {
+#if UB_CRYPTO_ASCON64
+    testPermutations();
+#endif
+
+    std::vector<uint8_t> message(10000);
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    ascon_hash256 hash;
+    ascon_xof128 xof;
+    uint8_t output[sizeof(xof_test_sample::output)];
+
+    size_t i = 0;
+    for (; ascon_samples[i] != nullptr; i++) {
+        const xof_test_sample *t = ascon_samples[i];
+        size_t outputLength = t->variant == 1 ? ascon_hash256::OUTPUT : sizeof(output);
+
+        for (size_t chunked = 0; chunked < 2; chunked++) {
+            const size_t *ch = chunked ? chunks : nullptr;
+
+            for (size_t offset = 0, c = 0; offset < t->length; c++) {
+                size_t len = ch ? std::min(ch[c % std::size(chunks)], t->length - offset) : t->length;
+
+                if (t->variant == 1) {
+                    hash.update(message.data() + offset, len);
+                } else {
+                    xof.update(message.data() + offset, len);
+                }
+
+                offset += len;
+            }
+
+            if (t->variant == 1) {
+                hash.finish(output);
+            } else {
+                for (size_t offset = 0, c = 0; offset < outputLength; c++) {
+                    size_t len = ch ? std::min(ch[c % std::size(chunks)], outputLength - offset) : outputLength;
+                    xof.generate(output + offset, len);
+                    offset += len;
+                }
+
+                xof.reset();
+            }
+
+            if (memcmp(output, t->output, outputLength) != 0) {
+                fail(chunked ? "chunked test" : "test", i);
+            }
+        }
+    }
+
+    printf("ascon test ok: %zd samples\n", i);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/blake2.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+
+static const size_t chunks[] = { 1, 63, 3, 4096, 64, 1000, 17, 128 };
+
+static std::vector<uint8_t> message(65536);
+static uint8_t key[blake2s::KEY_LENGTH];
+
+static void fail(const char *what, size_t i) {
+    fprintf(stderr, "blake2s %s failure on sample %zd\n", what, i);
+    exit(1);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (i * 7 + 1) % 256;
+    }
+
+    blake2s ctx;
+    uint8_t digest[blake2s::OUTPUT];
+
+    size_t i = 0;
+    for (; blake2s_samples[i] != nullptr; i++) {
+        const blake_test_sample *t = blake2s_samples[i];
+
+        if (t->mode == 0) {
+            ctx.reset(t->outputLength);
+        } else {
+            ctx.init(key, t->keyLength, t->outputLength);
+        }
+
+        ctx.update(message.data(), t->length);
+        ctx.finish(digest);
+
+        if (memcmp(digest, t->output, t->outputLength) != 0) {
+            fail("test", i);
+        }
+
+        if (t->mode == 0) {
+            ctx.reset(t->outputLength);
+        } else {
+            ctx.init(key, t->keyLength, t->outputLength);
+        }
+
+        for (size_t offset = 0, c = 0; offset < t->length; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->length - offset);
+            ctx.update(message.data() + offset, len);
+            offset += len;
+        }
+
+        ctx.finish(digest);
+
+        if (memcmp(digest, t->output, t->outputLength) != 0) {
+            fail("chunked test", i);
+        }
+    }
+
+    printf("blake2s test ok: %zd samples\n", i);
+    return 0;
+}
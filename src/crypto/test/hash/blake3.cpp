@@ -0,0 +1,104 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/blake3.hpp>
+#include <ub/crypto/utility.hpp>
+#include <cpu.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static const size_t chunks[] = { 1, 1023, 3, 65536, 64, 40000, 17, 1024 };
+
+static std::vector<uint8_t> message(3 << 20);
+static uint8_t key[64];
+
+static void fail(const char *name, const char *what, size_t i) {
+    fprintf(stderr, "%s %s failure on sample %zd\n", name, what, i);
+    exit(1);
+}
+
+static void init(blake3 &ctx, const blake_test_sample *t) {
+    switch (t->mode) {
+    case 0:
+        ctx.reset();
+        break;
+
+    case 1:
+        ctx.initKeyed(key);
+        break;
+
+    default:
+        ctx.initDeriveKey(key, t->keyLength);
+        break;
+    }
+}
+
+static void runTests(const char *name) {
+    blake3 ctx;
+    uint8_t output[sizeof(blake_test_sample::output)];
+
+    size_t i = 0;
+    for (; blake3_samples[i] != nullptr; i++) {
+        const blake_test_sample *t = blake3_samples[i];
+
+        init(ctx, t);
+        ctx.update(message.data(), t->length);
+        ctx.finish(output);
+
+        if (memcmp(output, t->output, blake3::OUTPUT) != 0) {
+            fail(name, "digest", i);
+        }
+
+        // context is ready for the same input after finish()
+        ctx.update(message.data(), t->length);
+        ctx.generate(output, t->outputLength);
+
+        if (memcmp(output, t->output, t->outputLength) != 0) {
+            fail(name, "output", i);
+        }
+
+        ctx.restart();
+        for (size_t offset = 0, c = 0; offset < t->length; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->length - offset);
+            ctx.update(message.data() + offset, len);
+            offset += len;
+        }
+
+        ctx.generate(output, 1);
+        ctx.generate(output + 1, 70);
+        ctx.generate(output + 71, t->outputLength - 71);
+
+        if (memcmp(output, t->output, t->outputLength) != 0) {
+            fail(name, "chunked", i);
+        }
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (i * 7 + 1) % 256;
+    }
+
+    setMaxThreads(1);
+    runTests("blake3");
+
+    setMaxThreads(4);
+    runTests("blake3 (4 threads)");
+
+    cpuRestrictFeatures(CPU_X86_SSE41);
+    runTests("blake3 (sse4.1)");
+
+    cpuRestrictFeatures(0);
+    runTests("blake3 (generic)");
+
+    return 0;
+}
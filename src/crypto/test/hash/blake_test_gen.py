@@ -0,0 +1,193 @@
+import sys
+import hashlib
+from typing import NamedTuple, List
+
+from testgen.utils import print_buffer
+
+
+class BlakeTest(NamedTuple):
+    mode: int           # BLAKE2s: 0 - unkeyed, 1 - keyed; BLAKE3: 0 - hash, 1 - keyed hash, 2 - key derivation
+    key_len: int        # key length, or context string length for key derivation
+    data_len: int
+    output: bytes
+
+
+OUTPUT_LENGTH = 131
+LENGTHS = [0, 1, 63, 64, 65, 127, 128, 1023, 1024, 1025, 2048, 2049, 3072, 5000, 16384, 16385, 31 * 1024 + 1,
+           65536 + 1024, 100000, (1 << 20) + 4097, 3 * (1 << 20) - 1]
+
+
+def pattern(length: int) -> bytes:
+    return bytes(i % 251 for i in range(length))
+
+
+def key_pattern(length: int) -> bytes:
+    return bytes((i * 7 + 1) % 256 for i in range(length))
+
+
+# BLAKE3 reference implementation, follows the specification document
+BLAKE3_IV = [0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19]
+BLAKE3_PERMUTATION = [2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8]
+CHUNK_START, CHUNK_END, PARENT, ROOT = 1, 2, 4, 8
+KEYED_HASH, DERIVE_KEY_CONTEXT, DERIVE_KEY_MATERIAL = 16, 32, 64
+MASK = 0xFFFFFFFF
+
+
+def rotr(x: int, n: int) -> int:
+    return ((x >> n) | (x << (32 - n))) & MASK
+
+
+def g(v: List[int], a: int, b: int, c: int, d: int, x: int, y: int):
+    v[a] = (v[a] + v[b] + x) & MASK
+    v[d] = rotr(v[d] ^ v[a], 16)
+    v[c] = (v[c] + v[d]) & MASK
+    v[b] = rotr(v[b] ^ v[c], 12)
+    v[a] = (v[a] + v[b] + y) & MASK
+    v[d] = rotr(v[d] ^ v[a], 8)
+    v[c] = (v[c] + v[d]) & MASK
+    v[b] = rotr(v[b] ^ v[c], 7)
+
+
+def compress(cv: List[int], block: bytes, counter: int, block_len: int, flags: int) -> List[int]:
+    m = [int.from_bytes(block[i:i + 4], 'little') for i in range(0, 64, 4)]
+    v = cv[:] + BLAKE3_IV[:4] + [counter & MASK, counter >> 32, block_len, flags]
+
+    for r in range(7):
+        g(v, 0, 4, 8, 12, m[0], m[1])
+        g(v, 1, 5, 9, 13, m[2], m[3])
+        g(v, 2, 6, 10, 14, m[4], m[5])
+        g(v, 3, 7, 11, 15, m[6], m[7])
+        g(v, 0, 5, 10, 15, m[8], m[9])
+        g(v, 1, 6, 11, 12, m[10], m[11])
+        g(v, 2, 7, 8, 13, m[12], m[13])
+        g(v, 3, 4, 9, 14, m[14], m[15])
+        m = [m[BLAKE3_PERMUTATION[i]] for i in range(16)]
+
+    return [v[i] ^ v[i + 8] for i in range(8)] + [v[i + 8] ^ cv[i] for i in range(8)]
+
+
+def words(b: bytes) -> List[int]:
+    return [int.from_bytes(b[i:i + 4], 'little') for i in range(0, len(b), 4)]
+
+
+def to_bytes(w: List[int]) -> bytes:
+    return b''.join(x.to_bytes(4, 'little') for x in w)
+
+
+class Output(NamedTuple):
+    cv: List[int]
+    block: bytes
+    counter: int
+    block_len: int
+    flags: int
+
+    def chaining_value(self) -> List[int]:
+        return compress(self.cv, self.block, self.counter, self.block_len, self.flags)[:8]
+
+    def root_bytes(self, length: int) -> bytes:
+        out = b''
+        counter = 0
+        while len(out) < length:
+            out += to_bytes(compress(self.cv, self.block, counter, self.block_len, self.flags | ROOT))
+            counter += 1
+        return out[:length]
+
+
+def chunk_output(key: List[int], chunk: bytes, counter: int, flags: int) -> Output:
+    cv = key
+    blocks = [chunk[i:i + 64] for i in range(0, len(chunk), 64)] or [b'']
+    for i, b in enumerate(blocks[:-1]):
+        cv = compress(cv, b, counter, 64, flags | (CHUNK_START if i == 0 else 0))[:8]
+
+    last = blocks[-1]
+    f = flags | CHUNK_END | (CHUNK_START if len(blocks) == 1 else 0)
+    return Output(cv, last.ljust(64, b'\0'), counter, len(last), f)
+
+
+def parent_output(key: List[int], left: List[int], right: List[int], flags: int) -> Output:
+    return Output(key, to_bytes(left + right), 0, 64, flags | PARENT)
+
+
+def blake3(data: bytes, key: List[int], flags: int, length: int) -> bytes:
+    chunks = [data[i:i + 1024] for i in range(0, len(data), 1024)] or [b'']
+    stack = []
+
+    for i, c in enumerate(chunks[:-1]):
+        cv = chunk_output(key, c, i, flags).chaining_value()
+        total = i + 1
+        while total & 1 == 0:
+            cv = parent_output(key, stack.pop(), cv, flags).chaining_value()
+            total >>= 1
+        stack.append(cv)
+
+    output = chunk_output(key, chunks[-1], len(chunks) - 1, flags)
+    while stack:
+        output = parent_output(key, stack.pop(), output.chaining_value(), flags)
+
+    return output.root_bytes(length)
+
+
+def generate_blake2s() -> List[BlakeTest]:
+    ret = []
+    for key_len in (0, 1, 32):
+        for digest_len in (32, 1, 20):
+            for ll in LENGTHS[:16]:
+                h = hashlib.blake2s(pattern(ll), digest_size=digest_len, key=key_pattern(key_len))
+                ret.append(BlakeTest(1 if key_len else 0, key_len, ll, h.digest()))
+
+    return ret
+
+
+def generate_blake3() -> List[BlakeTest]:
+    ret = []
+    for ll in LENGTHS:
+        data = pattern(ll)
+        ret.append(BlakeTest(0, 0, ll, blake3(data, BLAKE3_IV, 0, OUTPUT_LENGTH)))
+
+        key = words(key_pattern(32))
+        ret.append(BlakeTest(1, 32, ll, blake3(data, key, KEYED_HASH, OUTPUT_LENGTH)))
+
+        context_key = words(blake3(key_pattern(41), BLAKE3_IV, DERIVE_KEY_CONTEXT, 32))
+        ret.append(BlakeTest(2, 41, ll, blake3(data, context_key, DERIVE_KEY_MATERIAL, OUTPUT_LENGTH)))
+
+    return ret
+
+
+def run():
+    if len(sys.argv) < 2:
+        raise RuntimeError('Hash name is not specified')
+
+    hash_name = sys.argv[1]
+    match hash_name:
+        case 'blake2s': tests = generate_blake2s()
+        case 'blake3': tests = generate_blake3()
+        case _: raise RuntimeError('Unknown hash name: %s' % hash_name)
+
+    out = sys.stdout
+    close_out = False
+    if len(sys.argv) > 2:
+        out = open(sys.argv[2], 'w', encoding='utf8')
+        close_out = True
+
+    out.write('#include <hash/hash_test.hpp>\n')
+
+    out.write('\nconst blake_test_sample * const %s_samples[] = {\n' % hash_name)
+    for t in tests:
+        out.write('  (const blake_test_sample []) {{\n')
+        out.write('    .mode = %d,\n' % t.mode)
+        out.write('    .keyLength = %d,\n' % t.key_len)
+        out.write('    .length = %d,\n' % t.data_len)
+        out.write('    .outputLength = %d,\n' % len(t.output))
+        out.write('    .output = {\n')
+        print_buffer(t.output, out, prefix='      ', bytes_per_line=16)
+        out.write('    }\n')
+        out.write('  }},\n')
+
+    out.write('  nullptr\n};\n')
+
+    if close_out:
+        out.close()
+
+
+if __name__ == '__main__':
+    run()
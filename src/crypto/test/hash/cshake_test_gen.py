@@ -0,0 +1,143 @@
+import sys
+from typing import NamedTuple, List
+from Crypto.Hash import cSHAKE128, cSHAKE256, SHAKE128, SHAKE256, TupleHash128, TupleHash256
+
+from testgen.utils import print_buffer
+
+
+class CSHAKETest(NamedTuple):
+    variant: int
+    name_len: int
+    custom_len: int
+    data_len: int
+    param: int          # number of tuple elements for TupleHash, block size for ParallelHash
+    output_len: int     # zero for XOF variants
+    output: bytes
+
+
+OUTPUT_LENGTH = 128
+CSHAKE = (cSHAKE128, cSHAKE256)
+SHAKE = (SHAKE128, SHAKE256)
+
+
+def pattern(length: int) -> bytes:
+    return bytes(i % 251 for i in range(length))
+
+
+def left_encode(x: int) -> bytes:
+    n = max(1, (x.bit_length() + 7) // 8)
+    return bytes([n]) + x.to_bytes(n, 'big')
+
+
+def right_encode(x: int) -> bytes:
+    n = max(1, (x.bit_length() + 7) // 8)
+    return x.to_bytes(n, 'big') + bytes([n])
+
+
+def encode_string(s: bytes) -> bytes:
+    return left_encode(len(s) * 8) + s
+
+
+def tuple_elements(data: bytes, count: int) -> List[bytes]:
+    return [data[len(data) * i // count:len(data) * (i + 1) // count] for i in range(count)]
+
+
+def tuplehash(variant: int, elements: List[bytes], custom: bytes, output_len: int) -> bytes:
+    if output_len != 0:
+        h = (TupleHash128, TupleHash256)[variant].new(digest_bytes=output_len, custom=custom)
+        for e in elements:
+            h.update(e)
+        return h.digest()
+
+    data = b''.join(encode_string(e) for e in elements) + right_encode(0)
+    return CSHAKE[variant]._new(data, custom, b'TupleHash').read(OUTPUT_LENGTH)
+
+
+def parallelhash(variant: int, data: bytes, block_size: int, custom: bytes, output_len: int) -> bytes:
+    cv_len = 32 << variant
+    blocks = [data[i:i + block_size] for i in range(0, len(data), block_size)]
+
+    z = left_encode(block_size)
+    z += b''.join(SHAKE[variant].new(b).read(cv_len) for b in blocks)
+    z += right_encode(len(blocks)) + right_encode(output_len * 8)
+
+    return CSHAKE[variant]._new(z, custom, b'ParallelHash').read(output_len or OUTPUT_LENGTH)
+
+
+def generate_cshake() -> List[CSHAKETest]:
+    ret = []
+    for variant in (0, 1):
+        for name_len, custom_len in ((0, 0), (1, 0), (0, 1), (12, 41), (200, 3)):
+            for ll in (0, 1, 135, 136, 168, 169, 1000, 5000):
+                h = CSHAKE[variant]._new(pattern(ll), pattern(custom_len), pattern(name_len))
+                ret.append(CSHAKETest(variant, name_len, custom_len, ll, 0, 0, h.read(OUTPUT_LENGTH)))
+
+    return ret
+
+
+def generate_tuplehash() -> List[CSHAKETest]:
+    ret = []
+    for variant in (0, 1):
+        for custom_len in (0, 29):
+            for output_len in (32, 64, 0):
+                for ll, count in ((0, 0), (0, 1), (0, 3), (5, 1), (5, 3), (300, 2), (300, 7), (4000, 13)):
+                    out = tuplehash(variant, tuple_elements(pattern(ll), count), pattern(custom_len), output_len)
+                    ret.append(CSHAKETest(variant, 0, custom_len, ll, count, output_len, out))
+
+    return ret
+
+
+def generate_parallelhash() -> List[CSHAKETest]:
+    ret = []
+    for variant in (0, 1):
+        for custom_len in (0, 29):
+            for output_len in (32, 64, 0):
+                for block_size in (1, 8, 168, 1000, 8192):
+                    for ll in (0, 1, 100, 2 * block_size, 9 * block_size + 7, 70000):
+                        out = parallelhash(variant, pattern(ll), block_size, pattern(custom_len), output_len)
+                        ret.append(CSHAKETest(variant, 0, custom_len, ll, block_size, output_len, out))
+
+    return ret
+
+
+def run():
+    if len(sys.argv) < 2:
+        raise RuntimeError('Function name is not specified')
+
+    fn_name = sys.argv[1]
+    match fn_name:
+        case 'cshake': tests = generate_cshake()
+        case 'tuplehash': tests = generate_tuplehash()
+        case 'parallelhash': tests = generate_parallelhash()
+        case _: raise RuntimeError('Unknown function name: %s' % fn_name)
+
+    out = sys.stdout
+    close_out = False
+    if len(sys.argv) > 2:
+        out = open(sys.argv[2], 'w', encoding='utf8')
+        close_out = True
+
+    out.write('#include <hash/hash_test.hpp>\n')
+
+    out.write('\nconst cshake_test_sample * const %s_samples[] = {\n' % fn_name)
+    for t in tests:
+        out.write('  (const cshake_test_sample []) {{\n')
+        out.write('    .variant = %d,\n' % t.variant)
+        out.write('    .nameLength = %d,\n' % t.name_len)
+        out.write('    .customLength = %d,\n' % t.custom_len)
+        out.write('    .length = %d,\n' % t.data_len)
+        out.write('    .param = %d,\n' % t.param)
+        out.write('    .outputLength = %d,\n' % t.output_len)
+        out.write('    .output = {\n')
+        print_buffer(t.output, out, prefix='      ', bytes_per_line=16)
+        out.write('    }\n')
+        out.write('  }},\n')
+
+    out.write('  nullptr\n};\n')
+
+    if close_out:
+        out.close()
+
+
+if __name__ == '__main__':
+    run()
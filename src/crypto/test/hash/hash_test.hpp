@@ -12,6 +12,54 @@ struct hash_test_sample {
     size_t  digestLen;
 };
 
+/**
+ * Extendable output function test, message and customization string are `i % 251` byte patterns. Fixed-length hash
+ * functions sharing the sponge (i.e. Ascon-Hash256) use only the beginning of the output.
+ */
+struct xof_test_sample {
+    uint32_t variant;
+    uint8_t  domain;
+    size_t   length;
+    size_t   customLength;
+    uint8_t  output[200];
+};
+
+/**
+ * SP 800-185 function test, message, function name and customization string are `i % 251` byte patterns. Parameter
+ * is a number of tuple elements for TupleHash (message is split evenly) and block size for ParallelHash.
+ */
+struct cshake_test_sample {
+    uint32_t variant;
+    size_t   nameLength;
+    size_t   customLength;
+    size_t   length;
+    size_t   param;
+    size_t   outputLength;
+    uint8_t  output[128];
+};
+
+/** Merkle tree hash test, message is `i % 251` byte pattern, proof is given for leaf number `index` */
+struct tree_test_sample {
+    size_t   leafSize;
+    size_t   length;
+    uint8_t  root[32];
+    size_t   index;
+    size_t   proofLength;
+    uint8_t  proof[20 * 32];
+};
+
+/**
+ * BLAKE2s and BLAKE3 test, message is `i % 251` byte pattern, key and BLAKE3 key derivation context are
+ * `(i * 7 + 1) % 256` byte patterns. Mode is 0 for plain hash, 1 for keyed hash and 2 for key derivation.
+ */
+struct blake_test_sample {
+    uint32_t mode;
+    size_t   keyLength;
+    size_t   length;
+    size_t   outputLength;
+    uint8_t  output[131];
+};
+
 extern const uint8_t sha256_buffer[];
 extern const hash_test_sample * const sha256_samples[];
 
@@ -30,6 +78,19 @@ extern const hash_test_sample * const shake_128_samples[];
 extern const uint8_t shake_256_buffer[];
 extern const hash_test_sample * const shake_256_samples[];
 
+extern const xof_test_sample * const turboshake_samples[];
+extern const xof_test_sample * const kangarootwelve_samples[];
+extern const xof_test_sample * const ascon_samples[];
+
+extern const tree_test_sample * const sha256_tree_samples[];
+
+extern const blake_test_sample * const blake2s_samples[];
+extern const blake_test_sample * const blake3_samples[];
+
+extern const cshake_test_sample * const cshake_samples[];
+extern const cshake_test_sample * const tuplehash_samples[];
+extern const cshake_test_sample * const parallelhash_samples[];
+
 template <typename hash>
 int runHashTests(const char *name, const uint8_t *buffer, const hash_test_sample * const * samples) {
     hash ctx;
@@ -53,4 +114,95 @@ int runHashTests(const char *name, const uint8_t *buffer, const hash_test_sample
     return 0;
 }
 
+/** Same as runHashTests, but feeds message in irregular chunks to exercise partial and multi-block updates */
+template <typename hash>
+int runChunkedHashTests(const char *name, const uint8_t *buffer, const hash_test_sample * const * samples) {
+    static const size_t chunks[] = { 1, 3, 64, 17, 200, 128, 5, 1000 };
+
+    hash ctx;
+    uint8_t digest[hash::OUTPUT];
+
+    size_t i = 0;
+    for (; samples[i] != nullptr; i++) {
+        const hash_test_sample *s = samples[i];
+
+        ctx.reset();
+        for (size_t offset = 0, c = 0; offset < s->length; c++) {
+            size_t len = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+            len = len < s->length - offset ? len : s->length - offset;
+
+            ctx.update(buffer + offset, len);
+            offset += len;
+        }
+        ctx.finish(digest);
+
+        if (memcmp(digest, s->digest, hash::OUTPUT) != 0) {
+            fprintf(stderr, "%s chunked test failure on length %zd\n", name, s->length);
+            return 1;
+        }
+    }
+
+    printf("%s chunked test ok: %zd samples\n", name, i);
+    return 0;
+}
+
+/**
+ * Hash message prefix, export midstate and finish hashing in a fresh context restored from it. Context `ctx` must be
+ * configured for hashing with `digestLength` output (same as digest length of test samples).
+ */
+template <typename hash>
+int runResumedHashTests(const char *name, const uint8_t *buffer, const hash_test_sample * const * samples, hash &ctx,
+                        size_t digestLength)
+{
+    uint8_t state[hash::STATE_LENGTH];
+    uint8_t digest[512];
+
+    size_t i = 0;
+    for (; samples[i] != nullptr; i++) {
+        const hash_test_sample *s = samples[i];
+
+        const size_t splits[] = { s->length / 3, s->length / 2, s->length - (s->length != 0) };
+
+        for (size_t split : splits) {
+            ctx.reset();
+            ctx.update(buffer, split);
+
+            size_t length = ctx.exportState(state);
+            if (length > sizeof(state)) {
+                fprintf(stderr, "%s exported state is too long on length %zd\n", name, s->length);
+                return 1;
+            }
+
+            hash resumed;
+            if (resumed.importState(state, length - 1) || resumed.importState(state, length + 1)) {
+                fprintf(stderr, "%s truncated state import succeeded on length %zd\n", name, s->length);
+                return 1;
+            }
+
+            state[0]++; // unknown format version
+            if (resumed.importState(state, length)) {
+                fprintf(stderr, "%s unknown state version import succeeded on length %zd\n", name, s->length);
+                return 1;
+            }
+
+            state[0]--;
+            if (!resumed.importState(state, length)) {
+                fprintf(stderr, "%s state import failed on length %zd\n", name, s->length);
+                return 1;
+            }
+
+            resumed.update(buffer + split, s->length - split);
+            resumed.finish(digest);
+
+            if (memcmp(digest, s->digest, digestLength) != 0) {
+                fprintf(stderr, "%s resumed test failure on length %zd\n", name, s->length);
+                return 1;
+            }
+        }
+    }
+
+    printf("%s resumed test ok: %zd samples\n", name, i);
+    return 0;
+}
+
 #endif // UB_TEST_CRYPTO_HASH_TEST_H
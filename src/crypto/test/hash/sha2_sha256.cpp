@@ -1,8 +1,35 @@
 #include "hash_test.hpp"
 #include <ub/crypto/sha2.hpp>
+#include <hash/sha2_common.hpp>
 
 using ub::crypto::sha256;
+using namespace ub::crypto::impl;
 
 int main() {
-    return runHashTests<sha256>("sha256", sha256_buffer, sha256_samples);
+    if (runHashTests<sha256>("sha256", sha256_buffer, sha256_samples) != 0) {
+        return 1;
+    }
+
+    if (runChunkedHashTests<sha256>("sha256", sha256_buffer, sha256_samples) != 0) {
+        return 1;
+    }
+
+    sha256 ctx;
+    if (runResumedHashTests<sha256>("sha256", sha256_buffer, sha256_samples, ctx, sha256::OUTPUT) != 0) {
+        return 1;
+    }
+
+#if UB_CRYPTO_SHA2_DISPATCH
+    // cross-check portable implementation against the same vectors
+    cpuRestrictFeatures(0);
+    sha2ResetBackends();
+
+    if (runHashTests<sha256>("sha256 (portable)", sha256_buffer, sha256_samples) != 0) {
+        return 1;
+    }
+
+    return runChunkedHashTests<sha256>("sha256 (portable)", sha256_buffer, sha256_samples);
+#else
+    return 0;
+#endif
 }
@@ -0,0 +1,75 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/sha2.hpp>
+#include <cpu.hpp>
+
+#include <cstdlib>
+
+using namespace ub::crypto;
+
+static constexpr size_t MAX_SAMPLES = 512;
+
+static size_t sampleCount() {
+    size_t n = 0;
+    while (sha256_samples[n] != nullptr) {
+        n++;
+    }
+
+    return n;
+}
+
+// hash samples [start, start+count) as a single batch
+static void testBatch(size_t start, size_t count) {
+    static uint8_t digests[MAX_SAMPLES][sha256::OUTPUT];
+
+    uint8_t *digestPtrs[MAX_SAMPLES] {};
+    const uint8_t *messages[MAX_SAMPLES] {};
+    size_t lengths[MAX_SAMPLES] {};
+
+    for (size_t i = 0; i < count; i++) {
+        digestPtrs[i] = digests[i];
+        messages[i] = sha256_buffer;
+        lengths[i] = sha256_samples[start + i]->length;
+    }
+
+    sha256_multi::hash(digestPtrs, messages, lengths, count);
+
+    for (size_t i = 0; i < count; i++) {
+        const hash_test_sample *s = sha256_samples[start + i];
+
+        if (memcmp(digests[i], s->digest, sha256::OUTPUT) != 0) {
+            fprintf(stderr, "sha256_multi test failure on length %zd (batch %zd+%zd)\n", s->length, start, count);
+            exit(1);
+        }
+    }
+}
+
+static void testAll(const char *backend) {
+    size_t n = sampleCount();
+
+    // whole sample set at once, lanes are refilled with messages of varying length
+    testBatch(0, n);
+
+    // batches of every size up to twice the widest lane count
+    for (size_t count = 1; count <= 2 * sha256_multi::MAX_LANES; count++) {
+        for (size_t start = 0; start + count <= n; start += 37) {
+            testBatch(start, count);
+        }
+    }
+
+    printf("sha256_multi (%s) test ok: %zd samples\n", backend, n);
+}
+
+int main() {
+    if (sampleCount() > MAX_SAMPLES) {
+        fprintf(stderr, "too many samples\n");
+        return 1;
+    }
+
+    testAll("native");
+
+    ub::crypto::impl::cpuRestrictFeatures(0);
+    testAll("generic");
+
+    return 0;
+}
@@ -1,8 +1,35 @@
 #include "hash_test.hpp"
 #include <ub/crypto/sha2.hpp>
+#include <hash/sha2_common.hpp>
 
 using ub::crypto::sha512;
+using namespace ub::crypto::impl;
 
 int main() {
-    return runHashTests<sha512>("sha512", sha512_buffer, sha512_samples);
+    if (runHashTests<sha512>("sha512", sha512_buffer, sha512_samples) != 0) {
+        return 1;
+    }
+
+    if (runChunkedHashTests<sha512>("sha512", sha512_buffer, sha512_samples) != 0) {
+        return 1;
+    }
+
+    sha512 ctx;
+    if (runResumedHashTests<sha512>("sha512", sha512_buffer, sha512_samples, ctx, sha512::OUTPUT) != 0) {
+        return 1;
+    }
+
+#if UB_CRYPTO_SHA2_DISPATCH
+    // cross-check portable implementation against the same vectors
+    cpuRestrictFeatures(0);
+    sha2ResetBackends();
+
+    if (runHashTests<sha512>("sha512 (portable)", sha512_buffer, sha512_samples) != 0) {
+        return 1;
+    }
+
+    return runChunkedHashTests<sha512>("sha512 (portable)", sha512_buffer, sha512_samples);
+#else
+    return 0;
+#endif
 }
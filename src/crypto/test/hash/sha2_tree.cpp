@@ -0,0 +1,123 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/sha2.hpp>
+#include <ub/crypto/utility.hpp>
+#include <hash/sha2_common.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static const size_t chunks[] = { 1, 4095, 3, 70000, 64, 1000, 17, 4096 };
+
+static std::vector<uint8_t> message(7 * 65536);
+
+static void fail(const char *name, const char *what, size_t i) {
+    fprintf(stderr, "%s %s failure on sample %zd\n", name, what, i);
+    exit(1);
+}
+
+static void runTests(const char *name) {
+    uint8_t root[sha256_tree::OUTPUT];
+    uint8_t proof[sha256_tree::MAX_PROOF];
+
+    size_t i = 0;
+    for (; sha256_tree_samples[i] != nullptr; i++) {
+        const tree_test_sample *t = sha256_tree_samples[i];
+        sha256_tree ctx(t->leafSize);
+
+        ctx.update(message.data(), t->length);
+        ctx.finish(root);
+
+        if (memcmp(root, t->root, sizeof(root)) != 0) {
+            fail(name, "root", i);
+        }
+
+        for (size_t offset = 0, c = 0; offset < t->length; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->length - offset);
+            ctx.update(message.data() + offset, len);
+            offset += len;
+        }
+
+        ctx.finish(root);
+        if (memcmp(root, t->root, sizeof(root)) != 0) {
+            fail(name, "chunked root", i);
+        }
+
+        size_t count = (t->length + t->leafSize - 1) / t->leafSize;
+        if (count == 0) {
+            continue;
+        }
+
+        std::vector<uint8_t> digests(count * sha256_tree::OUTPUT);
+        sha256_tree::hashLeaves(t->leafSize, message.data(), t->length, digests.data());
+
+        size_t proofLength = sha256_tree::buildProof(digests.data(), count, t->index, proof);
+        if (proofLength != t->proofLength || memcmp(proof, t->proof, proofLength) != 0) {
+            fail(name, "proof", i);
+        }
+
+        // every leaf of small trees must be verifiable with its own proof only
+        for (size_t index = 0; index < count && index < 40; index++) {
+            const uint8_t *leaf = message.data() + index * t->leafSize;
+            size_t leafLength = std::min(t->leafSize, t->length - index * t->leafSize);
+
+            proofLength = sha256_tree::buildProof(digests.data(), count, index, proof);
+            if (!sha256_tree::verifyLeaf(t->root, count, index, leaf, leafLength, proof, proofLength)) {
+                fail(name, "leaf verification", i);
+            }
+
+            if (count > 1 && sha256_tree::verifyLeaf(t->root, count, (index + 1) % count, leaf, leafLength, proof,
+                                                     proofLength)) {
+                fail(name, "wrong index verification", i);
+            }
+
+            if (proofLength != 0) {
+                proof[proofLength / 2] ^= 1;
+                if (sha256_tree::verifyLeaf(t->root, count, index, leaf, leafLength, proof, proofLength)) {
+                    fail(name, "tampered proof verification", i);
+                }
+            }
+
+            if (sha256_tree::verifyLeaf(t->root, count, index, leaf, leafLength - 1, proof, proofLength)) {
+                fail(name, "truncated leaf verification", i);
+            }
+        }
+    }
+
+    // zero leaf size is treated as one byte
+    uint8_t expected[sha256_tree::OUTPUT];
+    sha256_tree one(1), zero(0);
+    one.update(message.data(), 1000);
+    one.finish(expected);
+    zero.update(message.data(), 1000);
+    zero.finish(root);
+
+    if (memcmp(root, expected, sizeof(root)) != 0) {
+        fail(name, "zero leaf size", i);
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    setMaxThreads(1);
+    runTests("sha256_tree");
+
+    setMaxThreads(4);
+    runTests("sha256_tree (4 threads)");
+
+#if UB_CRYPTO_SHA2_DISPATCH
+    cpuRestrictFeatures(0);
+    sha2ResetBackends();
+    runTests("sha256_tree (portable)");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/cshake.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+
+static std::vector<uint8_t> message(5000);
+
+static void testCSHAKE() {
+    cshake ctx;
+    uint8_t output[sizeof(cshake_test_sample::output)];
+
+    size_t i = 0;
+    for (; cshake_samples[i] != nullptr; i++) {
+        const cshake_test_sample *t = cshake_samples[i];
+
+        ctx.init(t->variant, message.data(), t->nameLength, message.data(), t->customLength);
+        ctx.update(message.data(), t->length / 3);
+        ctx.update(message.data() + t->length / 3, t->length - t->length / 3);
+        ctx.generate(output, 7);
+        ctx.generate(output + 7, sizeof(output) - 7);
+
+        if (memcmp(output, t->output, sizeof(output)) != 0) {
+            fprintf(stderr, "cshake test failure on sample %zd\n", i);
+            exit(1);
+        }
+    }
+
+    printf("cshake test ok: %zd samples\n", i);
+}
+
+static void testTupleHash() {
+    tuplehash ctx;
+    uint8_t output[sizeof(cshake_test_sample::output)];
+
+    size_t i = 0;
+    for (; tuplehash_samples[i] != nullptr; i++) {
+        const cshake_test_sample *t = tuplehash_samples[i];
+
+        ctx.init(t->variant, message.data(), t->customLength, t->outputLength);
+        for (size_t e = 0; e < t->param; e++) {
+            size_t begin = t->length * e / t->param;
+            size_t end = t->length * (e + 1) / t->param;
+            ctx.add(message.data() + begin, end - begin);
+        }
+
+        size_t outputLength = t->outputLength;
+        if (outputLength != 0) {
+            ctx.finish(output);
+        } else {
+            outputLength = sizeof(output);
+            ctx.generate(output, outputLength);
+        }
+
+        if (memcmp(output, t->output, outputLength) != 0) {
+            fprintf(stderr, "tuplehash test failure on sample %zd\n", i);
+            exit(1);
+        }
+    }
+
+    printf("tuplehash test ok: %zd samples\n", i);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    testCSHAKE();
+    testTupleHash();
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/kangarootwelve.hpp>
+#include <ub/crypto/utility.hpp>
+#include <cpu.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+
+static const size_t chunks[] = { 1, 8191, 3, 16384, 168, 40000, 17, 8192 };
+
+static std::vector<uint8_t> message(100000);
+
+static void runTests(const char *name) {
+    kangarootwelve ctx;
+    uint8_t output[sizeof(xof_test_sample::output)];
+
+    size_t i = 0;
+    for (; kangarootwelve_samples[i] != nullptr; i++) {
+        const xof_test_sample *t = kangarootwelve_samples[i];
+
+        ctx.reset();
+        ctx.update(message.data(), t->length);
+        ctx.finish(message.data(), t->customLength);
+        ctx.generate(output, sizeof(output));
+
+        if (memcmp(output, t->output, sizeof(output)) != 0) {
+            fprintf(stderr, "%s test failure on sample %zd\n", name, i);
+            exit(1);
+        }
+
+        ctx.reset();
+        for (size_t offset = 0, c = 0; offset < t->length; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->length - offset);
+            ctx.update(message.data() + offset, len);
+            offset += len;
+        }
+
+        if (t->customLength == 0) {
+            ctx.generate(output, 1); // implicit finish with empty customization string
+            ctx.generate(output + 1, sizeof(output) - 1);
+        } else {
+            ctx.finish(message.data(), t->customLength);
+            ctx.generate(output, sizeof(output));
+        }
+
+        if (memcmp(output, t->output, sizeof(output)) != 0) {
+            fprintf(stderr, "%s chunked test failure on sample %zd\n", name, i);
+            exit(1);
+        }
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    setMaxThreads(1);
+    runTests("kangarootwelve");
+
+    setMaxThreads(4);
+    runTests("kangarootwelve (4 threads)");
+
+    ub::crypto::impl::cpuRestrictFeatures(0);
+    runTests("kangarootwelve (generic)");
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <ub/crypto/sha3.hpp>
+#include <hash/sha3_common.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+int main() {
+    // Keccak-f[1600] applied to all-zero state, first lane of the result
+    keccak1600 k {};
+    k.rate = 8;
+    k.apply(k.st);
+
+    uint8_t lane[8];
+    k.produce(lane, sizeof(lane));
+
+    static const uint8_t expected[] = { 0xE7, 0xDD, 0xE1, 0x40, 0x79, 0x8F, 0x25, 0xF1 };
+    if (std::memcmp(lane, expected, sizeof(lane)) != 0) {
+        fprintf(stderr, "keccak1600 test failure on zero state\n");
+        return 1;
+    }
+
+#if UB_CRYPTO_KECCAK64
+    // cross-check 64-bit permutation against bit-interleaved one on a chain of pseudo-random states
+    keccak1600::state_t a {}, b {};
+    uint32_t x = 0x12345678;
+    for (size_t i = 0; i < 100; i++) {
+        for (uint32_t &w : a.u32) {
+            x = x * 1103515245 + 12345;
+            w ^= x;
+        }
+
+        for (size_t j = 0; j < 25; j++) {
+            uint64_t lane;
+            std::memcpy(&lane, a.u8 + 8 * j, sizeof(lane));
+            keccak1600Interleave(b.u32 + 2 * j, lane);
+
+            if (keccak1600Deinterleave(b.u32 + 2 * j) != lane) {
+                fprintf(stderr, "keccak1600 interleaving failure on state %zd\n", i);
+                return 1;
+            }
+        }
+
+        // full permutation, as well as reduced-round even and odd variants
+        static const uint32_t rounds[] = { keccak1600::ROUNDS, 12, 11, 1 };
+        uint32_t r = rounds[i % 4];
+
+        keccak1600x4::state_t c;
+        for (size_t j = 0; j < 25; j++) {
+            for (size_t l = 0; l < keccak1600x4::LANES; l++) {
+                std::memcpy(&c.u64[j * keccak1600x4::LANES + l], a.u8 + 8 * j, sizeof(uint64_t));
+            }
+        }
+
+        keccak1600Permute32(b, r);
+        keccak1600Permute64(a, r);
+        keccak1600x4::apply(c, r);
+
+        for (size_t j = 0; j < 25; j++) {
+            uint64_t lane = keccak1600Deinterleave(b.u32 + 2 * j);
+            std::memcpy(b.u8 + 8 * j, &lane, sizeof(lane));
+        }
+
+        if (std::memcmp(a.u8, b.u8, keccak1600::LENGTH) != 0) {
+            fprintf(stderr, "keccak1600 test failure on state %zd\n", i);
+            return 1;
+        }
+
+        for (size_t j = 0; j < 25; j++) {
+            for (size_t l = 0; l < keccak1600x4::LANES; l++) {
+                if (std::memcmp(&c.u64[j * keccak1600x4::LANES + l], a.u8 + 8 * j, sizeof(uint64_t)) != 0) {
+                    fprintf(stderr, "keccak1600x4 test failure on state %zd\n", i);
+                    return 1;
+                }
+            }
+        }
+    }
+
+#endif
+
+    printf("keccak1600 test ok\n");
+    return 0;
+}
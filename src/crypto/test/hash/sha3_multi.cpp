@@ -0,0 +1,108 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/sha3.hpp>
+#include <ub/crypto/kmac.hpp>
+#include <cpu.hpp>
+
+#include <cstdlib>
+
+using namespace ub::crypto;
+
+static constexpr size_t MAX_BATCH = 19;
+static constexpr size_t MAX_OUTPUT = 600;
+
+/** Batch of messages with varying offsets and lengths taken from the shared test buffer */
+struct test_batch {
+    const uint8_t   *messages[MAX_BATCH];
+    size_t          lengths[MAX_BATCH];
+    const uint8_t   *keys[MAX_BATCH];
+    size_t          keyLengths[MAX_BATCH];
+    uint8_t         *outputs[MAX_BATCH];
+    uint8_t         output[MAX_BATCH][MAX_OUTPUT];
+    uint8_t         expected[MAX_OUTPUT];
+};
+
+static void fillBatch(test_batch &b, size_t count, size_t seed) {
+    for (size_t i = 0; i < count; i++) {
+        size_t x = (seed + 1) * 7919 + i * 104729;
+
+        b.messages[i] = sha3_256_buffer + x % 61;
+        b.lengths[i] = (x >> 3) % (seed % 3 == 0 ? 40 : 1500);
+        b.keys[i] = sha3_512_buffer + x % 17;
+        b.keyLengths[i] = (x >> 5) % 200;
+        b.outputs[i] = b.output[i];
+    }
+}
+
+static void check(const char *name, const test_batch &b, size_t i, size_t length) {
+    if (memcmp(b.output[i], b.expected, length) != 0) {
+        fprintf(stderr, "%s test failure on message length %zd\n", name, b.lengths[i]);
+        exit(1);
+    }
+}
+
+static void testSHA3(test_batch &b, size_t count, uint32_t digestLength) {
+    sha3_multi::hash(digestLength, b.outputs, b.messages, b.lengths, count);
+
+    sha3 ctx;
+    for (size_t i = 0; i < count; i++) {
+        ctx.reset(digestLength);
+        ctx.update(b.messages[i], b.lengths[i]);
+        ctx.finish(b.expected);
+
+        check("sha3_multi", b, i, digestLength);
+    }
+}
+
+static void testSHAKE(test_batch &b, size_t count, uint32_t variant, size_t outputLength) {
+    shake_multi::generate(variant, b.outputs, outputLength, b.messages, b.lengths, count);
+
+    shake ctx;
+    for (size_t i = 0; i < count; i++) {
+        ctx.reset(variant);
+        ctx.update(b.messages[i], b.lengths[i]);
+        ctx.generate(b.expected, outputLength);
+
+        check("shake_multi", b, i, outputLength);
+    }
+}
+
+static void testKMAC(test_batch &b, size_t count, uint32_t variant, size_t macLength) {
+    kmac_multi::compute(variant, b.outputs, macLength, b.keys, b.keyLengths, b.messages, b.lengths, count);
+
+    kmac ctx;
+    for (size_t i = 0; i < count; i++) {
+        ctx.init(variant, b.keys[i], b.keyLengths[i], macLength);
+        ctx.update(b.messages[i], b.lengths[i]);
+        ctx.finish(b.expected);
+
+        check("kmac_multi", b, i, macLength);
+    }
+}
+
+static void testAll(const char *backend) {
+    static test_batch b;
+
+    for (size_t count = 1; count <= MAX_BATCH; count++) {
+        fillBatch(b, count, count);
+
+        testSHA3(b, count, sha3::DIGEST_256);
+        testSHA3(b, count, sha3::DIGEST_512);
+        testSHA3(b, count, 33);
+        testSHAKE(b, count, shake::FN_SHAKE128, 32);
+        testSHAKE(b, count, shake::FN_SHAKE256, MAX_OUTPUT);
+        testKMAC(b, count, kmac::KMAC_128, 32);
+        testKMAC(b, count, kmac::KMAC_256, 300);
+    }
+
+    printf("sha3_multi (%s) test ok\n", backend);
+}
+
+int main() {
+    testAll("native");
+
+    ub::crypto::impl::cpuRestrictFeatures(0);
+    testAll("generic");
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/cshake.hpp>
+#include <ub/crypto/utility.hpp>
+#include <cpu.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+
+static const size_t chunks[] = { 1, 8191, 3, 16384, 168, 40000, 17, 8192 };
+
+static std::vector<uint8_t> message(100000);
+
+static void runTests(const char *name) {
+    parallelhash ctx;
+    uint8_t output[sizeof(cshake_test_sample::output)];
+
+    size_t i = 0;
+    for (; parallelhash_samples[i] != nullptr; i++) {
+        const cshake_test_sample *t = parallelhash_samples[i];
+        size_t outputLength = t->outputLength != 0 ? t->outputLength : sizeof(output);
+
+        for (bool chunked : { false, true }) {
+            ctx.init(t->variant, t->param, message.data(), t->customLength, t->outputLength);
+
+            for (size_t offset = 0, c = 0; offset < t->length; c++) {
+                size_t len = chunked ? std::min(chunks[c % std::size(chunks)], t->length - offset) : t->length;
+                ctx.update(message.data() + offset, len);
+                offset += len;
+            }
+
+            if (t->outputLength != 0) {
+                ctx.finish(output);
+            } else {
+                ctx.generate(output, 1);
+                ctx.generate(output + 1, outputLength - 1);
+            }
+
+            if (memcmp(output, t->output, outputLength) != 0) {
+                fprintf(stderr, "%s%s test failure on sample %zd\n", name, chunked ? " chunked" : "", i);
+                exit(1);
+            }
+        }
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+int main() {
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    // data passed before initialization is ignored
+    parallelhash uninitialized;
+    uninitialized.update(message.data(), message.size());
+
+    setMaxThreads(1);
+    runTests("parallelhash");
+
+    setMaxThreads(4);
+    runTests("parallelhash (4 threads)");
+
+    ub::crypto::impl::cpuRestrictFeatures(0);
+    runTests("parallelhash (generic)");
+
+    return 0;
+}
@@ -37,5 +37,11 @@ int main() {
         }
     }
 
-    return 0;
+    ctx.reset(sha3::DIGEST_256);
+    if (runResumedHashTests<sha3>("sha3_256", sha3_256_buffer, sha3_256_samples, ctx, sha3::DIGEST_256) != 0) {
+        return 1;
+    }
+
+    ctx.reset(sha3::DIGEST_512);
+    return runResumedHashTests<sha3>("sha3_512", sha3_512_buffer, sha3_512_samples, ctx, sha3::DIGEST_512);
 }
@@ -0,0 +1,56 @@
+#include "hash_test.hpp"
+
+#include <ub/crypto/sha3.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace ub::crypto;
+
+static const size_t chunks[] = { 1, 3, 168, 17, 200, 136, 5, 1000 };
+
+int main() {
+    std::vector<uint8_t> message(100000);
+    for (size_t i = 0; i < message.size(); i++) {
+        message[i] = i % 251;
+    }
+
+    turboshake ctx;
+    uint8_t output[sizeof(xof_test_sample::output)];
+
+    size_t i = 0;
+    for (; turboshake_samples[i] != nullptr; i++) {
+        const xof_test_sample *t = turboshake_samples[i];
+
+        ctx.reset(t->variant, t->domain);
+        ctx.update(message.data(), t->length);
+        ctx.generate(output, sizeof(output));
+
+        if (memcmp(output, t->output, sizeof(output)) != 0) {
+            fprintf(stderr, "turboshake test failure on sample %zd\n", i);
+            exit(1);
+        }
+
+        // chunked input and output
+        ctx.reset();
+        for (size_t offset = 0, c = 0; offset < t->length; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->length - offset);
+            ctx.update(message.data() + offset, len);
+            offset += len;
+        }
+
+        for (size_t offset = 0, c = 0; offset < sizeof(output); c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], sizeof(output) - offset);
+            ctx.generate(output + offset, len);
+            offset += len;
+        }
+
+        if (memcmp(output, t->output, sizeof(output)) != 0) {
+            fprintf(stderr, "turboshake chunked test failure on sample %zd\n", i);
+            exit(1);
+        }
+    }
+
+    printf("turboshake test ok: %zd samples\n", i);
+    return 0;
+}
@@ -0,0 +1,103 @@
+import sys
+import hashlib
+from typing import NamedTuple, List
+
+from testgen.utils import print_buffer
+
+
+class TreeTest(NamedTuple):
+    leaf_size: int
+    data_len: int
+    root: bytes
+    index: int
+    proof: bytes
+
+
+def pattern(length: int) -> bytes:
+    return bytes(i % 251 for i in range(length))
+
+
+def leaf_hash(leaf: bytes) -> bytes:
+    return hashlib.sha256(b'\x00' + leaf).digest()
+
+
+def node_hash(left: bytes, right: bytes) -> bytes:
+    return hashlib.sha256(b'\x01' + left + right).digest()
+
+
+def split(n: int) -> int:
+    k = 1
+    while k * 2 < n:
+        k *= 2
+    return k
+
+
+# RFC 9162, section 2.1.1
+def mth(leaves: List[bytes]) -> bytes:
+    if len(leaves) == 0:
+        return hashlib.sha256(b'').digest()
+    if len(leaves) == 1:
+        return leaf_hash(leaves[0])
+
+    k = split(len(leaves))
+    return node_hash(mth(leaves[:k]), mth(leaves[k:]))
+
+
+# RFC 9162, section 2.1.3.1
+def path(m: int, leaves: List[bytes]) -> bytes:
+    if len(leaves) <= 1:
+        return b''
+
+    k = split(len(leaves))
+    if m < k:
+        return path(m, leaves[:k]) + mth(leaves[k:])
+    return path(m - k, leaves[k:]) + mth(leaves[:k])
+
+
+def generate_tests() -> List[TreeTest]:
+    ret = []
+    for leaf_size in (1, 64, 1000, 4096, 65536):
+        for ll in (0, 1, leaf_size - 1, leaf_size, leaf_size + 1, 2 * leaf_size, 3 * leaf_size - 1, 7 * leaf_size,
+                   300000):
+            data = pattern(ll)
+            leaves = [data[i:i + leaf_size] for i in range(0, ll, leaf_size)]
+            index = (len(leaves) * 5) // 7
+
+            proof = path(index, leaves) if leaves else b''
+            ret.append(TreeTest(leaf_size, ll, mth(leaves), index, proof))
+
+    return ret
+
+
+def run():
+    out = sys.stdout
+    close_out = False
+    if len(sys.argv) > 1:
+        out = open(sys.argv[1], 'w', encoding='utf8')
+        close_out = True
+
+    out.write('#include <hash/hash_test.hpp>\n')
+
+    out.write('\nconst tree_test_sample * const sha256_tree_samples[] = {\n')
+    for t in generate_tests():
+        out.write('  (const tree_test_sample []) {{\n')
+        out.write('    .leafSize = %d,\n' % t.leaf_size)
+        out.write('    .length = %d,\n' % t.data_len)
+        out.write('    .root = {\n')
+        print_buffer(t.root, out, prefix='      ', bytes_per_line=16)
+        out.write('    },\n')
+        out.write('    .index = %d,\n' % t.index)
+        out.write('    .proofLength = %d,\n' % len(t.proof))
+        out.write('    .proof = {\n')
+        print_buffer(t.proof, out, prefix='      ', bytes_per_line=16)
+        out.write('    }\n')
+        out.write('  }},\n')
+
+    out.write('  nullptr\n};\n')
+
+    if close_out:
+        out.close()
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,99 @@
+import sys
+from typing import NamedTuple, List
+from Crypto.Hash import TurboSHAKE128, TurboSHAKE256, KangarooTwelve
+
+from testgen.utils import print_buffer
+from testgen import ascon_ref
+
+
+class XOFTest(NamedTuple):
+    variant: int
+    domain: int
+    data_len: int
+    custom_len: int
+    output: bytes
+
+
+OUTPUT_LENGTH = 200
+LENGTHS = [0, 1, 7, 135, 136, 167, 168, 169, 1000, 8191, 8192, 8193, 8192 + 168, 16383, 16384, 16385,
+           3 * 8192 + 1, 5 * 8192 - 17, 100000]
+
+
+def pattern(length: int) -> bytes:
+    return bytes(i % 251 for i in range(length))
+
+
+def generate_turboshake() -> List[XOFTest]:
+    ret = []
+    for variant, ctor in ((1, TurboSHAKE128), (2, TurboSHAKE256)):
+        for domain in (0x1F, 0x01, 0x07, 0x0B, 0x06, 0x7F):
+            for ll in LENGTHS:
+                h = ctor.new(domain=domain)
+                h.update(pattern(ll))
+                ret.append(XOFTest(variant, domain, ll, 0, h.read(OUTPUT_LENGTH)))
+
+    return ret
+
+
+def generate_kangarootwelve() -> List[XOFTest]:
+    ret = []
+    for custom_len in (0, 1, 41, 8191, 8200):
+        for ll in LENGTHS:
+            h = KangarooTwelve.new(custom=pattern(custom_len))
+            h.update(pattern(ll))
+            ret.append(XOFTest(0, 0, ll, custom_len, h.read(OUTPUT_LENGTH)))
+
+    return ret
+
+
+ASCON_LENGTHS = [0, 1, 7, 8, 9, 15, 16, 17, 63, 64, 1000, 8193]
+
+
+def generate_ascon() -> List[XOFTest]:
+    ret = []
+    for ll in ASCON_LENGTHS:
+        ret.append(XOFTest(1, 0, ll, 0, ascon_ref.hash256(pattern(ll))))
+        ret.append(XOFTest(2, 0, ll, 0, ascon_ref.xof128(pattern(ll), OUTPUT_LENGTH)))
+
+    return ret
+
+
+def run():
+    if len(sys.argv) < 2:
+        raise RuntimeError('XOF name is not specified')
+
+    xof_name = sys.argv[1]
+    match xof_name:
+        case 'turboshake': tests = generate_turboshake()
+        case 'kangarootwelve': tests = generate_kangarootwelve()
+        case 'ascon': tests = generate_ascon()
+        case _: raise RuntimeError('Unknown XOF name: %s' % xof_name)
+
+    out = sys.stdout
+    close_out = False
+    if len(sys.argv) > 2:
+        out = open(sys.argv[2], 'w', encoding='utf8')
+        close_out = True
+
+    out.write('#include <hash/hash_test.hpp>\n')
+
+    out.write('\nconst xof_test_sample * const %s_samples[] = {\n' % xof_name)
+    for t in tests:
+        out.write('  (const xof_test_sample []) {{\n')
+        out.write('    .variant = %d,\n' % t.variant)
+        out.write('    .domain = 0x%02X,\n' % t.domain)
+        out.write('    .length = %d,\n' % t.data_len)
+        out.write('    .customLength = %d,\n' % t.custom_len)
+        out.write('    .output = {\n')
+        print_buffer(t.output, out, prefix='      ', bytes_per_line=16)
+        out.write('    }\n')
+        out.write('  }},\n')
+
+    out.write('  nullptr\n};\n')
+
+    if close_out:
+        out.close()
+
+
+if __name__ == '__main__':
+    run()
@@ -12,6 +12,7 @@ using namespace ub::crypto;
 template <typename hash>
 static void test(const mac_test * const * tests, const char *name) {
     hmac<hash> ctx;
+    hmac_key<hash> key;
     uint8_t digest[hash::OUTPUT];
 
     for (size_t i = 0; tests[i] != nullptr; i++) {
@@ -25,6 +26,19 @@ static void test(const mac_test * const * tests, const char *name) {
             fprintf(stderr, "hmac<%s> test failed at sample %zd\n", name, i);
             exit(1);
         }
+
+        // prepared key must stay valid for any number of messages
+        key.init(t->k, t->kl);
+        for (size_t r = 0; r < 2; r++) {
+            ctx.init(key);
+            ctx.update(t->data, t->len);
+            ctx.finish(digest);
+
+            if (std::memcmp(digest, t->m, hash::OUTPUT) != 0) {
+                fprintf(stderr, "hmac<%s> prepared key test failed at sample %zd\n", name, i);
+                exit(1);
+            }
+        }
     }
 }
 
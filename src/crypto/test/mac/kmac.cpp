@@ -10,6 +10,7 @@ using namespace ub::crypto;
 
 static void test(uint32_t variant, const mac_test * const * tests, const char *name) {
     kmac ctx;
+    kmac_key key;
 
     for (size_t i = 0; tests[i] != nullptr; i++) {
         const mac_test *t = tests[i];
@@ -24,6 +25,19 @@ static void test(uint32_t variant, const mac_test * const * tests, const char *n
             fprintf(stderr, "%s test failed at sample %zd\n", name, i);
             exit(1);
         }
+
+        // prepared key must stay valid for any number of messages
+        key.init(variant, t->k, t->kl);
+        for (size_t r = 0; r < 2; r++) {
+            ctx.init(key, t->ml);
+            ctx.update(t->data, t->len);
+            ctx.finish(result);
+
+            if (std::memcmp(t->m, result, t->ml) != 0) {
+                fprintf(stderr, "%s prepared key test failed at sample %zd\n", name, i);
+                exit(1);
+            }
+        }
     }
 }
 
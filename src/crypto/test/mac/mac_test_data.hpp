@@ -17,5 +17,7 @@ extern const mac_test * const sha256_mac_tests[];
 extern const mac_test * const sha512_mac_tests[];
 extern const mac_test * const kmac128_mac_tests[];
 extern const mac_test * const kmac256_mac_tests[];
+extern const mac_test * const poly1305_mac_tests[];
+extern const mac_test * const poly1305_edge_mac_tests[];
 
 #endif // UB_TEST_CRYPTO_MAC_TEST_DATA_H
@@ -1,5 +1,5 @@
 import sys
-from typing import NamedTuple, Callable, Any, Optional, List
+from typing import NamedTuple, Callable, Any, Optional, List, Tuple
 from Crypto.Hash import KMAC128, KMAC256, HMAC, SHA256, SHA512
 
 from testgen.utils import random_bytes, print_buffer, random_number
@@ -9,6 +9,77 @@ class MACDefinition(NamedTuple):
     ctor: Callable[[bytes, int], Any]   # (key, mac_len) -> MAC
     mac_length: Optional[int]
     key_length: int
+    max_key_length: int = 256
+
+
+class Poly1305:
+    """ Reference Poly1305 one-time authenticator (RFC 8439, section 2.5) """
+
+    P = (1 << 130) - 5
+
+    def __init__(self, key: bytes):
+        self.r = int.from_bytes(key[:16], 'little') & 0x0FFFFFFC0FFFFFFC0FFFFFFC0FFFFFFF
+        self.s = int.from_bytes(key[16:32], 'little')
+        self.data = b''
+
+    def update(self, data: bytes):
+        self.data += data
+
+    def digest(self) -> bytes:
+        acc = 0
+        for i in range(0, len(self.data), 16):
+            block = self.data[i:i + 16] + b'\x01'
+            acc = (acc + int.from_bytes(block, 'little')) * self.r % self.P
+
+        return ((acc + self.s) % (1 << 128)).to_bytes(16, 'little')
+
+
+def check_poly1305():
+    # RFC 8439, section 2.5.2
+    key = bytes.fromhex('85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b')
+    mac = Poly1305(key)
+    mac.update(b'Cryptographic Forum Research Group')
+    if mac.digest() != bytes.fromhex('a8061dc1305136c6c22b8baf0c0127a9'):
+        raise RuntimeError('Poly1305 reference implementation mismatch')
+
+
+def poly1305_edge_tests() -> List[Tuple[bytes, bytes]]:
+    """ Keys and messages exercising carry propagation and final reduction: RFC 8439 appendix A.3 vectors, checked
+        against their published tags, and all-0xFF messages under maximally clamped `r` and all-0xFF `s` """
+
+    r1, r2 = bytes([1]) + bytes(15), bytes([2]) + bytes(15)
+    r10 = bytes.fromhex('01000000000000000400000000000000')
+    ff = b'\xff' * 16
+    blocks10 = bytes.fromhex('e33594d7505e43b9' + '00' * 8 + '3394d7505e4379cd01' + '00' * 7) + bytes(16)
+
+    rfc = [
+        (bytes(32), bytes(64), bytes(16)),
+        (bytes.fromhex('1c9240a5eb55d38af333888604f6b5f0473917c1402b80099dca5cbc207075c0'),
+         b"'Twas brillig, and the slithy toves\nDid gyre and gimble in the wabe:\n"
+         b"All mimsy were the borogoves,\nAnd the mome raths outgrabe.",
+         bytes.fromhex('4541669a7eaaee61e708dc7cbcc5eb62')),
+        (r2 + bytes(16), ff, bytes([3]) + bytes(15)),
+        (r2 + ff, bytes([2]) + bytes(15), bytes([3]) + bytes(15)),
+        (r1 + bytes(16), ff + bytes([0xf0]) + ff[1:] + bytes([0x11]) + bytes(15), bytes([5]) + bytes(15)),
+        (r1 + bytes(16), ff + bytes([0xfb]) + b'\xfe' * 15 + b'\x01' * 16, bytes(16)),
+        (r2 + bytes(16), bytes([0xfd]) + ff[1:], bytes([0xfa]) + ff[1:]),
+        (r10 + bytes(16), blocks10 + bytes([1]) + bytes(15), bytes.fromhex('14' + '00' * 7 + '55' + '00' * 7)),
+        (r10 + bytes(16), blocks10, bytes([0x13]) + bytes(15)),
+    ]
+
+    ret = []
+    for key, data, tag in rfc:
+        mac = Poly1305(key)
+        mac.update(data)
+        if mac.digest() != tag:
+            raise RuntimeError('Poly1305 reference implementation mismatch')
+
+        ret.append((key, data))
+
+    for length in (16, 63, 64, 256, 1000):
+        ret.append((ff * 2, b'\xff' * length))
+
+    return ret
 
 
 class MACTest(NamedTuple):
@@ -18,7 +89,10 @@ class MACTest(NamedTuple):
 
 
 def generate_test(mac_name: str, mac: MACDefinition, data: bytes) -> MACTest:
-    key_len = mac.key_length + random_number(256 - mac.key_length, f'mac_klen_{mac_name}')
+    key_len = mac.key_length
+    if mac.max_key_length > mac.key_length:
+        key_len += random_number(mac.max_key_length - mac.key_length, f'mac_klen_{mac_name}')
+
     key = random_bytes(key_len, f'mac_key_{mac_name}')
 
     mac_len = mac.mac_length
@@ -48,6 +122,34 @@ def generate_tests(mac_name: str, mac: MACDefinition, data: bytes) -> List[MACTe
     return ret
 
 
+def write_poly1305_edge_tests(out):
+    tests = poly1305_edge_tests()
+
+    for i, (_, data) in enumerate(tests):
+        out.write('\nstatic const uint8_t poly1305_edge_data_%d[] = {\n' % i)
+        print_buffer(data, out, '  ')
+        out.write('};\n')
+
+    out.write('\nconst mac_test * const poly1305_edge_mac_tests[] = {\n')
+    for i, (key, data) in enumerate(tests):
+        mac = Poly1305(key)
+        mac.update(data)
+
+        out.write('  /* %03d */ (const mac_test []) {{\n' % i)
+        out.write('    .data = poly1305_edge_data_%d,\n' % i)
+        out.write('    .len  = %d,\n' % len(data))
+        out.write('    .kl = %d,\n' % len(key))
+        out.write('    .k = {\n')
+        print_buffer(key, out, '      ')
+        out.write('    },\n')
+        out.write('    .ml = 16,\n')
+        out.write('    .m = {\n')
+        print_buffer(mac.digest(), out, '      ')
+        out.write('    }\n')
+        out.write('  }},\n')
+    out.write('  nullptr\n};\n')
+
+
 def run():
     if len(sys.argv) < 2:
         raise RuntimeError('MAC name is not specified')
@@ -58,6 +160,9 @@ def run():
         case 'sha512': mac_defn = MACDefinition(lambda k, _: HMAC.new(k, digestmod=SHA512), SHA512.digest_size, 1)
         case 'kmac128': mac_defn = MACDefinition(lambda k, s: KMAC128.new(key=k, mac_len=s), None, 16)
         case 'kmac256': mac_defn = MACDefinition(lambda k, s: KMAC256.new(key=k, mac_len=s), None, 32)
+        case 'poly1305':
+            check_poly1305()
+            mac_defn = MACDefinition(lambda k, _: Poly1305(k), 16, 32, 32)
         case _: raise RuntimeError('Unknown MAC name: %s' % mac_name)
 
     data_buffer = random_bytes(8192, f'mac_test_data_{mac_name}')
@@ -92,6 +197,9 @@ def run():
         out.write('  }},\n')
     out.write('  nullptr\n};\n')
 
+    if mac_name == 'poly1305':
+        write_poly1305_edge_tests(out)
+
     if close_out:
         out.close()
 
@@ -0,0 +1,75 @@
+#include <ub/crypto/poly1305.hpp>
+#include <cipher/poly1305_common.hpp>
+
+#include "mac_test_data.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+using namespace ub::crypto;
+using namespace ub::crypto::impl;
+
+static const size_t chunks[] = { 1, 15, 3, 16, 300, 64, 17, 1024, 33 };
+
+static void fail(const char *name, const char *what, size_t i) {
+    fprintf(stderr, "%s %s failure on sample %zd\n", name, what, i);
+    exit(1);
+}
+
+static void test(const char *name, const mac_test * const *tests) {
+    poly1305 ctx;
+    uint8_t result[poly1305::TAG_LENGTH];
+
+    size_t i = 0;
+    for (; tests[i] != nullptr; i++) {
+        const mac_test *t = tests[i];
+
+        ctx.init(t->k);
+        ctx.update(t->data, t->len);
+        ctx.finish(result);
+
+        if (std::memcmp(t->m, result, t->ml) != 0) {
+            fail(name, "output", i);
+        }
+
+        ctx.init(t->k);
+        for (size_t offset = 0, c = i; offset < t->len; c++) {
+            size_t len = std::min(chunks[c % std::size(chunks)], t->len - offset);
+            ctx.update(t->data + offset, len);
+            offset += len;
+        }
+
+        ctx.finish(result);
+
+        if (std::memcmp(t->m, result, t->ml) != 0) {
+            fail(name, "chunked", i);
+        }
+    }
+
+    printf("%s test ok: %zd samples\n", name, i);
+}
+
+static void test(const char *name) {
+    test(name, poly1305_mac_tests);
+
+    // RFC 8439 appendix A.3 and other inputs with extreme limb values
+    char edgeName[64];
+    snprintf(edgeName, sizeof(edgeName), "%s edge", name);
+    test(edgeName, poly1305_edge_mac_tests);
+}
+
+int main() {
+    test("poly1305");
+
+    cpuRestrictFeatures(0);
+#if UB_CRYPTO_POLY1305_64
+    test("poly1305 (generic 44-bit)");
+#else
+    test("poly1305 (generic 26-bit)");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,9 @@
+# Worker threads (UB_CRYPTO_THREADS in src/parallel.hpp) are enabled by default on hosted targets and need the
+# platform thread library. Targets without one process everything on the caller's thread instead.
+find_package(Threads)
+
+if (Threads_FOUND)
+    target_link_libraries(ub_crypto INTERFACE Threads::Threads)
+else ()
+    target_compile_definitions(ub_crypto INTERFACE UB_CRYPTO_THREADS=0)
+endif ()
@@ -0,0 +1,109 @@
+# Reference implementation of Ascon-AEAD128, Ascon-Hash256 and Ascon-XOF128 from NIST SP 800-232, written directly
+# from the specification (little-endian byte order, 64-bit words)
+# src: https://doi.org/10.6028/NIST.SP.800-232
+
+from typing import List, Tuple
+
+MASK64 = (1 << 64) - 1
+
+ASCON_AEAD128_IV = 0x00001000808C0001
+ASCON_HASH256_IV = 0x0000080100CC0002
+ASCON_XOF128_IV = 0x0000080000CC0003
+
+
+def ror(x: int, n: int) -> int:
+    return ((x >> n) | (x << (64 - n))) & MASK64
+
+
+def permute(s: List[int], rounds: int):
+    """ Ascon-p[rounds] permutation over five 64-bit words """
+    for i in range(12 - rounds, 12):
+        s[2] ^= ((0xF - i) << 4) | i
+
+        s[0] ^= s[4]
+        s[4] ^= s[3]
+        s[2] ^= s[1]
+        t = [(~s[j] & MASK64) & s[(j + 1) % 5] for j in range(5)]
+        for j in range(5):
+            s[j] ^= t[(j + 1) % 5]
+        s[1] ^= s[0]
+        s[0] ^= s[4]
+        s[3] ^= s[2]
+        s[2] = ~s[2] & MASK64
+
+        s[0] ^= ror(s[0], 19) ^ ror(s[0], 28)
+        s[1] ^= ror(s[1], 61) ^ ror(s[1], 39)
+        s[2] ^= ror(s[2], 1) ^ ror(s[2], 6)
+        s[3] ^= ror(s[3], 10) ^ ror(s[3], 17)
+        s[4] ^= ror(s[4], 7) ^ ror(s[4], 41)
+
+
+def load(b: bytes) -> int:
+    return int.from_bytes(b, 'little')
+
+
+def store(x: int, length: int = 8) -> bytes:
+    return x.to_bytes(8, 'little')[:length]
+
+
+def pad(data: bytes, rate: int) -> bytes:
+    return data + b'\x01' + b'\0' * (rate - 1 - len(data) % rate)
+
+
+def aead128_encrypt(key: bytes, nonce: bytes, ad: bytes, message: bytes) -> Tuple[bytes, bytes]:
+    """ Ascon-AEAD128 encryption, returns ciphertext and 16-byte tag """
+    k0, k1 = load(key[:8]), load(key[8:])
+    s = [ASCON_AEAD128_IV, k0, k1, load(nonce[:8]), load(nonce[8:])]
+    permute(s, 12)
+    s[3] ^= k0
+    s[4] ^= k1
+
+    if len(ad) != 0:
+        a = pad(ad, 16)
+        for i in range(0, len(a), 16):
+            s[0] ^= load(a[i:i + 8])
+            s[1] ^= load(a[i + 8:i + 16])
+            permute(s, 8)
+
+    s[4] ^= 1 << 63
+
+    p = pad(message, 16)
+    c = b''
+    for i in range(0, len(p), 16):
+        s[0] ^= load(p[i:i + 8])
+        s[1] ^= load(p[i + 8:i + 16])
+        c += store(s[0]) + store(s[1])
+
+        if i + 16 != len(p):
+            permute(s, 8)
+
+    s[2] ^= k0
+    s[3] ^= k1
+    permute(s, 12)
+
+    return c[:len(message)], store(s[3] ^ k0) + store(s[4] ^ k1)
+
+
+def _sponge(iv: int, message: bytes, length: int) -> bytes:
+    s = [iv, 0, 0, 0, 0]
+    permute(s, 12)
+
+    m = pad(message, 8)
+    for i in range(0, len(m), 8):
+        s[0] ^= load(m[i:i + 8])
+        permute(s, 12)
+
+    r = b''
+    while len(r) < length:
+        r += store(s[0])
+        permute(s, 12)
+
+    return r[:length]
+
+
+def hash256(message: bytes) -> bytes:
+    return _sponge(ASCON_HASH256_IV, message, 32)
+
+
+def xof128(message: bytes, length: int) -> bytes:
+    return _sponge(ASCON_XOF128_IV, message, length)